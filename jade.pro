@@ -8,7 +8,7 @@ INCLUDEPATH += source source/drawing source/widgets
 
 CONFIG += release warn_on embed_manifest_dll c++11 qt
 CONFIG -= debug
-QT += widgets printsupport svg
+QT += widgets printsupport svg concurrent
 
 !win32:MOC_DIR = release
 !win32:OBJECTS_DIR = release
@@ -22,16 +22,23 @@ HEADERS += \
 	source/drawing/DrawingItem.h \
 	source/drawing/DrawingItemFactory.h \
 	source/drawing/DrawingItemGroup.h \
+	source/drawing/DrawingItemOrder.h \
 	source/drawing/DrawingItemPoint.h \
+	source/drawing/DrawingItemPointHash.h \
+	source/drawing/DrawingJournal.h \
 	source/drawing/DrawingPathItem.h \
 	source/drawing/DrawingPixmapItem.h \
 	source/drawing/DrawingPolyItems.h \
 	source/drawing/DrawingRectItems.h \
 	source/drawing/DrawingScene.h \
+	source/drawing/DrawingSnapshot.h \
+	source/drawing/DrawingSpatialIndex.h \
+	source/drawing/DrawingStyleTable.h \
 	source/drawing/DrawingTextItem.h \
 	source/drawing/DrawingTwoPointItems.h \
 	source/drawing/DrawingTypes.h \
 	source/drawing/DrawingUndo.h \
+	source/drawing/DrawingUndoStack.h \
 	source/drawing/DrawingView.h \
 	source/drawing/Drawing \
 	\
@@ -62,16 +69,23 @@ SOURCES += \
 	source/drawing/DrawingItem.cpp \
 	source/drawing/DrawingItemFactory.cpp \
 	source/drawing/DrawingItemGroup.cpp \
+	source/drawing/DrawingItemOrder.cpp \
 	source/drawing/DrawingItemPoint.cpp \
+	source/drawing/DrawingItemPointHash.cpp \
+	source/drawing/DrawingJournal.cpp \
 	source/drawing/DrawingPathItem.cpp \
 	source/drawing/DrawingPixmapItem.cpp \
 	source/drawing/DrawingPolyItems.cpp \
 	source/drawing/DrawingRectItems.cpp \
 	source/drawing/DrawingScene.cpp \
+	source/drawing/DrawingSnapshot.cpp \
+	source/drawing/DrawingSpatialIndex.cpp \
+	source/drawing/DrawingStyleTable.cpp \
 	source/drawing/DrawingTextItem.cpp \
 	source/drawing/DrawingTwoPointItems.cpp \
 	source/drawing/DrawingTypes.cpp \
 	source/drawing/DrawingUndo.cpp \
+	source/drawing/DrawingUndoStack.cpp \
 	source/drawing/DrawingView.cpp \
 	\
 	source/widgets/ColorButton.cpp \
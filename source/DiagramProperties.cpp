@@ -234,6 +234,31 @@ void DiagramProperties::load(QSettings& settings)
 	mGridColor = settings.value("gridColor", QVariant(QColor(0, 128, 128, 255))).value<QColor>();
 }
 
+//==================================================================================================
+
+void DiagramProperties::writeBinary(QDataStream& stream) const
+{
+	stream << (quint16)mUnits << mSceneRect << mContentsRect << mBackgroundColor;
+	stream << mBorderWidth << mBorderColor;
+	stream << mGridSize << (quint32)mGridStyle << (qint32)mGridMajorSpacing << (qint32)mGridMinorSpacing << mGridColor;
+}
+
+void DiagramProperties::readBinary(QDataStream& stream)
+{
+	quint16 units = UnitsMils;
+	quint32 gridStyle = DrawingStyleOptions::GridGraphPaper;
+	qint32 gridMajorSpacing = 8, gridMinorSpacing = 2;
+
+	stream >> units >> mSceneRect >> mContentsRect >> mBackgroundColor;
+	stream >> mBorderWidth >> mBorderColor;
+	stream >> mGridSize >> gridStyle >> gridMajorSpacing >> gridMinorSpacing >> mGridColor;
+
+	mUnits = (DrawingUnits)units;
+	mGridStyle = (DrawingStyleOptions::GridStyle)gridStyle;
+	mGridMajorSpacing = gridMajorSpacing;
+	mGridMinorSpacing = gridMinorSpacing;
+}
+
 //==================================================================================================
 //==================================================================================================
 //==================================================================================================
@@ -248,6 +273,44 @@ DiagramPropertiesCommand::DiagramPropertiesCommand(DiagramView* view, const Diag
 
 DiagramPropertiesCommand::~DiagramPropertiesCommand() { }
 
+int DiagramPropertiesCommand::id() const
+{
+	return DiagramPropertiesType;
+}
+
+qint64 DiagramPropertiesCommand::memorySize() const
+{
+	return sizeof(DiagramPropertiesCommand);
+}
+
+void DiagramPropertiesCommand::writeJournalData(QDataStream& stream, bool undone) const
+{
+	Q_UNUSED(undone);
+
+	mProperties.writeBinary(stream);
+	mOriginalProperties.writeBinary(stream);
+}
+
+DiagramPropertiesCommand* DiagramPropertiesCommand::readJournalData(QDataStream& stream, bool undone,
+	DiagramView* view, QUndoCommand* parent)
+{
+	DiagramPropertiesCommand* command = nullptr;
+	DiagramProperties properties, originalProperties;
+
+	Q_UNUSED(undone);
+
+	properties.readBinary(stream);
+	originalProperties.readBinary(stream);
+
+	if (view)
+	{
+		command = new DiagramPropertiesCommand(view, properties, parent);
+		command->mOriginalProperties = originalProperties;
+	}
+
+	return command;
+}
+
 void DiagramPropertiesCommand::redo()
 {
 	mView->setDiagramProperties(mProperties);
@@ -264,26 +327,118 @@ void DiagramPropertiesCommand::undo()
 //==================================================================================================
 //==================================================================================================
 
-DiagramItemPropertiesCommand::DiagramItemPropertiesCommand(DrawingItem* item,
-	const QHash<QString,QVariant>& newProperties, QUndoCommand* parent) :
+DiagramItemPropertiesCommand::DiagramItemPropertiesCommand(const QList<DrawingItem*>& items,
+	const QHash<QString,QVariant>& newValues, QUndoCommand* parent) :
 	DrawingUndoCommand("Change Item Properties", parent)
 {
-	mItem = item;
-	mOriginalProperties = item->properties();
-	mNewProperties = newProperties;
+	QHash<QString,QVariant> originalValues;
+
+	mNewValues = newValues;
+
+	// Only remember the original value of each property that will actually change.  The new
+	// values are shared by all of the items.
+	for(auto itemIter = items.begin(); itemIter != items.end(); itemIter++)
+	{
+		originalValues.clear();
+
+		for(auto valueIter = newValues.begin(); valueIter != newValues.end(); valueIter++)
+		{
+			if ((*itemIter)->containsProperty(valueIter.key()))
+			{
+				QVariant originalValue = (*itemIter)->propertyValue(valueIter.key());
+				if (originalValue != valueIter.value()) originalValues.insert(valueIter.key(), originalValue);
+			}
+		}
+
+		if (!originalValues.isEmpty())
+		{
+			mItems.append(*itemIter);
+			mOriginalValues.append(originalValues);
+		}
+	}
+}
+
+DiagramItemPropertiesCommand::DiagramItemPropertiesCommand(const DiagramItemPropertiesCommand& command,
+	QUndoCommand* parent) : DrawingUndoCommand(command, parent)
+{
+	mItems = command.mItems;
+	mOriginalValues = command.mOriginalValues;
+	mNewValues = command.mNewValues;
 }
 
 DiagramItemPropertiesCommand::~DiagramItemPropertiesCommand() { }
 
+bool DiagramItemPropertiesCommand::isEmpty() const
+{
+	return mItems.isEmpty();
+}
+
+int DiagramItemPropertiesCommand::id() const
+{
+	return DiagramItemPropertiesType;
+}
+
+qint64 DiagramItemPropertiesCommand::memorySize() const
+{
+	qint64 size = sizeof(DiagramItemPropertiesCommand) + propertiesMemorySize(mNewValues);
+
+	size += mItems.size() * (sizeof(DrawingItem*) + sizeof(QHash<QString,QVariant>));
+	for(auto valuesIter = mOriginalValues.begin(); valuesIter != mOriginalValues.end(); valuesIter++)
+		size += propertiesMemorySize(*valuesIter);
+
+	return size;
+}
+
+void DiagramItemPropertiesCommand::writeJournalData(QDataStream& stream, bool undone) const
+{
+	Q_UNUSED(undone);
+
+	DrawingJournal::writeItemReferences(stream, mItems);
+	stream << mNewValues << mOriginalValues;
+}
+
+DiagramItemPropertiesCommand* DiagramItemPropertiesCommand::readJournalData(QDataStream& stream, bool undone,
+	DrawingJournal& journal, QUndoCommand* parent)
+{
+	DiagramItemPropertiesCommand* command;
+	QList<DrawingItem*> items = journal.readItemReferences(stream);
+	QHash<QString,QVariant> newValues;
+	QList< QHash<QString,QVariant> > originalValues;
+
+	Q_UNUSED(undone);
+
+	stream >> newValues >> originalValues;
+
+	// The original values were recorded when the command was first made, so they replace the ones
+	// found by the constructor
+	command = new DiagramItemPropertiesCommand(items, newValues, parent);
+	if (originalValues.size() == items.size())
+	{
+		command->mItems = items;
+		command->mOriginalValues = originalValues;
+	}
+	else
+	{
+		command->mItems.clear();
+		command->mOriginalValues.clear();
+		stream.setStatus(QDataStream::ReadCorruptData);
+	}
+
+	return command;
+}
+
 void DiagramItemPropertiesCommand::redo()
 {
-	mItem->setProperties(mNewProperties);
+	for(int i = 0; i < mItems.size(); i++)
+		mItems[i]->setPropertyValues(mNewValues);
+
 	DrawingUndoCommand::redo();
 }
 
 void DiagramItemPropertiesCommand::undo()
 {
 	DrawingUndoCommand::undo();
-	mItem->setProperties(mOriginalProperties);
-}
 
+	for(int i = 0; i < mItems.size(); i++)
+		mItems[i]->setPropertyValues(mOriginalValues[i]);
+}
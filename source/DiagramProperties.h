@@ -74,12 +74,19 @@ public:
 
 	void save(QSettings& settings);
 	void load(QSettings& settings);
+
+	void writeBinary(QDataStream& stream) const;
+	void readBinary(QDataStream& stream);
 };
 
 //==================================================================================================
 
 class DiagramView;
 
+// Types of the diagram's own undo commands, following on from DrawingUndoCommand::Type
+enum DiagramCommandType { DiagramPropertiesType = DrawingUndoCommand::NumberOfCommands,
+	DiagramItemPropertiesType };
+
 class DiagramPropertiesCommand : public DrawingUndoCommand
 {
 private:
@@ -90,6 +97,13 @@ public:
 	DiagramPropertiesCommand(DiagramView* view, const DiagramProperties& newProperties, QUndoCommand* parent = nullptr);
 	~DiagramPropertiesCommand();
 
+	int id() const;
+	qint64 memorySize() const;
+
+	void writeJournalData(QDataStream& stream, bool undone) const;
+	static DiagramPropertiesCommand* readJournalData(QDataStream& stream, bool undone,
+		DiagramView* view, QUndoCommand* parent = nullptr);
+
 	void redo();
 	void undo();
 };
@@ -99,15 +113,25 @@ public:
 class DiagramItemPropertiesCommand : public DrawingUndoCommand
 {
 private:
-	DrawingItem* mItem;
-	QHash<QString,QVariant> mOriginalProperties;
-	QHash<QString,QVariant> mNewProperties;
+	QList<DrawingItem*> mItems;
+	QList< QHash<QString,QVariant> > mOriginalValues;
+	QHash<QString,QVariant> mNewValues;
 
 public:
-	DiagramItemPropertiesCommand(DrawingItem* item, const QHash<QString,
-		QVariant>& newProperties, QUndoCommand* parent = nullptr);
+	DiagramItemPropertiesCommand(const QList<DrawingItem*>& items,
+		const QHash<QString,QVariant>& newValues, QUndoCommand* parent = nullptr);
+	DiagramItemPropertiesCommand(const DiagramItemPropertiesCommand& command, QUndoCommand* parent = nullptr);
 	~DiagramItemPropertiesCommand();
 
+	bool isEmpty() const;
+
+	int id() const;
+	qint64 memorySize() const;
+
+	void writeJournalData(QDataStream& stream, bool undone) const;
+	static DiagramItemPropertiesCommand* readJournalData(QDataStream& stream, bool undone,
+		DrawingJournal& journal, QUndoCommand* parent = nullptr);
+
 	void redo();
 	void undo();
 };
@@ -84,6 +84,29 @@ bool DiagramScene::multipleItemProperties(const QList<DrawingItem*>& items)
 
 //==================================================================================================
 
+QUndoCommand* DiagramScene::readUndoCommand(int type, QDataStream& stream, bool undone,
+	DrawingJournal& journal, QUndoCommand* parent)
+{
+	QUndoCommand* command = nullptr;
+
+	switch (type)
+	{
+	case DiagramPropertiesType:
+		command = DiagramPropertiesCommand::readJournalData(stream, undone, diagramView(), parent);
+		break;
+	case DiagramItemPropertiesType:
+		command = DiagramItemPropertiesCommand::readJournalData(stream, undone, journal, parent);
+		break;
+	default:
+		command = DrawingScene::readUndoCommand(type, stream, undone, journal, parent);
+		break;
+	}
+
+	return command;
+}
+
+//==================================================================================================
+
 void DiagramScene::updateProperties(const DiagramProperties& properties, QUndoCommand* command)
 {
 	DiagramPropertiesCommand* propertiesCommand = new DiagramPropertiesCommand(diagramView(), properties, command);
@@ -116,25 +139,23 @@ void DiagramScene::updateProperties(const DiagramProperties& properties, QUndoCo
 void DiagramScene::updateItemProperties(DrawingItem* item,
 	const QHash<QString,QVariant>& properties, QUndoCommand* command)
 {
-	QHash<QString, QVariant> itemProperties = item->properties();
-
-	for(auto hashIter = properties.begin(); hashIter != properties.end(); hashIter++)
-	{
-		if (itemProperties.contains(hashIter.key()))
-			itemProperties[hashIter.key()] = hashIter.value();
-	}
-
-	DiagramItemPropertiesCommand* propertiesCommand = new DiagramItemPropertiesCommand(item, itemProperties, command);
-	if (!command) pushUndo(propertiesCommand);
+	updateItemProperties(QList<DrawingItem*>() << item, properties, command);
 }
 
 void DiagramScene::updateItemProperties(const QList<DrawingItem*> items,
 	const QHash<QString,QVariant>& properties, QUndoCommand* command)
 {
-	QUndoCommand* propertiesCommand = new QUndoCommand("Change Item Properties", command);
-
-	for(auto itemIter = items.begin(); itemIter != items.end(); itemIter++)
-		updateItemProperties(*itemIter, properties, propertiesCommand);
+	DiagramItemPropertiesCommand* propertiesCommand = new DiagramItemPropertiesCommand(items, properties);
 
-	if (!command) pushUndo(propertiesCommand);
+	// Only attach the command to the parent command if it actually changes something
+	if (!propertiesCommand->isEmpty())
+	{
+		if (command)
+		{
+			new DiagramItemPropertiesCommand(*propertiesCommand, command);
+			delete propertiesCommand;
+		}
+		else pushUndo(propertiesCommand);
+	}
+	else delete propertiesCommand;
 }
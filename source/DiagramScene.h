@@ -43,6 +43,10 @@ public:
 	bool singleItemProperties(DrawingItem* item);
 	bool multipleItemProperties(const QList<DrawingItem*>& items);
 
+protected:
+	QUndoCommand* readUndoCommand(int type, QDataStream& stream, bool undone,
+		DrawingJournal& journal, QUndoCommand* parent);
+
 private:
 	void updateProperties(const DiagramProperties& properties, QUndoCommand* command = nullptr);
 
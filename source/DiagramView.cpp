@@ -21,6 +21,7 @@
 #include "DiagramView.h"
 #include "DiagramScene.h"
 #include "DiagramPropertiesWidget.h"
+#include <QtConcurrent>
 #include <QtPrintSupport>
 #include <QtSvg>
 
@@ -43,10 +44,26 @@ DiagramView::DiagramView() : DrawingView()
 	addActions();
 	createContextMenus();
 
+	mSaveSnapshot = nullptr;
+	mSaveSucceeded = true;
+	mSaveProgressTimer.setInterval(100);
+
+	mScene->setJournal(&mJournal);
+
 	connect(this, SIGNAL(propertiesChanged()), this, SLOT(updatePrinter()));
+	connect(&mSaveWatcher, SIGNAL(finished()), this, SLOT(finishSave()));
+	connect(&mSaveProgressTimer, SIGNAL(timeout()), this, SLOT(updateSaveProgress()));
 }
 
-DiagramView::~DiagramView() { }
+DiagramView::~DiagramView()
+{
+	// The snapshot must not be deleted while it is still being written
+	if (mSaveSnapshot)
+	{
+		mSaveWatcher.waitForFinished();
+		delete mSaveSnapshot;
+	}
+}
 
 //==================================================================================================
 
@@ -151,12 +168,37 @@ void DiagramView::zoomOut()
 
 //==================================================================================================
 
-bool DiagramView::save(const QString& filePath)
+static const char kBinaryMagic[4] = { 'J', 'A', 'D', 'B' };
+static const quint32 kBinaryVersion = 1;
+
+static void setupBinaryStream(QDataStream& stream)
 {
-	QFile dataFile(filePath);
+	stream.setVersion(QDataStream::Qt_5_0);
+	stream.setByteOrder(QDataStream::LittleEndian);
+	stream.setFloatingPointPrecision(QDataStream::DoublePrecision);
+}
+
+//==================================================================================================
+
+static bool writeDiagram(DrawingSnapshot* snapshot, const QString& filePath, DiagramView::FileFormat format)
+{
+	// The diagram is written to a temporary file that only replaces the original once it is
+	// complete, so a failed save leaves the original file as it was
+	QSaveFile dataFile(filePath);
 
 	bool fileError = !dataFile.open(QIODevice::WriteOnly);
-	if (!fileError)
+	if (!fileError && format == DiagramView::BinaryFormat)
+	{
+		QDataStream stream(&dataFile);
+		setupBinaryStream(stream);
+
+		stream.writeRawData(kBinaryMagic, sizeof(kBinaryMagic));
+		stream << kBinaryVersion;
+		snapshot->writeBinary(stream);
+
+		fileError = (stream.status() != QDataStream::Ok);
+	}
+	else if (!fileError)
 	{
 		QXmlStreamWriter xmlWriter(&dataFile);
 		xmlWriter.setAutoFormatting(true);
@@ -165,26 +207,100 @@ bool DiagramView::save(const QString& filePath)
 		xmlWriter.writeStartDocument();
 
 		xmlWriter.writeStartElement("diagram");
-		writeXmlAttributes(xmlWriter);
-		writeXmlChildElements(xmlWriter);
+		snapshot->writeXmlAttributes(xmlWriter);
+		snapshot->writeXmlChildElements(xmlWriter);
 		xmlWriter.writeEndElement();
 
 		xmlWriter.writeEndDocument();
-		dataFile.close();
 
-		setClean();
-		update();
+		fileError = xmlWriter.hasError();
 	}
 
+	if (!fileError) fileError = !dataFile.commit();
+	else dataFile.cancelWriting();
+
 	return (!fileError);
 }
 
+bool DiagramView::save(const QString& filePath, FileFormat format)
+{
+	saveInBackground(filePath, format);
+	return waitForSave();
+}
+
+void DiagramView::saveInBackground(const QString& filePath, FileFormat format)
+{
+	// Only one save runs at a time
+	waitForSave();
+
+	mSaveSnapshot = new DrawingSnapshot(this);
+	mSaveFilePath = filePath;
+	mScene->setSavePoint();
+	mJournal.setSavePoint();
+
+	mSaveWatcher.setFuture(QtConcurrent::run(writeDiagram, mSaveSnapshot, filePath, format));
+	mSaveProgressTimer.start();
+
+	emit saveProgressChanged(0);
+}
+
+bool DiagramView::waitForSave()
+{
+	if (mSaveSnapshot)
+	{
+		mSaveWatcher.waitForFinished();
+		finishSave();
+	}
+
+	return mSaveSucceeded;
+}
+
+bool DiagramView::isSaving() const
+{
+	return (mSaveSnapshot != nullptr);
+}
+
+bool DiagramView::canRecover(const QString& filePath) const
+{
+	return DrawingJournal::canReplay(filePath);
+}
+
 bool DiagramView::load(const QString& filePath)
 {
 	QFile dataFile(filePath);
 
 	bool fileError = !dataFile.open(QIODevice::ReadOnly);
-	if (!fileError)
+	if (!fileError && dataFile.peek(sizeof(kBinaryMagic)) == QByteArray(kBinaryMagic, sizeof(kBinaryMagic)))
+	{
+		// Binary diagrams are read straight from a mapping of the file rather than through the
+		// buffered QFile reads
+		uchar* fileData = dataFile.map(0, dataFile.size());
+		QByteArray data = (fileData) ? QByteArray::fromRawData((const char*)fileData, dataFile.size()) :
+			dataFile.readAll();
+		QDataStream stream(data);
+		quint32 version = 0;
+
+		setupBinaryStream(stream);
+
+		clear();
+
+		stream.skipRawData(sizeof(kBinaryMagic));
+		stream >> version;
+
+		if (version == kBinaryVersion)
+		{
+			readBinary(stream);
+			fileError = (stream.status() != QDataStream::Ok);
+		}
+		else fileError = true;
+
+		if (fileData) dataFile.unmap(fileData);
+		dataFile.close();
+
+		setClean();
+		update();
+	}
+	else if (!fileError)
 	{
 		QXmlStreamReader xmlReader(&dataFile);
 
@@ -209,8 +325,32 @@ bool DiagramView::load(const QString& filePath)
 	return (!fileError);
 }
 
+bool DiagramView::recover(const QString& filePath)
+{
+	// The changes are replayed straight onto the scene rather than through the undo stack, so the
+	// recovered diagram starts out modified with nothing to undo
+	bool recovered = mJournal.replay(filePath, mScene);
+	if (!mJournal.isOpen()) mJournal.open(filePath);
+
+	mScene->resetClean();
+	update();
+
+	emit numberOfItemsChanged(mScene->numberOfItems());
+
+	return recovered;
+}
+
+void DiagramView::startJournal(const QString& filePath)
+{
+	mJournal.open(filePath);
+}
+
 void DiagramView::clear()
 {
+	// The diagram is being closed or replaced, so its unsaved changes are no longer wanted
+	waitForSave();
+	mJournal.close(true);
+
 	setDefaultMode();
 	mScene->clearItems();
 }
@@ -383,6 +523,42 @@ void DiagramView::updatePrinter()
 	}
 }
 
+void DiagramView::updateSaveProgress()
+{
+	if (mSaveSnapshot && mSaveSnapshot->numberOfItems() > 0)
+		emit saveProgressChanged(100 * mSaveSnapshot->numberOfItemsWritten() / mSaveSnapshot->numberOfItems());
+}
+
+void DiagramView::finishSave()
+{
+	// Also called directly by waitForSave, in which case the watcher's signal arrives afterwards
+	if (mSaveSnapshot && mSaveWatcher.isFinished())
+	{
+		mSaveProgressTimer.stop();
+
+		mSaveSucceeded = mSaveWatcher.result();
+		delete mSaveSnapshot;
+		mSaveSnapshot = nullptr;
+
+		// The state that was saved becomes the clean state, even if the diagram has been edited
+		// since the save started, and the journal only needs to keep the edits made since then
+		if (mSaveSucceeded)
+		{
+			mScene->commitSavePoint();
+			mJournal.commitSavePoint(mSaveFilePath);
+		}
+		else
+		{
+			mScene->discardSavePoint();
+			mJournal.discardSavePoint();
+		}
+		update();
+
+		emit saveProgressChanged(100);
+		emit saveFinished(mSaveFilePath, mSaveSucceeded);
+	}
+}
+
 //==================================================================================================
 
 void DiagramView::contextMenuEvent(QContextMenuEvent* event)
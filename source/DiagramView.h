@@ -39,6 +39,8 @@ public:
 		InsertPointAction, RemovePointAction, ZoomInAction, ZoomOutAction, ZoomFitAction,
 		PropertiesAction, NumberOfActions };
 
+	enum FileFormat { XmlFormat, BinaryFormat };
+
 public:
 	const static QVector<qreal> kZoomLevels;
 
@@ -52,6 +54,14 @@ private:
 
 	QPrinter* mPrinter;
 
+	DrawingSnapshot* mSaveSnapshot;
+	QFutureWatcher<bool> mSaveWatcher;
+	QTimer mSaveProgressTimer;
+	QString mSaveFilePath;
+	bool mSaveSucceeded;
+
+	DrawingJournal mJournal;
+
 	QMenu mSingleItemContextMenu;
 	QMenu mSinglePolyItemContextMenu;
 	QMenu mMultipleItemContextMenu;
@@ -72,12 +82,20 @@ public:
 	DrawingStyleOptions::ColorMode exportMode() const;
 	DrawingStyleOptions::RenderFlags exportFlags() const;
 
+	bool isSaving() const;
+
+	bool canRecover(const QString& filePath) const;
+
 public slots:
 	void zoomIn();
 	void zoomOut();
 
-	bool save(const QString& filePath);
+	bool save(const QString& filePath, FileFormat format = XmlFormat);
+	void saveInBackground(const QString& filePath, FileFormat format = XmlFormat);
+	bool waitForSave();
 	bool load(const QString& filePath);
+	bool recover(const QString& filePath);
+	void startJournal(const QString& filePath);
 	void clear();
 
 	bool properties();
@@ -91,9 +109,13 @@ public slots:
 
 signals:
 	void propertiesChanged();
+	void saveProgressChanged(int percent);
+	void saveFinished(const QString& filePath, bool saved);
 
 private slots:
 	void updatePrinter();
+	void updateSaveProgress();
+	void finishSave();
 
 private:
 	void contextMenuEvent(QContextMenuEvent* event);
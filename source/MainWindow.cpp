@@ -39,8 +39,9 @@ MainWindow::MainWindow(const QString& filePath) : QMainWindow()
 	setCentralWidget(mStackedWidget);
 
 	mBaseWindowTitle = "Jade";
-	mFileFilter = "Jade Diagrams (*.jdm);;All Files (*)";
+	mFileFilter = "Jade Diagrams (*.jdm);;Jade Binary Diagrams (*.jade);;All Files (*)";
 	mFileSuffix = "jdm";
+	mBinaryFileSuffix = "jade";
 	mPromptCloseUnsaved = true;
 	mPromptOverwrite = true;
 
@@ -66,6 +67,7 @@ MainWindow::MainWindow(const QString& filePath) : QMainWindow()
 
 	if (!filePath.isEmpty() && mDiagramView->load(filePath))
 	{
+		recoverDiagram(filePath);
 		setFilePath(filePath);
 		setDiagramVisible(true);
 	}
@@ -100,6 +102,35 @@ bool MainWindow::isDiagramVisible() const
 	return (mStackedWidget->currentIndex() == 1);
 }
 
+bool MainWindow::isBinaryFile(const QString& filePath) const
+{
+	return filePath.endsWith("." + mBinaryFileSuffix, Qt::CaseInsensitive);
+}
+
+void MainWindow::recoverDiagram(const QString& filePath)
+{
+	QFileInfo fileInfo(filePath);
+	QMessageBox::StandardButton button = QMessageBox::No;
+
+	// A journal left next to the file means that the last session ended without saving its changes
+	if (mDiagramView->canRecover(filePath))
+	{
+		button = QMessageBox::question(this, "Recover Changes",
+			"Unsaved changes to " + fileInfo.fileName() + " were found from a previous session.  Recover them?",
+			QMessageBox::Yes|QMessageBox::No, QMessageBox::Yes);
+	}
+
+	if (button == QMessageBox::Yes)
+	{
+		if (!mDiagramView->recover(filePath))
+		{
+			QMessageBox::warning(this, "Recover Changes",
+				"Some of the changes to " + fileInfo.fileName() + " could not be recovered.");
+		}
+	}
+	else mDiagramView->startJournal(filePath);
+}
+
 //==================================================================================================
 
 bool MainWindow::newDiagram()
@@ -137,6 +168,7 @@ bool MainWindow::openDiagram()
 			drawingOpened = mDiagramView->load(filePath);
 			if (drawingOpened)
 			{
+				recoverDiagram(filePath);
 				setFilePath(filePath);
 				setDiagramVisible(true);
 				mDiagramView->zoomFit();
@@ -162,14 +194,15 @@ bool MainWindow::saveDiagram()
 
 	if (mDiagramView && isDiagramVisible())
 	{
+		// A save still in progress may yet fail and change the diagram's file path
+		mDiagramView->waitForSave();
+
 		if (!mFilePath.startsWith("Untitled"))
 		{
-			drawingSaved = mDiagramView->save(mFilePath);
-			if (!drawingSaved)
-			{
-				QMessageBox::critical(this, "Error Saving File",
-					"Unable to open " + mFilePath + "for saving.  File not saved!");
-			}
+			// Any error is reported by updateSaveFinished once the save has completed
+			mDiagramView->saveInBackground(mFilePath,
+				isBinaryFile(mFilePath) ? DiagramView::BinaryFormat : DiagramView::XmlFormat);
+			drawingSaved = true;
 		}
 
 		else drawingSaved = saveDiagramAs();
@@ -184,20 +217,32 @@ bool MainWindow::saveDiagramAs()
 
 	if (mDiagramView && isDiagramVisible())
 	{
+		mDiagramView->waitForSave();
+
 		QString filePath = (mFilePath.startsWith("Untitled")) ? mWorkingDir.path() : mFilePath;
 		QFileDialog::Options options = (mPromptOverwrite) ? 0 : QFileDialog::DontConfirmOverwrite;
+		QString selectedFilter;
 
-		filePath = QFileDialog::getSaveFileName(this, "Save File", filePath, mFileFilter, nullptr, options);
+		filePath = QFileDialog::getSaveFileName(this, "Save File", filePath, mFileFilter, &selectedFilter, options);
 		if (!filePath.isEmpty())
 		{
 			QFileInfo fileInfo(filePath);
 			mWorkingDir = fileInfo.dir();
 
-			if (!filePath.endsWith("." + mFileSuffix, Qt::CaseInsensitive))
-				filePath += "." + mFileSuffix;
+			if (!filePath.endsWith("." + mFileSuffix, Qt::CaseInsensitive) &&
+				!filePath.endsWith("." + mBinaryFileSuffix, Qt::CaseInsensitive))
+			{
+				if (selectedFilter.contains("*." + mBinaryFileSuffix)) filePath += "." + mBinaryFileSuffix;
+				else filePath += "." + mFileSuffix;
+			}
 
-			drawingSaved = mDiagramView->save(filePath);
-			if (drawingSaved) setFilePath(filePath);
+			mDiagramView->saveInBackground(filePath,
+				isBinaryFile(filePath) ? DiagramView::BinaryFormat : DiagramView::XmlFormat);
+
+			// The diagram goes back to its previous file if the save fails
+			mPreviousFilePath = mFilePath;
+			setFilePath(filePath);
+			drawingSaved = true;
 		}
 	}
 
@@ -212,6 +257,9 @@ bool MainWindow::closeDiagram()
 	{
 		QMessageBox::StandardButton button = QMessageBox::Yes;
 
+		// A save still in progress decides whether there are unsaved changes
+		mDiagramView->waitForSave();
+
 		if (mPromptCloseUnsaved && !mDiagramView->isClean())
 		{
 			QFileInfo fileInfo(mFilePath);
@@ -227,6 +275,8 @@ bool MainWindow::closeDiagram()
 					if (!saveDiagramAs()) button = QMessageBox::Cancel;
 				}
 				else saveDiagram();
+
+				if (!mDiagramView->waitForSave()) button = QMessageBox::Cancel;
 			}
 		}
 
@@ -528,6 +578,26 @@ void MainWindow::updateNumberOfItems(int itemCount)
 	mNumberOfItemsLabel->setText(QString::number(itemCount));
 }
 
+void MainWindow::updateSaveProgress(int percent)
+{
+	if (percent < 100) mStatusLabel->setText("Saving " + QString::number(percent) + "%");
+}
+
+void MainWindow::updateSaveFinished(const QString& filePath, bool saved)
+{
+	updateClean(mDiagramView->isClean());
+
+	if (!saved)
+	{
+		if (!mPreviousFilePath.isEmpty()) setFilePath(mPreviousFilePath);
+
+		QMessageBox::critical(this, "Error Saving File",
+			"Unable to open " + filePath + " for saving.  File not saved!");
+	}
+
+	mPreviousFilePath.clear();
+}
+
 //==================================================================================================
 
 void MainWindow::showEvent(QShowEvent* event)
@@ -829,6 +899,8 @@ void MainWindow::createStatusBar()
 	connect(mDiagramView, SIGNAL(modeChanged(DrawingView::Mode)), this, SLOT(updateMode(DrawingView::Mode)));
 	connect(mDiagramView, SIGNAL(cleanChanged(bool)), this, SLOT(updateClean(bool)));
 	connect(mDiagramView, SIGNAL(numberOfItemsChanged(int)), this, SLOT(updateNumberOfItems(int)));
+	connect(mDiagramView, SIGNAL(saveProgressChanged(int)), this, SLOT(updateSaveProgress(int)));
+	connect(mDiagramView, SIGNAL(saveFinished(const QString&, bool)), this, SLOT(updateSaveFinished(const QString&, bool)));
 	connect(mDiagramView, SIGNAL(mousePositionChanged(const QString&)), mMouseLabel, SLOT(setText(const QString&)));
 }
 
@@ -60,8 +60,10 @@ private:
 	DiagramProperties mDefaultProperties;
 
 	QString mFilePath;
+	QString mPreviousFilePath;
 	QString mFileFilter;
 	QString mFileSuffix;
+	QString mBinaryFileSuffix;
 
 	QString mBaseWindowTitle;
 
@@ -82,6 +84,8 @@ public:
 	void setDiagramVisible(bool visible);
 	bool isDiagramVisible() const;
 
+	bool isBinaryFile(const QString& filePath) const;
+
 public slots:
 	bool newDiagram();
 	bool openDiagram();
@@ -113,12 +117,16 @@ private slots:
 	void updateMode(DrawingView::Mode mode);
 	void updateClean(bool clean);
 	void updateNumberOfItems(int itemCount);
+	void updateSaveProgress(int percent);
+	void updateSaveFinished(const QString& filePath, bool saved);
 
 private:
 	void showEvent(QShowEvent* event);
 	void hideEvent(QHideEvent* event);
 	void closeEvent(QCloseEvent* event);
 
+	void recoverDiagram(const QString& filePath);
+
 	void registerItems();
 	bool addLibrary(const QString& libraryPath);
 	DrawingPathItem* readPathItem(QXmlStreamReader& xmlReader, QString& iconPath);
@@ -23,15 +23,15 @@
 
 DrawingChartRectItem::DrawingChartRectItem() : DrawingRectItem()
 {
-	addProperty("Font Family", "Arial");
-	addProperty("Font Size", 100.0);
-	addProperty("Font Bold", false);
-	addProperty("Font Italic", false);
-	addProperty("Font Underline", false);
-	addProperty("Font Overline", false);
-	addProperty("Font Strike-Out", false);
-	addProperty("Text Color", QColor(255, 0, 255));
-	addProperty("Caption", "Label");
+	addProperty(FontFamilyProperty, "Arial");
+	addProperty(FontSizeProperty, 100.0);
+	addProperty(FontBoldProperty, false);
+	addProperty(FontItalicProperty, false);
+	addProperty(FontUnderlineProperty, false);
+	addProperty(FontOverlineProperty, false);
+	addProperty(FontStrikeOutProperty, false);
+	addProperty(TextColorProperty, QColor(255, 0, 255));
+	addProperty(CaptionProperty, "Label");
 
 	setFlags(CanMove | CanRotate | CanFlip | CanResize | MatchUnitsWithParent);
 	setPlaceType(PlaceMouseUp);
@@ -77,37 +77,37 @@ void DrawingChartRectItem::setFont(const QFont& font)
 
 void DrawingChartRectItem::setFontFamily(const QString& family)
 {
-	setPropertyValue("Font Family", family);
+	setPropertyValue(FontFamilyProperty, family);
 }
 
 void DrawingChartRectItem::setFontSize(qreal size)
 {
-	setPropertyValue("Font Size", size);
+	setPropertyValue(FontSizeProperty, size);
 }
 
 void DrawingChartRectItem::setFontBold(bool bold)
 {
-	setPropertyValue("Font Bold", bold);
+	setPropertyValue(FontBoldProperty, bold);
 }
 
 void DrawingChartRectItem::setFontItalic(bool italic)
 {
-	setPropertyValue("Font Italic", italic);
+	setPropertyValue(FontItalicProperty, italic);
 }
 
 void DrawingChartRectItem::setFontUnderline(bool underline)
 {
-	setPropertyValue("Font Underline", underline);
+	setPropertyValue(FontUnderlineProperty, underline);
 }
 
 void DrawingChartRectItem::setFontOverline(bool overline)
 {
-	setPropertyValue("Font Overline", overline);
+	setPropertyValue(FontOverlineProperty, overline);
 }
 
 void DrawingChartRectItem::setFontStrikeOut(bool strikeOut)
 {
-	setPropertyValue("Font Strike-Out", strikeOut);
+	setPropertyValue(FontStrikeOutProperty, strikeOut);
 }
 
 QFont DrawingChartRectItem::font() const
@@ -127,61 +127,61 @@ QFont DrawingChartRectItem::font() const
 
 QString DrawingChartRectItem::fontFamily() const
 {
-	return propertyValue("Font Family").toString();
+	return propertyValue(FontFamilyProperty).toString();
 }
 
 qreal DrawingChartRectItem::fontSize() const
 {
-	return propertyValue("Font Size").toDouble();
+	return propertyValue(FontSizeProperty).toDouble();
 }
 
 bool DrawingChartRectItem::isFontBold() const
 {
-	return propertyValue("Font Bold").toBool();
+	return propertyValue(FontBoldProperty).toBool();
 }
 
 bool DrawingChartRectItem::isFontItalic() const
 {
-	return propertyValue("Font Italic").toBool();
+	return propertyValue(FontItalicProperty).toBool();
 }
 
 bool DrawingChartRectItem::isFontUnderline() const
 {
-	return propertyValue("Font Underline").toBool();
+	return propertyValue(FontUnderlineProperty).toBool();
 }
 
 bool DrawingChartRectItem::isFontOverline() const
 {
-	return propertyValue("Font Overline").toBool();
+	return propertyValue(FontOverlineProperty).toBool();
 }
 
 bool DrawingChartRectItem::isFontStrikeOut() const
 {
-	return propertyValue("Font Strike-Out").toBool();
+	return propertyValue(FontStrikeOutProperty).toBool();
 }
 
 //==================================================================================================
 
 void DrawingChartRectItem::setTextColor(const QColor& color)
 {
-	setPropertyValue("Text Color", color);
+	setPropertyValue(TextColorProperty, color);
 }
 
 QColor DrawingChartRectItem::textColor() const
 {
-	return propertyValue("Text Color").value<QColor>();
+	return propertyValue(TextColorProperty).value<QColor>();
 }
 
 //==================================================================================================
 
 void DrawingChartRectItem::setCaption(const QString& caption)
 {
-	setPropertyValue("Caption", QVariant(caption));
+	setPropertyValue(CaptionProperty, QVariant(caption));
 }
 
 QString DrawingChartRectItem::caption() const
 {
-	return propertyValue("Caption").toString();
+	return propertyValue(CaptionProperty).toString();
 }
 
 //==================================================================================================
@@ -208,6 +208,26 @@ QPainterPath DrawingChartRectItem::shape() const
 	return shape;
 }
 
+bool DrawingChartRectItem::shapeContains(const QPointF& itemPos) const
+{
+	bool contains = DrawingRectItem::shapeContains(itemPos);
+
+	if (!contains && brush().color().alpha() == 0)
+		contains = mBoundingRect.contains(itemPos);
+
+	return contains;
+}
+
+bool DrawingChartRectItem::shapeIntersects(const QRectF& itemRect) const
+{
+	bool intersects = DrawingRectItem::shapeIntersects(itemRect);
+
+	if (!intersects && brush().color().alpha() == 0)
+		intersects = mBoundingRect.intersects(itemRect.normalized());
+
+	return intersects;
+}
+
 bool DrawingChartRectItem::isSuperfluous() const
 {
 	return (DrawingRectItem::isSuperfluous() && caption() == "");
@@ -295,14 +315,6 @@ void DrawingChartRectItem::writeXmlAttributes(QXmlStreamWriter& xmlWriter, const
 {
 	DrawingRectItem::writeXmlAttributes(xmlWriter, items);
 
-	xmlWriter.writeAttribute("fontFamily", fontFamily());
-	xmlWriter.writeAttribute("fontSize", QString::number(fontSize()));
-	xmlWriter.writeAttribute("fontBold", isFontBold() ? "true" : "false");
-	xmlWriter.writeAttribute("fontItalic", isFontItalic() ? "true" : "false");
-	xmlWriter.writeAttribute("fontUnderline", isFontUnderline() ? "true" : "false");
-	xmlWriter.writeAttribute("fontOverline", isFontOverline() ? "true" : "false");
-	xmlWriter.writeAttribute("fontStrikeOut", isFontStrikeOut() ? "true" : "false");
-	xmlWriter.writeAttribute("textColor", Drawing::colorToString(textColor()));
 	xmlWriter.writeAttribute("caption", caption());
 }
 
@@ -312,24 +324,6 @@ void DrawingChartRectItem::readXmlAttributes(QXmlStreamReader& xmlReader, const
 
 	DrawingRectItem::readXmlAttributes(xmlReader, items);
 
-	if (attributes.hasAttribute("fontFamily"))
-		setFontFamily(attributes.value("fontFamily").toString());
-	if (attributes.hasAttribute("fontSize"))
-		setFontSize(attributes.value("fontSize").toString().toDouble());
-	if (attributes.hasAttribute("fontBold"))
-		setFontBold(attributes.value("fontBold").toString().toLower() == "true");
-	if (attributes.hasAttribute("fontItalic"))
-		setFontItalic(attributes.value("fontItalic").toString().toLower() == "true");
-	if (attributes.hasAttribute("fontUnderline"))
-		setFontUnderline(attributes.value("fontUnderline").toString().toLower() == "true");
-	if (attributes.hasAttribute("fontOverline"))
-		setFontOverline(attributes.value("fontOverline").toString().toLower() == "true");
-	if (attributes.hasAttribute("fontStrikeOut"))
-		setFontStrikeOut(attributes.value("fontStrikeOut").toString().toLower() == "true");
-
-	if (attributes.hasAttribute("textColor"))
-		setTextColor(Drawing::colorFromString(attributes.value("textColor").toString()));
-
 	if (attributes.hasAttribute("caption"))
 		setCaption(attributes.value("caption").toString());
 }
@@ -345,10 +339,17 @@ void DrawingChartRectItem::updateLabel(const QFont& font, QPaintDevice* device)
 	mTextRect = QRectF(QPointF(-textSizeF.width() / 2, -textSizeF.height() / 2), textSizeF);
 
 	// Update mBoundingRect
-	mBoundingRect = Drawing::rotateRect(QRectF(
+	QRectF labelRect = Drawing::rotateRect(QRectF(
 		QPointF(mTextRect.left() * scaleFactor, mTextRect.top() * scaleFactor),
 		QPointF(mTextRect.right() * scaleFactor, mTextRect.bottom() * scaleFactor)),
 		rotationAngle()).translated(DrawingRectItem::boundingRect().center());
+
+	// Only report a geometry change if the label's size actually changed
+	if (labelRect != mBoundingRect)
+	{
+		mBoundingRect = labelRect;
+		invalidateGeometry();
+	}
 }
 
 qreal DrawingChartRectItem::orientedTextAngle() const
@@ -370,15 +371,15 @@ qreal DrawingChartRectItem::orientedTextAngle() const
 
 DrawingChartEllipseItem::DrawingChartEllipseItem() : DrawingEllipseItem()
 {
-	addProperty("Font Family", "Arial");
-	addProperty("Font Size", 100.0);
-	addProperty("Font Bold", false);
-	addProperty("Font Italic", false);
-	addProperty("Font Underline", false);
-	addProperty("Font Overline", false);
-	addProperty("Font Strike-Out", false);
-	addProperty("Text Color", QColor(255, 0, 255));
-	addProperty("Caption", "Label");
+	addProperty(FontFamilyProperty, "Arial");
+	addProperty(FontSizeProperty, 100.0);
+	addProperty(FontBoldProperty, false);
+	addProperty(FontItalicProperty, false);
+	addProperty(FontUnderlineProperty, false);
+	addProperty(FontOverlineProperty, false);
+	addProperty(FontStrikeOutProperty, false);
+	addProperty(TextColorProperty, QColor(255, 0, 255));
+	addProperty(CaptionProperty, "Label");
 
 	setFlags(CanMove | CanRotate | CanFlip | CanResize | MatchUnitsWithParent);
 	setPlaceType(PlaceMouseUp);
@@ -429,37 +430,37 @@ void DrawingChartEllipseItem::setFont(const QFont& font)
 
 void DrawingChartEllipseItem::setFontFamily(const QString& family)
 {
-	setPropertyValue("Font Family", family);
+	setPropertyValue(FontFamilyProperty, family);
 }
 
 void DrawingChartEllipseItem::setFontSize(qreal size)
 {
-	setPropertyValue("Font Size", size);
+	setPropertyValue(FontSizeProperty, size);
 }
 
 void DrawingChartEllipseItem::setFontBold(bool bold)
 {
-	setPropertyValue("Font Bold", bold);
+	setPropertyValue(FontBoldProperty, bold);
 }
 
 void DrawingChartEllipseItem::setFontItalic(bool italic)
 {
-	setPropertyValue("Font Italic", italic);
+	setPropertyValue(FontItalicProperty, italic);
 }
 
 void DrawingChartEllipseItem::setFontUnderline(bool underline)
 {
-	setPropertyValue("Font Underline", underline);
+	setPropertyValue(FontUnderlineProperty, underline);
 }
 
 void DrawingChartEllipseItem::setFontOverline(bool overline)
 {
-	setPropertyValue("Font Overline", overline);
+	setPropertyValue(FontOverlineProperty, overline);
 }
 
 void DrawingChartEllipseItem::setFontStrikeOut(bool strikeOut)
 {
-	setPropertyValue("Font Strike-Out", strikeOut);
+	setPropertyValue(FontStrikeOutProperty, strikeOut);
 }
 
 QFont DrawingChartEllipseItem::font() const
@@ -479,61 +480,61 @@ QFont DrawingChartEllipseItem::font() const
 
 QString DrawingChartEllipseItem::fontFamily() const
 {
-	return propertyValue("Font Family").toString();
+	return propertyValue(FontFamilyProperty).toString();
 }
 
 qreal DrawingChartEllipseItem::fontSize() const
 {
-	return propertyValue("Font Size").toDouble();
+	return propertyValue(FontSizeProperty).toDouble();
 }
 
 bool DrawingChartEllipseItem::isFontBold() const
 {
-	return propertyValue("Font Bold").toBool();
+	return propertyValue(FontBoldProperty).toBool();
 }
 
 bool DrawingChartEllipseItem::isFontItalic() const
 {
-	return propertyValue("Font Italic").toBool();
+	return propertyValue(FontItalicProperty).toBool();
 }
 
 bool DrawingChartEllipseItem::isFontUnderline() const
 {
-	return propertyValue("Font Underline").toBool();
+	return propertyValue(FontUnderlineProperty).toBool();
 }
 
 bool DrawingChartEllipseItem::isFontOverline() const
 {
-	return propertyValue("Font Overline").toBool();
+	return propertyValue(FontOverlineProperty).toBool();
 }
 
 bool DrawingChartEllipseItem::isFontStrikeOut() const
 {
-	return propertyValue("Font Strike-Out").toBool();
+	return propertyValue(FontStrikeOutProperty).toBool();
 }
 
 //==================================================================================================
 
 void DrawingChartEllipseItem::setTextColor(const QColor& color)
 {
-	setPropertyValue("Text Color", color);
+	setPropertyValue(TextColorProperty, color);
 }
 
 QColor DrawingChartEllipseItem::textColor() const
 {
-	return propertyValue("Text Color").value<QColor>();
+	return propertyValue(TextColorProperty).value<QColor>();
 }
 
 //==================================================================================================
 
 void DrawingChartEllipseItem::setCaption(const QString& caption)
 {
-	setPropertyValue("Caption", QVariant(caption));
+	setPropertyValue(CaptionProperty, QVariant(caption));
 }
 
 QString DrawingChartEllipseItem::caption() const
 {
-	return propertyValue("Caption").toString();
+	return propertyValue(CaptionProperty).toString();
 }
 
 //==================================================================================================
@@ -560,6 +561,26 @@ QPainterPath DrawingChartEllipseItem::shape() const
 	return shape;
 }
 
+bool DrawingChartEllipseItem::shapeContains(const QPointF& itemPos) const
+{
+	bool contains = DrawingEllipseItem::shapeContains(itemPos);
+
+	if (!contains && brush().color().alpha() == 0)
+		contains = mBoundingRect.contains(itemPos);
+
+	return contains;
+}
+
+bool DrawingChartEllipseItem::shapeIntersects(const QRectF& itemRect) const
+{
+	bool intersects = DrawingEllipseItem::shapeIntersects(itemRect);
+
+	if (!intersects && brush().color().alpha() == 0)
+		intersects = mBoundingRect.intersects(itemRect.normalized());
+
+	return intersects;
+}
+
 bool DrawingChartEllipseItem::isSuperfluous() const
 {
 	return (DrawingEllipseItem::isSuperfluous() && caption() == "");
@@ -647,14 +668,6 @@ void DrawingChartEllipseItem::writeXmlAttributes(QXmlStreamWriter& xmlWriter, co
 {
 	DrawingEllipseItem::writeXmlAttributes(xmlWriter, items);
 
-	xmlWriter.writeAttribute("fontFamily", fontFamily());
-	xmlWriter.writeAttribute("fontSize", QString::number(fontSize()));
-	xmlWriter.writeAttribute("fontBold", isFontBold() ? "true" : "false");
-	xmlWriter.writeAttribute("fontItalic", isFontItalic() ? "true" : "false");
-	xmlWriter.writeAttribute("fontUnderline", isFontUnderline() ? "true" : "false");
-	xmlWriter.writeAttribute("fontOverline", isFontOverline() ? "true" : "false");
-	xmlWriter.writeAttribute("fontStrikeOut", isFontStrikeOut() ? "true" : "false");
-	xmlWriter.writeAttribute("textColor", Drawing::colorToString(textColor()));
 	xmlWriter.writeAttribute("caption", caption());
 }
 
@@ -664,24 +677,6 @@ void DrawingChartEllipseItem::readXmlAttributes(QXmlStreamReader& xmlReader, con
 
 	DrawingEllipseItem::readXmlAttributes(xmlReader, items);
 
-	if (attributes.hasAttribute("fontFamily"))
-		setFontFamily(attributes.value("fontFamily").toString());
-	if (attributes.hasAttribute("fontSize"))
-		setFontSize(attributes.value("fontSize").toString().toDouble());
-	if (attributes.hasAttribute("fontBold"))
-		setFontBold(attributes.value("fontBold").toString().toLower() == "true");
-	if (attributes.hasAttribute("fontItalic"))
-		setFontItalic(attributes.value("fontItalic").toString().toLower() == "true");
-	if (attributes.hasAttribute("fontUnderline"))
-		setFontUnderline(attributes.value("fontUnderline").toString().toLower() == "true");
-	if (attributes.hasAttribute("fontOverline"))
-		setFontOverline(attributes.value("fontOverline").toString().toLower() == "true");
-	if (attributes.hasAttribute("fontStrikeOut"))
-		setFontStrikeOut(attributes.value("fontStrikeOut").toString().toLower() == "true");
-
-	if (attributes.hasAttribute("textColor"))
-		setTextColor(Drawing::colorFromString(attributes.value("textColor").toString()));
-
 	if (attributes.hasAttribute("caption"))
 		setCaption(attributes.value("caption").toString());
 }
@@ -697,10 +692,17 @@ void DrawingChartEllipseItem::updateLabel(const QFont& font, QPaintDevice* devic
 	mTextRect = QRectF(QPointF(-textSizeF.width() / 2, -textSizeF.height() / 2), textSizeF);
 
 	// Update mBoundingRect
-	mBoundingRect = Drawing::rotateRect(QRectF(
+	QRectF labelRect = Drawing::rotateRect(QRectF(
 		QPointF(mTextRect.left() * scaleFactor, mTextRect.top() * scaleFactor),
 		QPointF(mTextRect.right() * scaleFactor, mTextRect.bottom() * scaleFactor)),
 		rotationAngle()).translated(DrawingEllipseItem::boundingRect().center());
+
+	// Only report a geometry change if the label's size actually changed
+	if (labelRect != mBoundingRect)
+	{
+		mBoundingRect = labelRect;
+		invalidateGeometry();
+	}
 }
 
 qreal DrawingChartEllipseItem::orientedTextAngle() const
@@ -722,15 +724,15 @@ qreal DrawingChartEllipseItem::orientedTextAngle() const
 
 DrawingChartPolygonItem::DrawingChartPolygonItem() : DrawingPolygonItem()
 {
-	addProperty("Font Family", "Arial");
-	addProperty("Font Size", 100.0);
-	addProperty("Font Bold", false);
-	addProperty("Font Italic", false);
-	addProperty("Font Underline", false);
-	addProperty("Font Overline", false);
-	addProperty("Font Strike-Out", false);
-	addProperty("Text Color", QColor(255, 0, 255));
-	addProperty("Caption", "Label");
+	addProperty(FontFamilyProperty, "Arial");
+	addProperty(FontSizeProperty, 100.0);
+	addProperty(FontBoldProperty, false);
+	addProperty(FontItalicProperty, false);
+	addProperty(FontUnderlineProperty, false);
+	addProperty(FontOverlineProperty, false);
+	addProperty(FontStrikeOutProperty, false);
+	addProperty(TextColorProperty, QColor(255, 0, 255));
+	addProperty(CaptionProperty, "Label");
 
 	setFlags(CanMove | CanRotate | CanFlip | CanResize | CanInsertRemovePoints | MatchUnitsWithParent);
 	setPlaceType(PlaceMouseUp);
@@ -767,37 +769,37 @@ void DrawingChartPolygonItem::setFont(const QFont& font)
 
 void DrawingChartPolygonItem::setFontFamily(const QString& family)
 {
-	setPropertyValue("Font Family", family);
+	setPropertyValue(FontFamilyProperty, family);
 }
 
 void DrawingChartPolygonItem::setFontSize(qreal size)
 {
-	setPropertyValue("Font Size", size);
+	setPropertyValue(FontSizeProperty, size);
 }
 
 void DrawingChartPolygonItem::setFontBold(bool bold)
 {
-	setPropertyValue("Font Bold", bold);
+	setPropertyValue(FontBoldProperty, bold);
 }
 
 void DrawingChartPolygonItem::setFontItalic(bool italic)
 {
-	setPropertyValue("Font Italic", italic);
+	setPropertyValue(FontItalicProperty, italic);
 }
 
 void DrawingChartPolygonItem::setFontUnderline(bool underline)
 {
-	setPropertyValue("Font Underline", underline);
+	setPropertyValue(FontUnderlineProperty, underline);
 }
 
 void DrawingChartPolygonItem::setFontOverline(bool overline)
 {
-	setPropertyValue("Font Overline", overline);
+	setPropertyValue(FontOverlineProperty, overline);
 }
 
 void DrawingChartPolygonItem::setFontStrikeOut(bool strikeOut)
 {
-	setPropertyValue("Font Strike-Out", strikeOut);
+	setPropertyValue(FontStrikeOutProperty, strikeOut);
 }
 
 QFont DrawingChartPolygonItem::font() const
@@ -817,61 +819,61 @@ QFont DrawingChartPolygonItem::font() const
 
 QString DrawingChartPolygonItem::fontFamily() const
 {
-	return propertyValue("Font Family").toString();
+	return propertyValue(FontFamilyProperty).toString();
 }
 
 qreal DrawingChartPolygonItem::fontSize() const
 {
-	return propertyValue("Font Size").toDouble();
+	return propertyValue(FontSizeProperty).toDouble();
 }
 
 bool DrawingChartPolygonItem::isFontBold() const
 {
-	return propertyValue("Font Bold").toBool();
+	return propertyValue(FontBoldProperty).toBool();
 }
 
 bool DrawingChartPolygonItem::isFontItalic() const
 {
-	return propertyValue("Font Italic").toBool();
+	return propertyValue(FontItalicProperty).toBool();
 }
 
 bool DrawingChartPolygonItem::isFontUnderline() const
 {
-	return propertyValue("Font Underline").toBool();
+	return propertyValue(FontUnderlineProperty).toBool();
 }
 
 bool DrawingChartPolygonItem::isFontOverline() const
 {
-	return propertyValue("Font Overline").toBool();
+	return propertyValue(FontOverlineProperty).toBool();
 }
 
 bool DrawingChartPolygonItem::isFontStrikeOut() const
 {
-	return propertyValue("Font Strike-Out").toBool();
+	return propertyValue(FontStrikeOutProperty).toBool();
 }
 
 //==================================================================================================
 
 void DrawingChartPolygonItem::setTextColor(const QColor& color)
 {
-	setPropertyValue("Text Color", color);
+	setPropertyValue(TextColorProperty, color);
 }
 
 QColor DrawingChartPolygonItem::textColor() const
 {
-	return propertyValue("Text Color").value<QColor>();
+	return propertyValue(TextColorProperty).value<QColor>();
 }
 
 //==================================================================================================
 
 void DrawingChartPolygonItem::setCaption(const QString& caption)
 {
-	setPropertyValue("Caption", QVariant(caption));
+	setPropertyValue(CaptionProperty, QVariant(caption));
 }
 
 QString DrawingChartPolygonItem::caption() const
 {
-	return propertyValue("Caption").toString();
+	return propertyValue(CaptionProperty).toString();
 }
 
 //==================================================================================================
@@ -898,6 +900,26 @@ QPainterPath DrawingChartPolygonItem::shape() const
 	return shape;
 }
 
+bool DrawingChartPolygonItem::shapeContains(const QPointF& itemPos) const
+{
+	bool contains = DrawingPolygonItem::shapeContains(itemPos);
+
+	if (!contains && brush().color().alpha() == 0)
+		contains = mBoundingRect.contains(itemPos);
+
+	return contains;
+}
+
+bool DrawingChartPolygonItem::shapeIntersects(const QRectF& itemRect) const
+{
+	bool intersects = DrawingPolygonItem::shapeIntersects(itemRect);
+
+	if (!intersects && brush().color().alpha() == 0)
+		intersects = mBoundingRect.intersects(itemRect.normalized());
+
+	return intersects;
+}
+
 bool DrawingChartPolygonItem::isSuperfluous() const
 {
 	return (DrawingPolygonItem::isSuperfluous() && caption() == "");
@@ -986,14 +1008,6 @@ void DrawingChartPolygonItem::writeXmlAttributes(QXmlStreamWriter& xmlWriter, co
 {
 	DrawingPolygonItem::writeXmlAttributes(xmlWriter, items);
 
-	xmlWriter.writeAttribute("fontFamily", fontFamily());
-	xmlWriter.writeAttribute("fontSize", QString::number(fontSize()));
-	xmlWriter.writeAttribute("fontBold", isFontBold() ? "true" : "false");
-	xmlWriter.writeAttribute("fontItalic", isFontItalic() ? "true" : "false");
-	xmlWriter.writeAttribute("fontUnderline", isFontUnderline() ? "true" : "false");
-	xmlWriter.writeAttribute("fontOverline", isFontOverline() ? "true" : "false");
-	xmlWriter.writeAttribute("fontStrikeOut", isFontStrikeOut() ? "true" : "false");
-	xmlWriter.writeAttribute("textColor", Drawing::colorToString(textColor()));
 	xmlWriter.writeAttribute("caption", caption());
 }
 
@@ -1003,24 +1017,6 @@ void DrawingChartPolygonItem::readXmlAttributes(QXmlStreamReader& xmlReader, con
 
 	DrawingPolygonItem::readXmlAttributes(xmlReader, items);
 
-	if (attributes.hasAttribute("fontFamily"))
-		setFontFamily(attributes.value("fontFamily").toString());
-	if (attributes.hasAttribute("fontSize"))
-		setFontSize(attributes.value("fontSize").toString().toDouble());
-	if (attributes.hasAttribute("fontBold"))
-		setFontBold(attributes.value("fontBold").toString().toLower() == "true");
-	if (attributes.hasAttribute("fontItalic"))
-		setFontItalic(attributes.value("fontItalic").toString().toLower() == "true");
-	if (attributes.hasAttribute("fontUnderline"))
-		setFontUnderline(attributes.value("fontUnderline").toString().toLower() == "true");
-	if (attributes.hasAttribute("fontOverline"))
-		setFontOverline(attributes.value("fontOverline").toString().toLower() == "true");
-	if (attributes.hasAttribute("fontStrikeOut"))
-		setFontStrikeOut(attributes.value("fontStrikeOut").toString().toLower() == "true");
-
-	if (attributes.hasAttribute("textColor"))
-		setTextColor(Drawing::colorFromString(attributes.value("textColor").toString()));
-
 	if (attributes.hasAttribute("caption"))
 		setCaption(attributes.value("caption").toString());
 }
@@ -1036,10 +1032,17 @@ void DrawingChartPolygonItem::updateLabel(const QFont& font, QPaintDevice* devic
 	mTextRect = QRectF(QPointF(-textSizeF.width() / 2, -textSizeF.height() / 2), textSizeF);
 
 	// Update mBoundingRect
-	mBoundingRect = Drawing::rotateRect(QRectF(
+	QRectF labelRect = Drawing::rotateRect(QRectF(
 		QPointF(mTextRect.left() * scaleFactor, mTextRect.top() * scaleFactor),
 		QPointF(mTextRect.right() * scaleFactor, mTextRect.bottom() * scaleFactor)),
 		rotationAngle()).translated(centerPoint());
+
+	// Only report a geometry change if the label's size actually changed
+	if (labelRect != mBoundingRect)
+	{
+		mBoundingRect = labelRect;
+		invalidateGeometry();
+	}
 }
 
 //==================================================================================================
@@ -67,6 +67,8 @@ public:
 	// Description
 	QRectF boundingRect() const;
 	QPainterPath shape() const;
+	bool shapeContains(const QPointF& itemPos) const;
+	bool shapeIntersects(const QRectF& itemRect) const;
 	bool isSuperfluous() const;
 
 	// Render
@@ -133,6 +135,8 @@ public:
 	// Description
 	QRectF boundingRect() const;
 	QPainterPath shape() const;
+	bool shapeContains(const QPointF& itemPos) const;
+	bool shapeIntersects(const QRectF& itemRect) const;
 	bool isSuperfluous() const;
 
 	// Render
@@ -199,6 +203,8 @@ public:
 	// Description
 	QRectF boundingRect() const;
 	QPainterPath shape() const;
+	bool shapeContains(const QPointF& itemPos) const;
+	bool shapeIntersects(const QRectF& itemRect) const;
 	bool isSuperfluous() const;
 
 	// Render
@@ -111,6 +111,89 @@ qreal distanceFromPointToLineSegment(const QPointF& point, const QLineF& line)
 	return distance;
 }
 
+bool lineSegmentIntersectsRect(const QLineF& line, const QRectF& rect)
+{
+	// Liang-Barsky: clip the segment's parameter range [0, 1] against each edge of the rect
+	QRectF clipRect = rect.normalized();
+	qreal deltaX = line.x2() - line.x1();
+	qreal deltaY = line.y2() - line.y1();
+	qreal p[4] = { -deltaX, deltaX, -deltaY, deltaY };
+	qreal q[4] = { line.x1() - clipRect.left(), clipRect.right() - line.x1(),
+				   line.y1() - clipRect.top(), clipRect.bottom() - line.y1() };
+	qreal t0 = 0.0, t1 = 1.0, ratio;
+	bool intersects = true;
+
+	for(int i = 0; intersects && i < 4; i++)
+	{
+		if (p[i] == 0) intersects = (q[i] >= 0);
+		else
+		{
+			ratio = q[i] / p[i];
+
+			if (p[i] < 0)
+			{
+				if (ratio > t1) intersects = false;
+				else if (ratio > t0) t0 = ratio;
+			}
+			else
+			{
+				if (ratio < t0) intersects = false;
+				else if (ratio < t1) t1 = ratio;
+			}
+		}
+	}
+
+	return intersects;
+}
+
+bool roundedRectContainsPoint(const QRectF& roundedRect, qreal xRadius, qreal yRadius, const QPointF& point)
+{
+	return roundedRectIntersectsRect(roundedRect, xRadius, yRadius, QRectF(point, QSizeF(0, 0)));
+}
+
+bool roundedRectIntersectsRect(const QRectF& roundedRect, qreal xRadius, qreal yRadius, const QRectF& rect)
+{
+	// A rounded rect is the union of a horizontal band, a vertical band, and four corner ellipses,
+	// each of which can be tested exactly.  Comparisons are inclusive so that zero-size rects (and
+	// therefore points) are handled.
+	QRectF bounds = roundedRect.normalized();
+	QRectF testRect = rect.normalized();
+	QRectF bandRect;
+	bool intersects = false;
+
+	xRadius = qMin(qAbs(xRadius), bounds.width() / 2);
+	yRadius = qMin(qAbs(yRadius), bounds.height() / 2);
+
+	for(int i = 0; !intersects && i < 2; i++)
+	{
+		if (i == 0) bandRect = bounds.adjusted(0, yRadius, 0, -yRadius);
+		else bandRect = bounds.adjusted(xRadius, 0, -xRadius, 0);
+
+		intersects = (bandRect.left() <= testRect.right() && testRect.left() <= bandRect.right() &&
+			bandRect.top() <= testRect.bottom() && testRect.top() <= bandRect.bottom());
+	}
+
+	if (!intersects && xRadius > 0 && yRadius > 0)
+	{
+		QPointF centers[4] = {
+			QPointF(bounds.left() + xRadius, bounds.top() + yRadius),
+			QPointF(bounds.right() - xRadius, bounds.top() + yRadius),
+			QPointF(bounds.right() - xRadius, bounds.bottom() - yRadius),
+			QPointF(bounds.left() + xRadius, bounds.bottom() - yRadius) };
+		qreal deltaX, deltaY;
+
+		// The point of the rect nearest to each ellipse center decides whether they overlap
+		for(int i = 0; !intersects && i < 4; i++)
+		{
+			deltaX = (qBound(testRect.left(), centers[i].x(), testRect.right()) - centers[i].x()) / xRadius;
+			deltaY = (qBound(testRect.top(), centers[i].y(), testRect.bottom()) - centers[i].y()) / yRadius;
+			intersects = (deltaX * deltaX + deltaY * deltaY <= 1.0);
+		}
+	}
+
+	return intersects;
+}
+
 //==================================================================================================
 
 QSizeF textSize(const QString& text, const QFont& font, QPaintDevice* device)
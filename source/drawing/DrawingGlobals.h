@@ -32,10 +32,15 @@
 //#define DEBUG_DRAW_ITEM_SHAPE
 #undef DEBUG_DRAW_ITEM_SHAPE
 
+//#define DEBUG_DRAW_ITEM_COUNTS
+#undef DEBUG_DRAW_ITEM_COUNTS
+
 class DrawingView;
 class DrawingScene;
 class DrawingItem;
 class DrawingItemPoint;
+class DrawingJournal;
+class DrawingStyleTable;
 
 enum DrawingUnits { UnitsMils, UnitsSimpleMM, UnitsMM };
 enum DrawingItemPlaceMode { DoNotPlace, PlaceStrict, PlaceLoose };
@@ -52,6 +57,9 @@ QRectF rotateRect(const QRectF& rect, qreal rotationAngle);
 qreal magnitude(const QPointF &vec);
 qreal magnitude(const QPoint &vec);
 qreal distanceFromPointToLineSegment(const QPointF& point, const QLineF& line);
+bool lineSegmentIntersectsRect(const QLineF& line, const QRectF& rect);
+bool roundedRectContainsPoint(const QRectF& roundedRect, qreal xRadius, qreal yRadius, const QPointF& point);
+bool roundedRectIntersectsRect(const QRectF& roundedRect, qreal xRadius, qreal yRadius, const QRectF& rect);
 
 QSizeF textSize(const QString& text, const QFont& font, QPaintDevice* device);
 
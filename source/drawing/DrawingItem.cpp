@@ -22,10 +22,12 @@
 #include <DrawingScene.h>
 #include <DrawingView.h>
 #include <DrawingItemPoint.h>
+#include <DrawingStyleTable.h>
 
 DrawingItem::DrawingItem()
 {
 	mScene = nullptr;
+	mId = 0;
 
 	mPosition = QPointF(0.0, 0.0);
 	mUnits = UnitsMils;
@@ -41,11 +43,21 @@ DrawingItem::DrawingItem()
 
 	mRotationAngle = 0;
 	mFlipped = false;
+
+	mStyleId = -1;
+
+	mSceneTransformValid = false;
+	mSceneBoundingRectValid = false;
 }
 
 DrawingItem::DrawingItem(const DrawingItem& item)
 {
 	mScene = nullptr;
+	mId = 0;
+	mParent = nullptr;
+
+	mSceneTransformValid = false;
+	mSceneBoundingRectValid = false;
 
 	mPosition = item.mPosition;
 	mUnits = item.mUnits;
@@ -58,6 +70,8 @@ DrawingItem::DrawingItem(const DrawingItem& item)
 	mSelectedPoint = nullptr;
 
 	mProperties = item.mProperties;
+	mStyleProperties = item.mStyleProperties;
+	mStyleId = -1;
 
 	for(auto childIter = item.mChildren.begin(); childIter != item.mChildren.end(); childIter++)
 		addChild((*childIter)->copy());
@@ -92,12 +106,18 @@ DrawingView* DrawingItem::view() const
 	return (mScene) ? mScene->view() : nullptr;
 }
 
+quint64 DrawingItem::id() const
+{
+	return mId;
+}
+
 //==================================================================================================
 
 void DrawingItem::setPos(const QPointF& parentPos)
 {
 	QPointF posActual = aboutToChangeEvent(PositionChange, QVariant(parentPos)).toPointF();
 	mPosition = posActual;
+	invalidateGeometry();
 	changedEvent(PositionChange, QVariant(posActual));
 }
 
@@ -152,6 +172,7 @@ void DrawingItem::setUnits(DrawingUnits units)
 		if ((*childIter)->shouldMatchUnitsWithParent()) (*childIter)->setUnits(units);
 	}
 
+	invalidateGeometry();
 	changedEvent(UnitsChange, QVariant((int)newUnits));
 }
 
@@ -221,55 +242,121 @@ bool DrawingItem::shouldUsePalette() const
 
 //==================================================================================================
 
+void DrawingItem::addProperty(int property, const QVariant& value)
+{
+	if (isStyleProperty(property))
+	{
+		mStyleProperties[property] = value;
+		mStyleId = -1;
+	}
+	else mProperties[property] = value;
+}
+
 void DrawingItem::addProperty(const QString& property, const QVariant& value)
 {
-	mProperties[property] = value;
+	addProperty(propertyId(property), value);
+}
+
+void DrawingItem::removeProperty(int property)
+{
+	if (isStyleProperty(property))
+	{
+		mStyleProperties.remove(property);
+		mStyleId = -1;
+	}
+	else mProperties.remove(property);
 }
 
 void DrawingItem::removeProperty(const QString& property)
 {
-	mProperties.remove(property);
+	removeProperty(propertyId(property));
 }
 
 void DrawingItem::clearProperties()
 {
 	mProperties.clear();
+	mStyleProperties.clear();
+	mStyleId = -1;
 }
 
 int DrawingItem::numberOfProperties() const
 {
-	return mProperties.size();
+	return mProperties.size() + mStyleProperties.size();
+}
+
+bool DrawingItem::containsProperty(int property) const
+{
+	return (isStyleProperty(property)) ? mStyleProperties.contains(property) : mProperties.contains(property);
 }
 
 bool DrawingItem::containsProperty(const QString& property) const
 {
-	return mProperties.contains(property);
+	return containsProperty(propertyId(property));
 }
 
 QStringList DrawingItem::propertiesList() const
 {
-	return mProperties.keys();
+	QStringList names;
+
+	for(auto propertyIter = mStyleProperties.begin(); propertyIter != mStyleProperties.end(); propertyIter++)
+		names.append(propertyName(propertyIter.key()));
+	for(auto propertyIter = mProperties.begin(); propertyIter != mProperties.end(); propertyIter++)
+		names.append(propertyName(propertyIter.key()));
+
+	return names;
 }
 
 QList<QVariant> DrawingItem::propertyValues() const
 {
-	return mProperties.values();
+	// In the same order as propertiesList()
+	return mStyleProperties.values() + mProperties.values();
 }
 
 //==================================================================================================
 
+void DrawingItem::setPropertyValue(int property, const QVariant& value)
+{
+	aboutToChangeEvent(PropertyChange, QVariant());
+	addProperty(property, value);
+	invalidateGeometry();
+	changedEvent(PropertyChange, QVariant());
+}
+
 void DrawingItem::setPropertyValue(const QString& property, const QVariant& value)
 {
+	setPropertyValue(propertyId(property), value);
+}
+
+void DrawingItem::setPropertyValues(const QHash<int, QVariant>& values)
+{
+	// Only updates properties the item already has; any other values are ignored
 	aboutToChangeEvent(PropertyChange, QVariant());
-	mProperties[property] = value;
+	for(auto valueIter = values.begin(); valueIter != values.end(); valueIter++)
+	{
+		if (containsProperty(valueIter.key())) addProperty(valueIter.key(), valueIter.value());
+	}
+	invalidateGeometry();
 	changedEvent(PropertyChange, QVariant());
 }
 
+void DrawingItem::setPropertyValues(const QHash<QString, QVariant>& values)
+{
+	QHash<int, QVariant> idValues;
+
+	for(auto valueIter = values.begin(); valueIter != values.end(); valueIter++)
+		idValues[propertyId(valueIter.key())] = valueIter.value();
+
+	setPropertyValues(idValues);
+}
+
+QVariant DrawingItem::propertyValue(int property) const
+{
+	return (isStyleProperty(property)) ? mStyleProperties.value(property) : mProperties.value(property);
+}
+
 QVariant DrawingItem::propertyValue(const QString& property) const
 {
-	QVariant value;
-	if (mProperties.contains(property)) value = mProperties[property];
-	return value;
+	return propertyValue(propertyId(property));
 }
 
 //==================================================================================================
@@ -277,13 +364,112 @@ QVariant DrawingItem::propertyValue(const QString& property) const
 void DrawingItem::setProperties(const QHash<QString, QVariant>& properties)
 {
 	aboutToChangeEvent(PropertyChange, QVariant());
-	mProperties = properties;
+	clearProperties();
+	for(auto propertyIter = properties.begin(); propertyIter != properties.end(); propertyIter++)
+		addProperty(propertyId(propertyIter.key()), propertyIter.value());
+	invalidateGeometry();
 	changedEvent(PropertyChange, QVariant());
 }
 
 QHash<QString, QVariant> DrawingItem::properties() const
 {
-	return mProperties;
+	QHash<QString, QVariant> properties;
+
+	for(auto propertyIter = mStyleProperties.begin(); propertyIter != mStyleProperties.end(); propertyIter++)
+		properties[propertyName(propertyIter.key())] = propertyIter.value();
+	for(auto propertyIter = mProperties.begin(); propertyIter != mProperties.end(); propertyIter++)
+		properties[propertyName(propertyIter.key())] = propertyIter.value();
+
+	return properties;
+}
+
+const QHash<int, QVariant>& DrawingItem::styleProperties() const
+{
+	return mStyleProperties;
+}
+
+//==================================================================================================
+
+static QMutex& propertyNamesMutex()
+{
+	static QMutex mutex;
+	return mutex;
+}
+
+static QStringList& propertyNames()
+{
+	// Seeded in the order of the Property enum so that the standard ids match the enum values
+	static QStringList names = QStringList() << "Pen Color" << "Pen Width" << "Pen Style" <<
+		"Pen Cap Style" << "Pen Join Style" << "Brush Color" << "Corner X-Radius" <<
+		"Corner Y-Radius" << "Start Arrow Style" << "Start Arrow Size" << "End Arrow Style" <<
+		"End Arrow Size" << "Font Family" << "Font Size" << "Font Bold" << "Font Italic" <<
+		"Font Underline" << "Font Overline" << "Font Strike-Out" << "Text Horizontal Alignment" <<
+		"Text Vertical Alignment" << "Text Color" << "Caption" << "Image";
+	return names;
+}
+
+static QHash<QString, int>& propertyIds()
+{
+	static QHash<QString, int> ids;
+
+	if (ids.isEmpty())
+	{
+		const QStringList& names = propertyNames();
+		for(int i = 0; i < names.size(); i++) ids[names[i]] = i;
+	}
+
+	return ids;
+}
+
+int DrawingItem::propertyId(const QString& name)
+{
+	// The registry is shared by every item, so names may be interned from more than one thread
+	QMutexLocker locker(&propertyNamesMutex());
+	QHash<QString, int>& ids = propertyIds();
+
+	auto idIter = ids.find(name);
+	if (idIter == ids.end())
+	{
+		idIter = ids.insert(name, propertyNames().size());
+		propertyNames().append(name);
+	}
+
+	return idIter.value();
+}
+
+QString DrawingItem::propertyName(int property)
+{
+	QMutexLocker locker(&propertyNamesMutex());
+	return propertyNames().value(property);
+}
+
+bool DrawingItem::isStyleProperty(int property)
+{
+	bool styleProperty = false;
+
+	switch (property)
+	{
+	case PenColorProperty:
+	case PenWidthProperty:
+	case PenStyleProperty:
+	case PenCapStyleProperty:
+	case PenJoinStyleProperty:
+	case BrushColorProperty:
+	case FontFamilyProperty:
+	case FontSizeProperty:
+	case FontBoldProperty:
+	case FontItalicProperty:
+	case FontUnderlineProperty:
+	case FontOverlineProperty:
+	case FontStrikeOutProperty:
+	case TextColorProperty:
+		styleProperty = true;
+		break;
+	default:
+		break;
+	}
+
+	return styleProperty;
 }
 
 //==================================================================================================
@@ -294,6 +480,7 @@ void DrawingItem::addPoint(DrawingItemPoint* itemPoint)
 	{
 		mPoints.append(itemPoint);
 		itemPoint->mItem = this;
+		invalidateGeometry();
 	}
 }
 
@@ -303,6 +490,7 @@ void DrawingItem::insertPoint(int index, DrawingItemPoint* itemPoint)
 	{
 		mPoints.insert(index, itemPoint);
 		itemPoint->mItem = this;
+		invalidateGeometry();
 	}
 }
 
@@ -312,6 +500,7 @@ void DrawingItem::removePoint(DrawingItemPoint* itemPoint)
 	{
 		mPoints.removeAll(itemPoint);
 		itemPoint->mItem = nullptr;
+		invalidateGeometry();
 	}
 }
 
@@ -328,7 +517,7 @@ void DrawingItem::clearPoints()
 	}
 }
 
-QList<DrawingItemPoint*> DrawingItem::points() const
+const QList<DrawingItemPoint*>& DrawingItem::points() const
 {
 	return mPoints;
 }
@@ -401,6 +590,8 @@ void DrawingItem::addChild(DrawingItem* childItem)
 	{
 		mChildren.append(childItem);
 		childItem->mParent = this;
+		childItem->invalidateSceneGeometry();
+		invalidateGeometry();
 	}
 }
 
@@ -410,6 +601,8 @@ void DrawingItem::insertChild(int index, DrawingItem* childItem)
 	{
 		mChildren.insert(index, childItem);
 		childItem->mParent = this;
+		childItem->invalidateSceneGeometry();
+		invalidateGeometry();
 	}
 }
 
@@ -419,6 +612,8 @@ void DrawingItem::removeChild(DrawingItem* childItem)
 	{
 		mChildren.removeAll(childItem);
 		childItem->mParent = nullptr;
+		childItem->invalidateSceneGeometry();
+		invalidateGeometry();
 	}
 }
 
@@ -435,7 +630,7 @@ void DrawingItem::clearChildren()
 	}
 }
 
-QList<DrawingItem*> DrawingItem::children() const
+const QList<DrawingItem*>& DrawingItem::children() const
 {
 	return mChildren;
 }
@@ -506,11 +701,13 @@ void DrawingItem::setRotationAngle(qreal angle)
 	mRotationAngle = angle;
 	while (mRotationAngle >= 360.0) mRotationAngle -= 360.0;
 	while (mRotationAngle < 0.0) mRotationAngle += 360.0;
+	invalidateGeometry();
 }
 
 void DrawingItem::setFlipped(bool flipped)
 {
 	mFlipped = flipped;
+	invalidateGeometry();
 }
 
 qreal DrawingItem::rotationAngle() const
@@ -559,22 +756,14 @@ QRectF DrawingItem::mapFromParent(const QRectF& parentRect) const
 
 QPointF DrawingItem::mapToScene(const QPointF& itemPos) const
 {
-	QPointF scenePos = itemPos;
-
-	if (mParent) scenePos = mParent->mapToScene(mapToParent(itemPos));
-	else if (mScene) scenePos = itemPos / Drawing::unitsScale(mUnits, mScene->units()) + mPosition;
-
-	return scenePos;
+	if (!mSceneTransformValid) updateSceneTransform();
+	return mSceneTransform.map(itemPos);
 }
 
 QPointF DrawingItem::mapFromScene(const QPointF& scenePos) const
 {
-	QPointF itemPos = scenePos;
-
-	if (mParent) itemPos = mapFromParent(mParent->mapFromScene(scenePos));
-	else if (mScene) itemPos = (scenePos - mPosition) * Drawing::unitsScale(mUnits, mScene->units());
-
-	return itemPos;
+	if (!mSceneTransformValid) updateSceneTransform();
+	return mSceneInverseTransform.map(scenePos);
 }
 
 QRectF DrawingItem::mapToScene(const QRectF& itemRect) const
@@ -589,6 +778,25 @@ QRectF DrawingItem::mapFromScene(const QRectF& sceneRect) const
 
 //==================================================================================================
 
+QTransform DrawingItem::sceneTransform() const
+{
+	if (!mSceneTransformValid) updateSceneTransform();
+	return mSceneTransform;
+}
+
+QRectF DrawingItem::sceneBoundingRect() const
+{
+	if (!mSceneBoundingRectValid)
+	{
+		mSceneBoundingRect = mapToScene(boundingRect());
+		mSceneBoundingRectValid = true;
+	}
+
+	return mSceneBoundingRect;
+}
+
+//==================================================================================================
+
 QPainterPath DrawingItem::shape() const
 {
 	QPainterPath path;
@@ -596,6 +804,16 @@ QPainterPath DrawingItem::shape() const
 	return path;
 }
 
+bool DrawingItem::shapeContains(const QPointF& itemPos) const
+{
+	return shape().contains(itemPos);
+}
+
+bool DrawingItem::shapeIntersects(const QRectF& itemRect) const
+{
+	return shape().intersects(itemRect);
+}
+
 QPointF DrawingItem::centerPos() const
 {
 	return boundingRect().center();
@@ -659,7 +877,7 @@ void DrawingItem::flipItem(const QPointF& parentPos)
 	setPos(2 * parentPos.x() - x(), y());
 
 	// Update orientation
-	mFlipped = !mFlipped;
+	setFlipped(!mFlipped);
 
 	// Calculate new offsets of control points
 	for(auto pointIter = mPoints.begin(); pointIter != mPoints.end(); pointIter++)
@@ -771,16 +989,16 @@ void DrawingItem::writeXmlAttributes(QXmlStreamWriter& xmlWriter, const QList<Dr
 	xmlWriter.writeAttribute("rotationAngle", QString::number(rotationAngle()));
 	xmlWriter.writeAttribute("flipped", (isFlipped()) ? "true" : "false");
 
-	// Any properties should be saved in derived class writeXmlAttributes
+	// Any properties should be saved in derived class writeXmlAttributes, except for the style
+	// properties, which are saved by writeItemsToXml
 }
 
-void DrawingItem::writeXmlChildElements(QXmlStreamWriter& xmlWriter, const QList<DrawingItem*>& items)
+void DrawingItem::writeXmlChildElements(QXmlStreamWriter& xmlWriter, const QList<DrawingItem*>& items,
+	const PointIndexMap& pointIndices)
 {
-	QList<DrawingItemPoint*> points = DrawingItem::points();
-	DrawingItemPoint* targetItemPoint;
-	DrawingItem* targetItem;
-	int itemIndex, targetItemIndex;
-	QString pointConnections;
+	const QList<DrawingItemPoint*>& points = DrawingItem::points();
+	QStringList pointConnections;
+	Q_UNUSED(items);
 
 	// Points
 	for(auto pointIter = points.begin(); pointIter != points.end(); pointIter++)
@@ -794,29 +1012,23 @@ void DrawingItem::writeXmlChildElements(QXmlStreamWriter& xmlWriter, const QList
 		xmlWriter.writeAttribute("category", QString::number((*pointIter)->category()));
 
 		// Targets
-		pointConnections = QString();
-		itemIndex = items.indexOf(this);
-		if (itemIndex >= 0)
+		pointConnections.clear();
+		if (pointIndices.contains(*pointIter))
 		{
-			for(int i = 0; i < (*pointIter)->numberOfTargets(); i++)
+			const DrawingItemPoint::TargetList& targets = (*pointIter)->targetList();
+			for(auto targetIter = targets.begin(); targetIter != targets.end(); targetIter++)
 			{
-				targetItemPoint = (*pointIter)->target(i);
-				targetItem = targetItemPoint->item();
-
-				if (targetItem) targetItemIndex = items.indexOf(targetItem);
-				else targetItemIndex = -1;
-
-				if (targetItemIndex >= 0)
+				auto targetIndexIter = pointIndices.find(*targetIter);
+				if (targetIndexIter != pointIndices.end())
 				{
-					pointConnections += QString::number(targetItemIndex) + ",";
-					pointConnections += QString::number(targetItem->points().indexOf(targetItemPoint)) + ",";
+					pointConnections.append(QString::number(targetIndexIter.value().first));
+					pointConnections.append(QString::number(targetIndexIter.value().second));
 				}
 			}
 		}
-		pointConnections = pointConnections.left(pointConnections.size() - 1);
 
 		if (!pointConnections.isEmpty())
-			xmlWriter.writeAttribute("connections", pointConnections);
+			xmlWriter.writeAttribute("connections", pointConnections.join(","));
 
 		xmlWriter.writeEndElement();
 	}
@@ -850,10 +1062,11 @@ void DrawingItem::readXmlAttributes(QXmlStreamReader& xmlReader, const QList<Dra
 	if (attributes.hasAttribute("flipped"))
 		setFlipped(attributes.value("flipped").toString().toLower() == "true");
 
-	// Any properties should be saved in derived class writeXmlAttributes
+	// Any properties should be loaded in derived class readXmlAttributes, except for the style
+	// properties, which are loaded by readItemsFromXml
 }
 
-void DrawingItem::readXmlChildElement(QXmlStreamReader& xmlReader, const QList<DrawingItem*>& items)
+void DrawingItem::readXmlChildElement(QXmlStreamReader& xmlReader, const QHash<quint64, DrawingItem*>& items)
 {
 	if (xmlReader.name() == "itemPoint")
 	{
@@ -861,7 +1074,7 @@ void DrawingItem::readXmlChildElement(QXmlStreamReader& xmlReader, const QList<D
 		QXmlStreamAttributes attributes = xmlReader.attributes();
 
 		QStringList pointConnections;
-		int itemIndex, pointIndex;
+		int pointIndex;
 		DrawingItem* targetItem;
 		DrawingItemPoint* targetItemPoint;
 
@@ -883,14 +1096,14 @@ void DrawingItem::readXmlChildElement(QXmlStreamReader& xmlReader, const QList<D
 			pointConnections = attributes.value("connections").toString().split(
 				",", QString::SkipEmptyParts);
 
-			for(int i = 0; i < pointConnections.size(); i += 2)
+			// Each connection refers to the target item by the id it was saved with
+			for(int i = 0; i + 1 < pointConnections.size(); i += 2)
 			{
-				itemIndex = pointConnections[i].toInt();
+				targetItem = items.value(pointConnections[i].toULongLong());
 				pointIndex = pointConnections[i+1].toInt();
 
-				if (itemIndex < items.size())
+				if (targetItem)
 				{
-					targetItem = items[itemIndex];
 					if (pointIndex < targetItem->numberOfPoints())
 					{
 						targetItemPoint = targetItem->point(pointIndex);
@@ -911,6 +1124,20 @@ void DrawingItem::readXmlChildElement(QXmlStreamReader& xmlReader, const QList<D
 	// Children should be saved in derived class readXmlChildElements
 }
 
+void DrawingItem::writeBinaryData(QDataStream& stream)
+{
+	Q_UNUSED(stream);
+
+	// The position, points, properties, and connections are saved by writeItemsToBinary
+}
+
+void DrawingItem::readBinaryData(QDataStream& stream)
+{
+	Q_UNUSED(stream);
+
+	// The position, points, properties, and connections are loaded by readItemsFromBinary
+}
+
 //==================================================================================================
 
 void DrawingItem::setupPainter(QPainter* painter,
@@ -960,30 +1187,44 @@ void DrawingItem::setupPainter(QPainter* painter,
 
 QPainterPath DrawingItem::itemShapeFromPath(const QPainterPath& path, const QPen& pen, bool adjustOutline) const
 {
-	QPainterPath shape;
+	if (path == QPainterPath()) return QPainterPath();
 
-	if (path != QPainterPath())
+	// The stroked outline only depends on the path, the width after adjusting for the current zoom
+	// level, and the pen's cap, join, and miter settings.  Moving the item or changing its colors
+	// leaves all of these alone, so the last outline is reused until one of them changes.
+	QPen strokePen(Qt::black, itemOutlineWidth(pen, adjustOutline), Qt::SolidLine, pen.capStyle(), pen.joinStyle());
+	strokePen.setMiterLimit(pen.miterLimit());
+
+	if (strokePen != mShapeCachePen || path != mShapeCachePath)
 	{
 		QPainterPathStroker painterPathStroker;
 
-		if (pen.widthF() > 0)
-		{
-			if (adjustOutline)
-				painterPathStroker.setWidth(adjustOutlineForView(pen.widthF()));
-			else
-				painterPathStroker.setWidth(pen.widthF());
-		}
-		else
-			painterPathStroker.setWidth(0.00000001);
+		painterPathStroker.setWidth(strokePen.widthF());
+		painterPathStroker.setCapStyle(strokePen.capStyle());
+		painterPathStroker.setJoinStyle(strokePen.joinStyle());
+		painterPathStroker.setMiterLimit(strokePen.miterLimit());
+
+		mShapeCache = painterPathStroker.createStroke(path);
+		mShapeCachePath = path;
+		mShapeCachePen = strokePen;
+	}
+
+	return mShapeCache;
+}
 
-		painterPathStroker.setCapStyle(pen.capStyle());
-		painterPathStroker.setJoinStyle(pen.joinStyle());
-		painterPathStroker.setMiterLimit(pen.miterLimit());
+qreal DrawingItem::itemOutlineWidth(const QPen& pen, bool adjustOutline) const
+{
+	// Width of the outline used by itemShapeFromPath and by the analytic shapeContains and
+	// shapeIntersects implementations of derived items
+	qreal width = 0.00000001;
 
-		shape = painterPathStroker.createStroke(path);
+	if (pen.widthF() > 0)
+	{
+		if (adjustOutline) width = adjustOutlineForView(pen.widthF());
+		else width = pen.widthF();
 	}
 
-	return shape;
+	return width;
 }
 
 qreal DrawingItem::adjustOutlineForView(qreal penWidth) const
@@ -1000,6 +1241,49 @@ qreal DrawingItem::adjustOutlineForView(qreal penWidth) const
 	return adjustedWidth;
 }
 
+void DrawingItem::invalidateGeometry()
+{
+	// Only top-level items are tracked by the scene, so notify it on behalf of the whole tree
+	DrawingItem* topLevelItem = this;
+	while (topLevelItem->mParent) topLevelItem = topLevelItem->mParent;
+
+	invalidateSceneGeometry();
+	if (topLevelItem->mScene) topLevelItem->mScene->invalidateItem(topLevelItem);
+}
+
+void DrawingItem::invalidateSceneGeometry()
+{
+	// A child's transform is only ever computed after its parent's, so if this item's transform is
+	// already invalid then so are the transforms and rects of all of its children
+	bool childrenValid = mSceneTransformValid;
+
+	mSceneTransformValid = false;
+	mSceneBoundingRectValid = false;
+
+	if (childrenValid)
+	{
+		for(auto childIter = mChildren.begin(); childIter != mChildren.end(); childIter++)
+			(*childIter)->invalidateSceneGeometry();
+	}
+}
+
+void DrawingItem::updateSceneTransform() const
+{
+	// Items are only ever scaled (for units) and translated relative to their parent
+	qreal scale = 1.0;
+
+	if (mParent) scale = 1.0 / Drawing::unitsScale(mUnits, mParent->units());
+	else if (mScene) scale = 1.0 / Drawing::unitsScale(mUnits, mScene->units());
+
+	if (mParent || mScene) mSceneTransform = QTransform(scale, 0, 0, scale, mPosition.x(), mPosition.y());
+	else mSceneTransform.reset();
+
+	if (mParent) mSceneTransform *= mParent->sceneTransform();
+
+	mSceneInverseTransform = mSceneTransform.inverted();
+	mSceneTransformValid = true;
+}
+
 void DrawingItem::adjustReferencePoint()
 {
 	// Adjust position of item, points, and children so that point(0)->pos() == QPointF(0, 0)
@@ -1035,6 +1319,8 @@ DrawingItem& DrawingItem::operator=(const DrawingItem& item)
 	mSelectedPoint = nullptr;
 
 	mProperties = item.mProperties;
+	mStyleProperties = item.mStyleProperties;
+	mStyleId = -1;
 
 	for(auto childIter = item.mChildren.begin(); childIter != item.mChildren.end(); childIter++)
 		addChild((*childIter)->copy());
@@ -1046,6 +1332,9 @@ DrawingItem& DrawingItem::operator=(const DrawingItem& item)
 	mRotationAngle = item.mRotationAngle;
 	mFlipped = item.mFlipped;
 
+	mSceneTransformValid = false;
+	mSceneBoundingRectValid = false;
+
 	return *this;
 }
 
@@ -1054,32 +1343,35 @@ DrawingItem& DrawingItem::operator=(const DrawingItem& item)
 QList<DrawingItem*> DrawingItem::copyItems(const QList<DrawingItem*>& items)
 {
 	QList<DrawingItem*> copiedItems;
-	QList<DrawingItemPoint*> itemPoints;
-	QList<DrawingItemPoint*> targetPoints;
-	DrawingItem* targetItem;
-	DrawingItem* copiedTargetItem;
+	QList<quint64> itemIndices;
+	PointIndexMap pointIndices;
 	DrawingItemPoint* copiedTargetPoint;
 
 	// Copy items
 	for(auto itemIter = items.begin(); itemIter != items.end(); itemIter++)
+	{
+		itemIndices.append(copiedItems.size());
 		copiedItems.append((*itemIter)->copy());
+	}
+
+	// The copies are not in a scene yet, so connections are resolved by position in the list
+	pointIndices = pointIndexMap(items, itemIndices);
 
 	// Maintain connections to other items in this list
 	for(int itemIndex = 0; itemIndex < items.size(); itemIndex++)
 	{
-		itemPoints = items[itemIndex]->points();
+		const QList<DrawingItemPoint*>& itemPoints = items[itemIndex]->points();
 		for(int pointIndex = 0; pointIndex < itemPoints.size(); pointIndex++)
 		{
-			targetPoints = itemPoints[pointIndex]->targets();
+			const DrawingItemPoint::TargetList& targetPoints = itemPoints[pointIndex]->targetList();
 			for(auto targetIter = targetPoints.begin(); targetIter != targetPoints.end(); targetIter++)
 			{
-				targetItem = (*targetIter)->item();
-				if (items.contains(targetItem))
+				auto targetIndexIter = pointIndices.find(*targetIter);
+				if (targetIndexIter != pointIndices.end())
 				{
 					// There is a connection here that must be maintained in the copied items
-					copiedTargetItem = copiedItems[items.indexOf(targetItem)];
 					copiedTargetPoint =
-						copiedTargetItem->point(targetItem->points().indexOf(*targetIter));
+						copiedItems[(int)targetIndexIter.value().first]->point(targetIndexIter.value().second);
 
 					copiedItems[itemIndex]->point(pointIndex)->addTarget(copiedTargetPoint);
 				}
@@ -1091,38 +1383,124 @@ QList<DrawingItem*> DrawingItem::copyItems(const QList<DrawingItem*>& items)
 	return copiedItems;
 }
 
+QList<quint64> DrawingItem::fileItemIds(const QList<DrawingItem*>& items)
+{
+	QList<quint64> itemIds;
+	QSet<quint64> usedIds;
+	quint64 nextId = 1;
+
+	for(auto itemIter = items.begin(); itemIter != items.end(); itemIter++)
+		nextId = qMax(nextId, (*itemIter)->mId + 1);
+
+	// Items outside a scene (such as the children of a group) may not have an id yet, so they
+	// are given one that is unique within the list for the file
+	for(auto itemIter = items.begin(); itemIter != items.end(); itemIter++)
+	{
+		quint64 id = (*itemIter)->mId;
+		if (id == 0 || usedIds.contains(id)) id = nextId++;
+
+		usedIds.insert(id);
+		itemIds.append(id);
+	}
+
+	return itemIds;
+}
+
+DrawingItem::PointIndexMap DrawingItem::pointIndexMap(const QList<DrawingItem*>& items,
+	const QList<quint64>& itemIds)
+{
+	PointIndexMap pointIndices;
+
+	// Built once per pass so that connections can be resolved without searching the item list
+	for(int itemIndex = 0; itemIndex < items.size(); itemIndex++)
+	{
+		const QList<DrawingItemPoint*>& itemPoints = items[itemIndex]->points();
+		for(int pointIndex = 0; pointIndex < itemPoints.size(); pointIndex++)
+			pointIndices.insert(itemPoints[pointIndex], qMakePair(itemIds[itemIndex], pointIndex));
+	}
+
+	return pointIndices;
+}
+
 //==================================================================================================
 
-void DrawingItem::writeItemsToXml(QXmlStreamWriter& xmlWriter, const QList<DrawingItem*>& items)
+void DrawingItem::writeItemsToXml(QXmlStreamWriter& xmlWriter, const QList<DrawingItem*>& items,
+	const DrawingStyleTable* styles, QAtomicInt* itemsWritten)
 {
+	QList<quint64> itemIds = fileItemIds(items);
+	PointIndexMap pointIndices = pointIndexMap(items, itemIds);
+	int styleId;
+
 	for(auto itemIter = items.begin(); itemIter != items.end(); itemIter++)
 	{
 		if ((*itemIter)->parent() == nullptr)
 		{
 			xmlWriter.writeStartElement((*itemIter)->uniqueKey());
+			xmlWriter.writeAttribute("id", QString::number(itemIds[itemIter - items.begin()]));
 			(*itemIter)->writeXmlAttributes(xmlWriter, items);
-			(*itemIter)->writeXmlChildElements(xmlWriter, items);
+
+			// The style is written here rather than by each item so that it can refer to a style
+			// table written earlier in the file instead
+			if (!(*itemIter)->mStyleProperties.isEmpty())
+			{
+				styleId = (styles) ? styles->styleId((*itemIter)->mStyleProperties) : -1;
+				if (styleId >= 0)
+					xmlWriter.writeAttribute("style", QString::number(styleId));
+				else
+					DrawingStyleTable::writeStyleAttributes(xmlWriter, (*itemIter)->mStyleProperties);
+			}
+
+			(*itemIter)->writeXmlChildElements(xmlWriter, items, pointIndices);
 			xmlWriter.writeEndElement();
+
+			// Read from another thread to report the progress of a save
+			if (itemsWritten) itemsWritten->fetchAndAddRelaxed(1);
 		}
 	}
 }
 
-QList<DrawingItem*> DrawingItem::readItemsFromXml(QXmlStreamReader& xmlReader)
+QList<DrawingItem*> DrawingItem::readItemsFromXml(QXmlStreamReader& xmlReader,
+	const DrawingStyleTable* styles)
 {
 	QList<DrawingItem*> items;
+	QHash<quint64, DrawingItem*> itemIds;
 	DrawingItem* item;
+	QXmlStreamAttributes attributes;
+	QHash<int, QVariant> style;
+	QHash<int, QVariant> styleAttributes;
 
 	while (xmlReader.readNextStartElement())
 	{
 		item = DrawingView::itemFactory.create(xmlReader.name().toString());
 		if (item)
 		{
+			attributes = xmlReader.attributes();
+
+			// Files written before items had ids refer to other items by their position instead
+			if (attributes.hasAttribute("id"))
+			{
+				item->mId = attributes.value("id").toString().toULongLong();
+				itemIds.insert(item->mId, item);
+			}
+			else itemIds.insert(items.size(), item);
+
 			item->clearPoints();
 
 			item->readXmlAttributes(xmlReader, items);
 
+			// Any style attributes written on the item itself take precedence over its style id
+			style.clear();
+			if (styles && attributes.hasAttribute("style"))
+				style = styles->style(attributes.value("style").toString().toInt());
+
+			styleAttributes = DrawingStyleTable::readStyleAttributes(attributes);
+			for(auto styleIter = styleAttributes.begin(); styleIter != styleAttributes.end(); styleIter++)
+				style[styleIter.key()] = styleIter.value();
+
+			if (!style.isEmpty()) item->setPropertyValues(style);
+
 			while (xmlReader.readNextStartElement())
-				item->readXmlChildElement(xmlReader, items);
+				item->readXmlChildElement(xmlReader, itemIds);
 
 			items.append(item);
 		}
@@ -1130,3 +1508,222 @@ QList<DrawingItem*> DrawingItem::readItemsFromXml(QXmlStreamReader& xmlReader)
 
 	return items;
 }
+
+void DrawingItem::writeItemsToBinary(QDataStream& stream, const QList<DrawingItem*>& items,
+	const DrawingStyleTable* styles, QAtomicInt* itemsWritten)
+{
+	QList<DrawingItem*> topLevelItems;
+	QList<quint64> itemIds;
+	PointIndexMap pointIndices;
+	QStringList typeKeys;
+	QHash<QString, int> typeIndices;
+	QHash<int, QVariant> properties;
+	QList<quint64> connections;
+	QString typeKey;
+	quint64 itemId, targetId;
+	int itemIndex, styleId, pointIndex, targetPointIndex;
+
+	for(auto itemIter = items.begin(); itemIter != items.end(); itemIter++)
+	{
+		if ((*itemIter)->parent() == nullptr)
+		{
+			topLevelItems.append(*itemIter);
+
+			typeKey = (*itemIter)->uniqueKey();
+			if (!typeIndices.contains(typeKey))
+			{
+				typeIndices.insert(typeKey, typeKeys.size());
+				typeKeys.append(typeKey);
+			}
+		}
+	}
+
+	itemIds = fileItemIds(topLevelItems);
+	pointIndices = pointIndexMap(topLevelItems, itemIds);
+
+	// Item types are written once and then referred to by index
+	stream << typeKeys;
+	stream << (quint32)topLevelItems.size();
+
+	for(itemIndex = 0; itemIndex < topLevelItems.size(); itemIndex++)
+	{
+		DrawingItem* item = topLevelItems[itemIndex];
+		const QList<DrawingItemPoint*>& lPoints = item->points();
+
+		itemId = itemIds[itemIndex];
+		stream << (quint16)typeIndices.value(item->uniqueKey()) << itemId;
+		stream << (quint16)item->units() << item->pos() << (quint32)item->flags() << (quint16)item->placeType();
+		stream << item->isVisible() << item->rotationAngle() << item->isFlipped();
+
+		// Items whose style is not in the table carry their style properties with the others
+		styleId = (styles && !item->mStyleProperties.isEmpty()) ? styles->styleId(item->mStyleProperties) : -1;
+		stream << (qint32)styleId;
+		if (styleId >= 0)
+			writePropertiesToBinary(stream, item->mProperties);
+		else
+		{
+			properties = item->mProperties;
+			for(auto propertyIter = item->mStyleProperties.begin(); propertyIter != item->mStyleProperties.end(); propertyIter++)
+				properties.insert(propertyIter.key(), propertyIter.value());
+			writePropertiesToBinary(stream, properties);
+		}
+
+		stream << (quint32)lPoints.size();
+		for(pointIndex = 0; pointIndex < lPoints.size(); pointIndex++)
+		{
+			DrawingItemPoint* point = lPoints[pointIndex];
+
+			stream << point->pos() << (qint32)point->size() << (quint32)point->flags() << (qint32)point->category();
+
+			// Each connection is recorded once, from the end with the lower id
+			const DrawingItemPoint::TargetList& targets = point->targetList();
+			for(auto targetIter = targets.begin(); targetIter != targets.end(); targetIter++)
+			{
+				auto targetIndexIter = pointIndices.find(*targetIter);
+				if (targetIndexIter != pointIndices.end())
+				{
+					targetId = targetIndexIter.value().first;
+					targetPointIndex = targetIndexIter.value().second;
+					if (targetId > itemId || (targetId == itemId && targetPointIndex > pointIndex))
+						connections << itemId << (quint64)pointIndex << targetId << (quint64)targetPointIndex;
+				}
+			}
+		}
+
+		item->writeBinaryData(stream);
+
+		if (itemsWritten) itemsWritten->fetchAndAddRelaxed(1);
+	}
+
+	stream << connections;
+}
+
+QList<DrawingItem*> DrawingItem::readItemsFromBinary(QDataStream& stream, const DrawingStyleTable* styles)
+{
+	QList<DrawingItem*> items;
+	QHash<quint64, DrawingItem*> itemIds;
+	QStringList typeKeys;
+	QList<quint64> connections;
+	quint64 itemId;
+	quint32 numberOfItems, numberOfPoints;
+	quint16 typeIndex, units, placeType;
+	quint32 flags, pointFlags;
+	qint32 styleId, pointSize, pointCategory;
+	QPointF position, pointPosition;
+	bool visible, flipped;
+	qreal rotationAngle;
+	QHash<int, QVariant> properties;
+	QHash<int, QVariant> itemProperties;
+	DrawingItem* item;
+	DrawingItemPoint* point;
+
+	stream >> typeKeys;
+	stream >> numberOfItems;
+
+	for(quint32 i = 0; i < numberOfItems && stream.status() == QDataStream::Ok; i++)
+	{
+		stream >> typeIndex >> itemId;
+		stream >> units >> position >> flags >> placeType;
+		stream >> visible >> rotationAngle >> flipped;
+
+		// An item of an unknown type cannot be skipped, since its own data has no known size
+		item = DrawingView::itemFactory.create(typeKeys.value(typeIndex));
+		if (item == nullptr)
+		{
+			stream.setStatus(QDataStream::ReadCorruptData);
+			break;
+		}
+
+		item->mId = itemId;
+		itemIds.insert(itemId, item);
+
+		item->clearPoints();
+		item->setUnits((DrawingUnits)units);
+		item->setPos(position);
+		item->setFlags((Flags)flags);
+		item->setPlaceType((PlaceType)placeType);
+		item->setVisible(visible);
+		item->setRotationAngle(rotationAngle);
+		item->setFlipped(flipped);
+
+		stream >> styleId;
+		properties = (styles && styleId >= 0) ? styles->style(styleId) : QHash<int, QVariant>();
+		itemProperties = readPropertiesFromBinary(stream);
+		for(auto propertyIter = itemProperties.begin(); propertyIter != itemProperties.end(); propertyIter++)
+			properties.insert(propertyIter.key(), propertyIter.value());
+		if (!properties.isEmpty()) item->setPropertyValues(properties);
+
+		stream >> numberOfPoints;
+		for(quint32 j = 0; j < numberOfPoints && stream.status() == QDataStream::Ok; j++)
+		{
+			stream >> pointPosition >> pointSize >> pointFlags >> pointCategory;
+
+			point = new DrawingItemPoint(pointPosition, (DrawingItemPoint::Flags)pointFlags, pointCategory);
+			point->setSize(pointSize);
+			item->addPoint(point);
+		}
+
+		item->readBinaryData(stream);
+
+		items.append(item);
+	}
+
+	stream >> connections;
+
+	for(int i = 0; i + 3 < connections.size(); i += 4)
+	{
+		DrawingItem* startItem = itemIds.value(connections[i]);
+		DrawingItem* endItem = itemIds.value(connections[i+2]);
+
+		if (startItem && endItem && connections[i+1] < (quint64)startItem->numberOfPoints() &&
+			connections[i+3] < (quint64)endItem->numberOfPoints())
+		{
+			DrawingItemPoint* startPoint = startItem->point((int)connections[i+1]);
+			DrawingItemPoint* endPoint = endItem->point((int)connections[i+3]);
+
+			startPoint->addTarget(endPoint);
+			endPoint->addTarget(startPoint);
+		}
+	}
+
+	return items;
+}
+
+void DrawingItem::writePropertiesToBinary(QDataStream& stream, const QHash<int, QVariant>& properties)
+{
+	stream << (quint32)properties.size();
+
+	for(auto propertyIter = properties.begin(); propertyIter != properties.end(); propertyIter++)
+	{
+		// Only the standard ids are the same from one run to the next
+		stream << (qint32)propertyIter.key();
+		if (propertyIter.key() >= NumberOfStandardProperties) stream << propertyName(propertyIter.key());
+		stream << propertyIter.value();
+	}
+}
+
+QHash<int, QVariant> DrawingItem::readPropertiesFromBinary(QDataStream& stream)
+{
+	QHash<int, QVariant> properties;
+	quint32 numberOfProperties;
+	qint32 property;
+	QString name;
+	QVariant value;
+
+	stream >> numberOfProperties;
+
+	for(quint32 i = 0; i < numberOfProperties && stream.status() == QDataStream::Ok; i++)
+	{
+		stream >> property;
+		if (property >= NumberOfStandardProperties)
+		{
+			stream >> name;
+			property = propertyId(name);
+		}
+		stream >> value;
+
+		if (property >= 0) properties.insert(property, value);
+	}
+
+	return properties;
+}
@@ -57,13 +57,39 @@
  * writeXmlAttributes, readXmlAttributes, copy constructor
  * drawingItemChange (no need to overload itemChange, relevant changes are forwarded)
  *
- * Any item properties should be saved in derived class writeXmlAttributes, loaded in derived class readXmlAttributes
+ * Any item properties should be saved in derived class writeXmlAttributes, loaded in derived class readXmlAttributes (except for style properties, see below)
  * Any item children should be saved in derived class writeXmlChildElements, loaded in derived class readXmlChildElements
+ *
+ * Item Properties
+ * ===============
+ *
+ * Properties are stored by integer id rather than by name.  Names are interned through
+ * propertyId(), which assigns a new id the first time an unknown name is seen; the properties used
+ * by the standard items have the fixed ids in the Property enum.  Items should use the id-based
+ * functions on any path that runs per paint or per frame; the name-based functions are provided for
+ * the properties dialogs and file I/O.
+ *
+ * The pen, brush, font, and text color properties make up the item's style and are kept apart from
+ * its other properties.  A DrawingScene shares one copy of each distinct style between all of its
+ * items that use it (see DrawingStyleTable), and items of the same style are drawn together where
+ * the stacking order allows.  The style properties are saved and loaded by writeItemsToXml and
+ * readItemsFromXml rather than by the derived classes.
+ *
+ * Binary Files
+ * ============
+ *
+ * writeItemsToBinary and readItemsFromBinary save the item's position, transform, points,
+ * properties, and connections without converting any of them to text.  Property values are stored
+ * as QVariants under their ids, so new standard properties must be added to the end of the
+ * Property enum; other properties are stored together with their names.  Items with state beyond
+ * their properties and points should also override writeBinaryData and readBinaryData.
  */
 class DrawingItem
 {
 	friend class DrawingScene;
 	friend class DrawingView;
+	friend class DrawingItemPoint;
+	friend class DrawingSnapshot;
 
 public:
 	enum Flag { CanMove = 0x01, CanRotate = 0x02, CanFlip = 0x04, CanResize = 0x08,
@@ -75,8 +101,21 @@ public:
 	enum Reason { PositionChange, UnitsChange, SelectedChange, VisibleChange, PropertyChange,
 				  AddNewItemToScene, UserChange };
 
+	enum Property { PenColorProperty, PenWidthProperty, PenStyleProperty, PenCapStyleProperty,
+		PenJoinStyleProperty, BrushColorProperty, CornerXRadiusProperty, CornerYRadiusProperty,
+		StartArrowStyleProperty, StartArrowSizeProperty, EndArrowStyleProperty, EndArrowSizeProperty,
+		FontFamilyProperty, FontSizeProperty, FontBoldProperty, FontItalicProperty,
+		FontUnderlineProperty, FontOverlineProperty, FontStrikeOutProperty,
+		TextHorizontalAlignmentProperty, TextVerticalAlignmentProperty, TextColorProperty,
+		CaptionProperty, ImageProperty, NumberOfStandardProperties };
+
+	// Maps each point of a list of items to a reference to its item (an id or an index into the
+	// list) and its own index within the item
+	typedef QHash<DrawingItemPoint*, QPair<quint64,int> > PointIndexMap;
+
 private:
 	DrawingScene* mScene;
+	quint64 mId;
 
 	QPointF mPosition;
 	DrawingUnits mUnits;
@@ -87,7 +126,9 @@ private:
 	QList<DrawingItemPoint*> mPoints;
 	DrawingItemPoint* mSelectedPoint;
 
-	QHash<QString, QVariant> mProperties;
+	QHash<int, QVariant> mProperties;
+	QHash<int, QVariant> mStyleProperties;
+	int mStyleId;
 
 	QList<DrawingItem*> mChildren;
 	DrawingItem* mParent;
@@ -98,6 +139,16 @@ private:
 	qreal mRotationAngle;
 	bool mFlipped;
 
+	mutable QTransform mSceneTransform;
+	mutable QTransform mSceneInverseTransform;
+	mutable QRectF mSceneBoundingRect;
+	mutable bool mSceneTransformValid;
+	mutable bool mSceneBoundingRectValid;
+
+	mutable QPainterPath mShapeCachePath;
+	mutable QPen mShapeCachePen;
+	mutable QPainterPath mShapeCache;
+
 public:
 	DrawingItem();
 	DrawingItem(const DrawingItem& item);
@@ -108,6 +159,7 @@ public:
 
 	DrawingScene* scene() const;
 	DrawingView* view() const;
+	quint64 id() const;
 
 	// Selectors
 	void setPos(const QPointF& parentPos);
@@ -135,26 +187,39 @@ public:
 	PlaceType placeType() const;
 
 	// Properties
+	void addProperty(int property, const QVariant& value);
 	void addProperty(const QString& property, const QVariant& value);
+	void removeProperty(int property);
 	void removeProperty(const QString& property);
 	void clearProperties();
 	int numberOfProperties() const;
+	bool containsProperty(int property) const;
 	bool containsProperty(const QString& property) const;
 	QStringList propertiesList() const;
 	QList<QVariant> propertyValues() const;
 
+	void setPropertyValue(int property, const QVariant& value);
 	void setPropertyValue(const QString& property, const QVariant& value);
+	void setPropertyValues(const QHash<int, QVariant>& values);
+	void setPropertyValues(const QHash<QString, QVariant>& values);
+	QVariant propertyValue(int property) const;
 	QVariant propertyValue(const QString& property) const;
 
 	void setProperties(const QHash<QString, QVariant>& properties);
 	QHash<QString, QVariant> properties() const;
 
+	const QHash<int, QVariant>& styleProperties() const;
+
+	static int propertyId(const QString& name);
+	static QString propertyName(int property);
+	static bool isStyleProperty(int property);
+
 	// Points
 	void addPoint(DrawingItemPoint* itemPoint);
 	void insertPoint(int index, DrawingItemPoint* itemPoint);
 	void removePoint(DrawingItemPoint* itemPoint);
 	void clearPoints();
-	QList<DrawingItemPoint*> points() const;
+	const QList<DrawingItemPoint*>& points() const;
 	int numberOfPoints() const;
 	bool containsPoint(DrawingItemPoint* itemPoint) const;
 	DrawingItemPoint* point(int index) const;
@@ -170,7 +235,7 @@ public:
 	void insertChild(int index, DrawingItem* child);
 	void removeChild(DrawingItem* child);
 	void clearChildren();
-	QList<DrawingItem*> children() const;
+	const QList<DrawingItem*>& children() const;
 	int numberOfChildren() const;
 	bool containsChild(DrawingItem* child) const;
 	DrawingItem* child(int index) const;
@@ -199,9 +264,14 @@ public:
 	QRectF mapToScene(const QRectF& itemRect) const;
 	QRectF mapFromScene(const QRectF& sceneRect) const;
 
+	QTransform sceneTransform() const;
+	QRectF sceneBoundingRect() const;
+
 	// Description
 	virtual QRectF boundingRect() const = 0;
 	virtual QPainterPath shape() const;
+	virtual bool shapeContains(const QPointF& itemPos) const;
+	virtual bool shapeIntersects(const QRectF& itemRect) const;
 	virtual QPointF centerPos() const;
 	virtual bool isSuperfluous() const;
 
@@ -232,24 +302,46 @@ protected:
 	virtual void changedEvent(Reason reason, const QVariant& value);
 
 	virtual void writeXmlAttributes(QXmlStreamWriter& xmlWriter, const QList<DrawingItem*>& items);
-	virtual void writeXmlChildElements(QXmlStreamWriter& xmlWriter, const QList<DrawingItem*>& items);
+	virtual void writeXmlChildElements(QXmlStreamWriter& xmlWriter, const QList<DrawingItem*>& items,
+		const PointIndexMap& pointIndices);
 	virtual void readXmlAttributes(QXmlStreamReader& xmlReader, const QList<DrawingItem*>& items);
-	virtual void readXmlChildElement(QXmlStreamReader& xmlReader, const QList<DrawingItem*>& items);
+	virtual void readXmlChildElement(QXmlStreamReader& xmlReader, const QHash<quint64, DrawingItem*>& items);
+
+	virtual void writeBinaryData(QDataStream& stream);
+	virtual void readBinaryData(QDataStream& stream);
 
 protected:
 	void setupPainter(QPainter* painter, const DrawingStyleOptions& styleOptions,
 		const QPen& itemPen, const QBrush& itemBrush = Qt::transparent);
 	QPainterPath itemShapeFromPath(const QPainterPath& path, const QPen& pen, bool adjustOutline = true) const;
+	qreal itemOutlineWidth(const QPen& pen, bool adjustOutline = true) const;
 	qreal adjustOutlineForView(qreal penWidth) const;
+	void invalidateGeometry();
 	void adjustReferencePoint();
 
 	DrawingItem& operator=(const DrawingItem& item);
 
+private:
+	void invalidateSceneGeometry();
+	void updateSceneTransform() const;
+
 public:
 	static QList<DrawingItem*> copyItems(const QList<DrawingItem*>& items);
+	static QList<quint64> fileItemIds(const QList<DrawingItem*>& items);
+	static PointIndexMap pointIndexMap(const QList<DrawingItem*>& items, const QList<quint64>& itemIds);
+
+	static void writeItemsToXml(QXmlStreamWriter& xmlWriter, const QList<DrawingItem*>& items,
+		const DrawingStyleTable* styles = nullptr, QAtomicInt* itemsWritten = nullptr);
+	static QList<DrawingItem*> readItemsFromXml(QXmlStreamReader& xmlReader,
+		const DrawingStyleTable* styles = nullptr);
+
+	static void writeItemsToBinary(QDataStream& stream, const QList<DrawingItem*>& items,
+		const DrawingStyleTable* styles = nullptr, QAtomicInt* itemsWritten = nullptr);
+	static QList<DrawingItem*> readItemsFromBinary(QDataStream& stream,
+		const DrawingStyleTable* styles = nullptr);
 
-	static void writeItemsToXml(QXmlStreamWriter& xmlWriter, const QList<DrawingItem*>& items);
-	static QList<DrawingItem*> readItemsFromXml(QXmlStreamReader& xmlReader);
+	static void writePropertiesToBinary(QDataStream& stream, const QHash<int, QVariant>& properties);
+	static QHash<int, QVariant> readPropertiesFromBinary(QDataStream& stream);
 };
 
 Q_DECLARE_OPERATORS_FOR_FLAGS(DrawingItem::Flags)
@@ -145,19 +145,36 @@ void DrawingItemGroup::render(QPainter* painter, const DrawingStyleOptions& styl
 	painter->drawPath(shape());
 #endif
 
-	for(auto itemIter = mItems.begin(); itemIter != mItems.end(); itemIter++)
+	// Only render the items that overlap the area being painted
+	QRectF exposedRect = painter->worldTransform().inverted().mapRect(
+		QRectF(0, 0, painter->device()->width(), painter->device()->height()));
+	if (painter->hasClipping()) exposedRect = exposedRect.intersected(painter->clipBoundingRect());
+
+	bool itemRectsStale = false;
+
+	if (mItemRects.size() != mItems.size()) updateItemRects();
+
+	for(int itemIndex = 0; itemIndex < mItems.size(); itemIndex++)
 	{
-		if ((*itemIter)->isVisible())
+		DrawingItem* item = mItems[itemIndex];
+		QRectF itemRect = mItemRects[itemIndex];
+
+		if (item->isVisible() && (!itemRect.isValid() || exposedRect.intersects(itemRect)))
 		{
-			qreal scaleFactor = Drawing::unitsScale((*itemIter)->units(), units());
+			qreal scaleFactor = Drawing::unitsScale(item->units(), units());
 
 			painter->save();
-			painter->translate((*itemIter)->pos());
+			painter->translate(item->pos());
 			painter->scale(scaleFactor, scaleFactor);
-			(*itemIter)->render(painter, styleOptions);
+			item->render(painter, styleOptions);
 			painter->restore();
+
+			// Items such as text only know their bounds once they have been rendered
+			if (!itemRect.isValid()) itemRectsStale = true;
 		}
 	}
+
+	if (itemRectsStale) mItemRects.clear();
 }
 
 //==================================================================================================
@@ -204,6 +221,7 @@ QVariant DrawingItemGroup::aboutToChangeEvent(Reason reason, const QVariant& val
 		{
 			for(auto itemIter = mItems.begin(); itemIter != mItems.end(); itemIter++)
 				(*itemIter)->setPos((*itemIter)->pos() * scaleFactor);
+			mItemRects.clear();
 		}
 	}
 
@@ -212,16 +230,17 @@ QVariant DrawingItemGroup::aboutToChangeEvent(Reason reason, const QVariant& val
 
 //==================================================================================================
 
-void DrawingItemGroup::writeXmlChildElements(QXmlStreamWriter& xmlWriter, const QList<DrawingItem*>& items)
+void DrawingItemGroup::writeXmlChildElements(QXmlStreamWriter& xmlWriter, const QList<DrawingItem*>& items,
+	const PointIndexMap& pointIndices)
 {
-	DrawingItem::writeXmlChildElements(xmlWriter, items);
+	DrawingItem::writeXmlChildElements(xmlWriter, items, pointIndices);
 
 	xmlWriter.writeStartElement("items");
 	DrawingItem::writeItemsToXml(xmlWriter, mItems);
 	xmlWriter.writeEndElement();
 }
 
-void DrawingItemGroup::readXmlChildElement(QXmlStreamReader& xmlReader, const QList<DrawingItem*>& items)
+void DrawingItemGroup::readXmlChildElement(QXmlStreamReader& xmlReader, const QHash<quint64, DrawingItem*>& items)
 {
 	if (xmlReader.name() == "items")
 		mItems = DrawingItem::readItemsFromXml(xmlReader);
@@ -229,6 +248,18 @@ void DrawingItemGroup::readXmlChildElement(QXmlStreamReader& xmlReader, const QL
 		DrawingItem::readXmlChildElement(xmlReader, items);
 }
 
+void DrawingItemGroup::writeBinaryData(QDataStream& stream)
+{
+	DrawingItem::writeBinaryData(stream);
+	DrawingItem::writeItemsToBinary(stream, mItems);
+}
+
+void DrawingItemGroup::readBinaryData(QDataStream& stream)
+{
+	DrawingItem::readBinaryData(stream);
+	mItems = DrawingItem::readItemsFromBinary(stream);
+}
+
 //==================================================================================================
 
 void DrawingItemGroup::updatePoints()
@@ -238,6 +269,8 @@ void DrawingItemGroup::updatePoints()
 	DrawingItemPoint* leftPoint;
 	DrawingItemPoint* rightPoint;
 
+	mItemRects.clear();
+
 	itemPoint = cornerPoint(Qt::TopLeftCorner);
 	if (itemPoint) itemPoint->setPos(rect.topLeft());
 	itemPoint = cornerPoint(Qt::BottomRightCorner);
@@ -260,6 +293,32 @@ void DrawingItemGroup::updatePoints()
 	if (itemPoint && leftPoint && rightPoint) itemPoint->setPos((leftPoint->pos() + rightPoint->pos()) / 2);
 }
 
+void DrawingItemGroup::updateItemRects()
+{
+	// Cache the area covered by each item in group coordinates, including the item's outline.  An
+	// invalid rect means the item's bounds are not yet known and it should always be rendered.
+	QRectF itemRect;
+	qreal scaleFactor;
+
+	mItemRects.clear();
+
+	for(auto itemIter = mItems.begin(); itemIter != mItems.end(); itemIter++)
+	{
+		itemRect = (*itemIter)->boundingRect();
+
+		if (itemRect.isValid())
+		{
+			scaleFactor = Drawing::unitsScale((*itemIter)->units(), units());
+
+			itemRect = Drawing::adjustRectForMinimumSize(itemRect.united((*itemIter)->shape().boundingRect()));
+			itemRect = QRectF(itemRect.topLeft() * scaleFactor + (*itemIter)->pos(),
+				itemRect.bottomRight() * scaleFactor + (*itemIter)->pos());
+		}
+
+		mItemRects.append(itemRect);
+	}
+}
+
 DrawingItemPoint* DrawingItemGroup::cornerPoint(Qt::Corner corner) const
 {
 	DrawingItemPoint* itemPoint = nullptr;
@@ -27,6 +27,7 @@ class DrawingItemGroup : public DrawingItem
 {
 private:
 	QList<DrawingItem*> mItems;
+	QList<QRectF> mItemRects;
 
 public:
 	DrawingItemGroup();
@@ -57,10 +58,15 @@ public:
 protected:
 	virtual QVariant aboutToChangeEvent(Reason reason, const QVariant& value);
 
-	virtual void writeXmlChildElements(QXmlStreamWriter& xmlWriter, const QList<DrawingItem*>& items);
-	virtual void readXmlChildElement(QXmlStreamReader& xmlReader, const QList<DrawingItem*>& items);
+	virtual void writeXmlChildElements(QXmlStreamWriter& xmlWriter, const QList<DrawingItem*>& items,
+		const PointIndexMap& pointIndices);
+	virtual void readXmlChildElement(QXmlStreamReader& xmlReader, const QHash<quint64, DrawingItem*>& items);
+
+	virtual void writeBinaryData(QDataStream& stream);
+	virtual void readBinaryData(QDataStream& stream);
 
 	void updatePoints();
+	void updateItemRects();
 	DrawingItemPoint* cornerPoint(Qt::Corner corner) const;
 };
 
@@ -0,0 +1,314 @@
+/* DrawingItemOrder.cpp
+ *
+ * Copyright (C) 2013-2014 Jason Allen
+ *
+ * This file is part of the Jade Diagram Editor.
+ *
+ * Jade is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Jade is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Jade.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <DrawingItemOrder.h>
+
+DrawingItemOrder::DrawingItemOrder()
+{
+	mRoot = -1;
+	mFreeList = -1;
+	mSeed = 2463534242u;
+	mItemsValid = true;
+}
+
+DrawingItemOrder::~DrawingItemOrder() { }
+
+//==================================================================================================
+
+void DrawingItemOrder::appendItem(DrawingItem* item)
+{
+	insertItem(numberOfItems(), item);
+}
+
+void DrawingItemOrder::insertItem(int index, DrawingItem* item)
+{
+	if (item && !mItemNodes.contains(item))
+	{
+		int node = allocateNode(item);
+		int left, right;
+
+		// Same behavior as QList::insert for out-of-range indices
+		if (index < 0) index = 0;
+		if (index > numberOfItems()) index = numberOfItems();
+
+		split(mRoot, index, left, right);
+		mRoot = merge(merge(left, node), right);
+		mNodes[mRoot].parent = -1;
+
+		mItemNodes.insert(item, node);
+		mItemsValid = false;
+	}
+}
+
+void DrawingItemOrder::removeItem(DrawingItem* item)
+{
+	auto nodeIter = mItemNodes.find(item);
+
+	if (nodeIter != mItemNodes.end())
+	{
+		int node = nodeIter.value();
+		int parent = mNodes[node].parent;
+		int children = merge(mNodes[node].left, mNodes[node].right);
+
+		// The merged children take the removed node's place under its parent
+		if (children >= 0) mNodes[children].parent = parent;
+
+		if (parent < 0) mRoot = children;
+		else if (mNodes[parent].left == node) mNodes[parent].left = children;
+		else mNodes[parent].right = children;
+
+		for(int index = parent; index >= 0; index = mNodes[index].parent)
+			updateSize(index);
+
+		mItemNodes.erase(nodeIter);
+		freeNode(node);
+		mItemsValid = false;
+	}
+}
+
+void DrawingItemOrder::setItems(const QList<DrawingItem*>& items)
+{
+	clear();
+	for(auto itemIter = items.begin(); itemIter != items.end(); itemIter++)
+		appendItem(*itemIter);
+}
+
+void DrawingItemOrder::clear()
+{
+	mNodes.clear();
+	mItemNodes.clear();
+	mRoot = -1;
+	mFreeList = -1;
+
+	mItems.clear();
+	mItemsValid = true;
+}
+
+//==================================================================================================
+
+bool DrawingItemOrder::containsItem(DrawingItem* item) const
+{
+	return mItemNodes.contains(item);
+}
+
+int DrawingItemOrder::itemIndex(DrawingItem* item) const
+{
+	int index = -1;
+
+	auto nodeIter = mItemNodes.find(item);
+	if (nodeIter != mItemNodes.end())
+	{
+		int node = nodeIter.value();
+		int parent = mNodes[node].parent;
+
+		// Count everything that comes before the node on the way up to the root
+		index = subtreeSize(mNodes[node].left);
+		while (parent >= 0)
+		{
+			if (mNodes[parent].right == node) index += subtreeSize(mNodes[parent].left) + 1;
+
+			node = parent;
+			parent = mNodes[node].parent;
+		}
+	}
+
+	return index;
+}
+
+DrawingItem* DrawingItemOrder::item(int index) const
+{
+	DrawingItem* item = nullptr;
+	int node = mRoot;
+	int leftSize;
+
+	if (0 <= index && index < numberOfItems())
+	{
+		while (node >= 0 && item == nullptr)
+		{
+			leftSize = subtreeSize(mNodes[node].left);
+
+			if (index < leftSize) node = mNodes[node].left;
+			else if (index == leftSize) item = mNodes[node].item;
+			else
+			{
+				index -= leftSize + 1;
+				node = mNodes[node].right;
+			}
+		}
+	}
+
+	return item;
+}
+
+int DrawingItemOrder::numberOfItems() const
+{
+	return mItemNodes.size();
+}
+
+//==================================================================================================
+
+const QList<DrawingItem*>& DrawingItemOrder::items() const
+{
+	if (!mItemsValid)
+	{
+		QVarLengthArray<int,64> nodesToVisit;
+		int node = mRoot;
+
+		mItems.clear();
+		mItems.reserve(numberOfItems());
+
+		// In-order traversal
+		while (node >= 0 || !nodesToVisit.isEmpty())
+		{
+			while (node >= 0)
+			{
+				nodesToVisit.append(node);
+				node = mNodes[node].left;
+			}
+
+			node = nodesToVisit.last();
+			nodesToVisit.removeLast();
+
+			mItems.append(mNodes[node].item);
+			node = mNodes[node].right;
+		}
+
+		mItemsValid = true;
+	}
+
+	return mItems;
+}
+
+//==================================================================================================
+
+int DrawingItemOrder::allocateNode(DrawingItem* item)
+{
+	int index;
+
+	if (mFreeList >= 0)
+	{
+		index = mFreeList;
+		mFreeList = mNodes[index].parent;
+	}
+	else
+	{
+		index = mNodes.size();
+		mNodes.append(Node());
+	}
+
+	// xorshift32
+	mSeed ^= mSeed << 13;
+	mSeed ^= mSeed >> 17;
+	mSeed ^= mSeed << 5;
+
+	Node& node = mNodes[index];
+	node.item = item;
+	node.priority = mSeed;
+	node.size = 1;
+	node.parent = -1;
+	node.left = -1;
+	node.right = -1;
+
+	return index;
+}
+
+void DrawingItemOrder::freeNode(int index)
+{
+	mNodes[index].item = nullptr;
+	mNodes[index].size = 0;
+	mNodes[index].parent = mFreeList;
+	mNodes[index].left = -1;
+	mNodes[index].right = -1;
+	mFreeList = index;
+}
+
+//==================================================================================================
+
+int DrawingItemOrder::merge(int left, int right)
+{
+	// Concatenates two trees, keeping the node with the highest priority at the root
+	int root = -1;
+	int child;
+
+	if (left < 0) root = right;
+	else if (right < 0) root = left;
+	else if (mNodes[left].priority > mNodes[right].priority)
+	{
+		child = merge(mNodes[left].right, right);
+		mNodes[left].right = child;
+		mNodes[child].parent = left;
+		updateSize(left);
+		root = left;
+	}
+	else
+	{
+		child = merge(left, mNodes[right].left);
+		mNodes[right].left = child;
+		mNodes[child].parent = right;
+		updateSize(right);
+		root = right;
+	}
+
+	return root;
+}
+
+void DrawingItemOrder::split(int index, int count, int& left, int& right)
+{
+	// Splits a tree so that its first count nodes end up in left and the remainder in right
+	int subtreeLeft, subtreeRight;
+
+	if (index < 0)
+	{
+		left = -1;
+		right = -1;
+	}
+	else if (subtreeSize(mNodes[index].left) < count)
+	{
+		split(mNodes[index].right, count - subtreeSize(mNodes[index].left) - 1, subtreeLeft, subtreeRight);
+
+		mNodes[index].right = subtreeLeft;
+		if (subtreeLeft >= 0) mNodes[subtreeLeft].parent = index;
+		updateSize(index);
+
+		left = index;
+		right = subtreeRight;
+	}
+	else
+	{
+		split(mNodes[index].left, count, subtreeLeft, subtreeRight);
+
+		mNodes[index].left = subtreeRight;
+		if (subtreeRight >= 0) mNodes[subtreeRight].parent = index;
+		updateSize(index);
+
+		left = subtreeLeft;
+		right = index;
+	}
+}
+
+void DrawingItemOrder::updateSize(int index)
+{
+	mNodes[index].size = subtreeSize(mNodes[index].left) + subtreeSize(mNodes[index].right) + 1;
+}
+
+int DrawingItemOrder::subtreeSize(int index) const
+{
+	return (index >= 0) ? mNodes[index].size : 0;
+}
@@ -0,0 +1,87 @@
+/* DrawingItemOrder.h
+ *
+ * Copyright (C) 2013-2014 Jason Allen
+ *
+ * This file is part of the Jade Diagram Editor.
+ *
+ * Jade is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Jade is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Jade.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef DRAWINGITEMORDER_H
+#define DRAWINGITEMORDER_H
+
+#include <DrawingGlobals.h>
+
+/* The DrawingItemOrder class is an ordered set of items.  DrawingScene uses it for both the
+ * stacking order of its items and the order in which items were selected.
+ *
+ * Items are stored in a randomized balanced binary tree (a treap) keyed implicitly by position,
+ * where each node records the size of its subtree.  Membership is tested through a hash, and
+ * inserting, removing, or finding the index of an item takes O(log n) expected time.
+ *
+ * The items are also available as a flat list in order.  This list is rebuilt on demand after
+ * the order changes, so code that only iterates over the items does not pay for the tree.  The
+ * reference returned by items() is only valid until the order is changed.
+ */
+class DrawingItemOrder
+{
+private:
+	struct Node
+	{
+		DrawingItem* item;
+		quint32 priority;
+		int size;
+		int parent;
+		int left;
+		int right;
+	};
+
+	QVector<Node> mNodes;
+	int mRoot;
+	int mFreeList;
+	quint32 mSeed;
+
+	QHash<DrawingItem*,int> mItemNodes;
+
+	mutable QList<DrawingItem*> mItems;
+	mutable bool mItemsValid;
+
+public:
+	DrawingItemOrder();
+	~DrawingItemOrder();
+
+	void appendItem(DrawingItem* item);
+	void insertItem(int index, DrawingItem* item);
+	void removeItem(DrawingItem* item);
+	void setItems(const QList<DrawingItem*>& items);
+	void clear();
+
+	bool containsItem(DrawingItem* item) const;
+	int itemIndex(DrawingItem* item) const;
+	DrawingItem* item(int index) const;
+	int numberOfItems() const;
+
+	const QList<DrawingItem*>& items() const;
+
+private:
+	int allocateNode(DrawingItem* item);
+	void freeNode(int index);
+
+	int merge(int left, int right);
+	void split(int index, int count, int& left, int& right);
+	void updateSize(int index);
+	int subtreeSize(int index) const;
+};
+
+#endif
@@ -67,6 +67,7 @@ DrawingItem* DrawingItemPoint::item() const
 void DrawingItemPoint::setPos(const QPointF& pos)
 {
 	mPosition = pos;
+	if (mItem) mItem->invalidateGeometry();
 }
 
 void DrawingItemPoint::setPos(qreal x, qreal y)
@@ -116,6 +117,7 @@ int DrawingItemPoint::size() const
 void DrawingItemPoint::setFlags(Flags flags)
 {
 	mFlags = flags;
+	if (mItem) mItem->invalidateGeometry();
 }
 
 DrawingItemPoint::Flags DrawingItemPoint::flags() const
@@ -159,7 +161,13 @@ void DrawingItemPoint::addTarget(DrawingItemPoint* point)
 
 void DrawingItemPoint::removeTarget(DrawingItemPoint* point)
 {
-	if (point) mTargets.removeAll(point);
+	if (point)
+	{
+		for(int i = mTargets.size() - 1; i >= 0; i--)
+		{
+			if (mTargets[i] == point) mTargets.remove(i);
+		}
+	}
 }
 
 void DrawingItemPoint::clearTargets()
@@ -168,7 +176,7 @@ void DrawingItemPoint::clearTargets()
 
 	while (numberOfTargets() > 0)
 	{
-		point = mTargets.first();
+		point = mTargets[0];
 
 		removeTarget(point);
 		point->removeTarget(this);
@@ -176,6 +184,17 @@ void DrawingItemPoint::clearTargets()
 }
 
 QList<DrawingItemPoint*> DrawingItemPoint::targets() const
+{
+	QList<DrawingItemPoint*> targets;
+
+	targets.reserve(mTargets.size());
+	for(auto pointIter = mTargets.begin(); pointIter != mTargets.end(); pointIter++)
+		targets.append(*pointIter);
+
+	return targets;
+}
+
+const DrawingItemPoint::TargetList& DrawingItemPoint::targetList() const
 {
 	return mTargets;
 }
@@ -187,7 +206,15 @@ int DrawingItemPoint::numberOfTargets() const
 
 bool DrawingItemPoint::isTarget(DrawingItemPoint* point) const
 {
-	return (point) ? mTargets.contains(point) : false;
+	bool target = false;
+
+	if (point)
+	{
+		for(auto pointIter = mTargets.begin(); !target && pointIter != mTargets.end(); pointIter++)
+			target = (*pointIter == point);
+	}
+
+	return target;
 }
 
 bool DrawingItemPoint::isTarget(DrawingItem* item) const
@@ -233,6 +260,17 @@ QRectF DrawingItemPoint::itemRect() const
 
 //==================================================================================================
 
+qreal DrawingItemPoint::connectionThreshold(DrawingItemPlaceMode placeMode) const
+{
+	qreal threshold = 0.001;
+	DrawingScene* scene = (mItem) ? mItem->scene() : nullptr;
+
+	//if (scene && placeMode == PlaceLoose) threshold = scene->grid() / 2;
+	if (scene && placeMode == PlaceLoose) threshold = scene->grid() / 4;
+
+	return threshold;
+}
+
 bool DrawingItemPoint::shouldConnect(DrawingItemPoint* otherItemPoint, DrawingItemPlaceMode placeMode) const
 {
 	// Assume both points are members of different items in the same scene
@@ -241,8 +279,7 @@ bool DrawingItemPoint::shouldConnect(DrawingItemPoint* otherItemPoint, DrawingIt
 
 	if (scene && placeMode != DoNotPlace)
 	{
-		//qreal threshold = (placeMode == PlaceLoose) ? scene->grid() / 2 : 0.001;
-		qreal threshold = (placeMode == PlaceLoose) ? scene->grid() / 4 : 0.001;
+		qreal threshold = connectionThreshold(placeMode);
 		qreal distance = Drawing::magnitude(mItem->mapToScene(pos()) -
 			otherItemPoint->item()->mapToScene(otherItemPoint->pos()));
 
@@ -263,6 +300,31 @@ bool DrawingItemPoint::shouldDisconnect(DrawingItemPoint* otherItemPoint) const
 
 //==================================================================================================
 
+QList<DrawingItemPoint*> DrawingItemPoint::connectionCandidates(DrawingItemPlaceMode placeMode) const
+{
+	// Returns the connection points of other items in the scene that are close enough to this
+	// point to pass the distance test in shouldConnect()
+	QList<DrawingItemPoint*> candidates;
+	DrawingScene* scene = (mItem) ? mItem->scene() : nullptr;
+
+	if (scene && placeMode != DoNotPlace && isConnectionPoint())
+	{
+		qreal threshold = connectionThreshold(placeMode);
+		QPointF scenePos = mItem->mapToScene(pos());
+		QList<DrawingItemPoint*> scenePoints = scene->connectionPoints(QRectF(
+			scenePos.x() - threshold, scenePos.y() - threshold, 2 * threshold, 2 * threshold));
+
+		for(auto pointIter = scenePoints.begin(); pointIter != scenePoints.end(); pointIter++)
+		{
+			if ((*pointIter)->item() != mItem) candidates.append(*pointIter);
+		}
+	}
+
+	return candidates;
+}
+
+//==================================================================================================
+
 DrawingItemPoint& DrawingItemPoint::operator=(const DrawingItemPoint& point)
 {
 	mItem = nullptr;
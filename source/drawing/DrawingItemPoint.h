@@ -47,6 +47,10 @@ public:
 	enum Flag { Control = 0x01, Connection = 0x02, Free = 0x04 };
 	Q_DECLARE_FLAGS(Flags, Flag)
 
+	// Most points have at most a couple of targets, which are stored inline without a separate
+	// heap allocation
+	typedef QVarLengthArray<DrawingItemPoint*,2> TargetList;
+
 private:
 	DrawingItem* mItem;
 
@@ -55,7 +59,7 @@ private:
 	int mCategory;
 	Flags mFlags;
 
-	QList<DrawingItemPoint*> mTargets;
+	TargetList mTargets;
 
 public:
 	DrawingItemPoint(const QPointF& position = QPointF(), Flags flags = Control, int category = 0);
@@ -92,6 +96,7 @@ public:
 	void removeTarget(DrawingItemPoint* itemPoint);
 	void clearTargets();
 	QList<DrawingItemPoint*> targets() const;
+	const TargetList& targetList() const;
 	int numberOfTargets() const;
 	bool isTarget(DrawingItemPoint* itemPoint) const;
 	bool isTarget(DrawingItem* item) const;
@@ -101,9 +106,12 @@ public:
 	virtual QRectF sceneRect() const;
 	virtual QRectF itemRect() const;
 
+	virtual qreal connectionThreshold(DrawingItemPlaceMode placeMode) const;
 	virtual bool shouldConnect(DrawingItemPoint* otherItemPoint, DrawingItemPlaceMode placeMode) const;
 	virtual bool shouldDisconnect(DrawingItemPoint* otherItemPoint) const;
 
+	QList<DrawingItemPoint*> connectionCandidates(DrawingItemPlaceMode placeMode) const;
+
 	DrawingItemPoint& operator=(const DrawingItemPoint& other);
 };
 
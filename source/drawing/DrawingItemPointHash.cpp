@@ -0,0 +1,151 @@
+/* DrawingItemPointHash.cpp
+ *
+ * Copyright (C) 2013-2014 Jason Allen
+ *
+ * This file is part of the Jade Diagram Editor.
+ *
+ * Jade is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Jade is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Jade.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <DrawingItemPointHash.h>
+
+DrawingItemPointHash::DrawingItemPointHash(qreal cellSize)
+{
+	mCellSize = (cellSize > 0) ? cellSize : 1.0;
+}
+
+DrawingItemPointHash::~DrawingItemPointHash() { }
+
+//==================================================================================================
+
+void DrawingItemPointHash::setCellSize(qreal cellSize)
+{
+	if (cellSize <= 0) cellSize = 1.0;
+
+	if (cellSize != mCellSize)
+	{
+		QHash<DrawingItemPoint*, QPointF> positions = mPositions;
+
+		clear();
+		mCellSize = cellSize;
+
+		for(auto pointIter = positions.begin(); pointIter != positions.end(); pointIter++)
+			insertPoint(pointIter.key(), pointIter.value());
+	}
+}
+
+qreal DrawingItemPointHash::cellSize() const
+{
+	return mCellSize;
+}
+
+//==================================================================================================
+
+void DrawingItemPointHash::insertPoint(DrawingItemPoint* itemPoint, const QPointF& scenePos)
+{
+	if (itemPoint)
+	{
+		removePoint(itemPoint);
+
+		mCells[cellKey(cellCoordinate(scenePos.x()), cellCoordinate(scenePos.y()))].append(itemPoint);
+		mPositions.insert(itemPoint, scenePos);
+	}
+}
+
+void DrawingItemPointHash::removePoint(DrawingItemPoint* itemPoint)
+{
+	// The point may already have been deleted, so it must not be dereferenced here
+	auto positionIter = mPositions.find(itemPoint);
+
+	if (positionIter != mPositions.end())
+	{
+		quint64 key = cellKey(cellCoordinate(positionIter.value().x()), cellCoordinate(positionIter.value().y()));
+		auto cellIter = mCells.find(key);
+
+		if (cellIter != mCells.end())
+		{
+			cellIter.value().removeOne(itemPoint);
+			if (cellIter.value().isEmpty()) mCells.erase(cellIter);
+		}
+
+		mPositions.erase(positionIter);
+	}
+}
+
+void DrawingItemPointHash::clear()
+{
+	mCells.clear();
+	mPositions.clear();
+}
+
+//==================================================================================================
+
+bool DrawingItemPointHash::containsPoint(DrawingItemPoint* itemPoint) const
+{
+	return mPositions.contains(itemPoint);
+}
+
+int DrawingItemPointHash::numberOfPoints() const
+{
+	return mPositions.size();
+}
+
+//==================================================================================================
+
+QList<DrawingItemPoint*> DrawingItemPointHash::points(const QRectF& sceneRect) const
+{
+	QList<DrawingItemPoint*> points;
+	QRectF rect = sceneRect.normalized();
+	QPointF scenePos;
+
+	qint32 left = cellCoordinate(rect.left());
+	qint32 top = cellCoordinate(rect.top());
+	qint32 right = cellCoordinate(rect.right());
+	qint32 bottom = cellCoordinate(rect.bottom());
+
+	for(qint32 row = top; row <= bottom; row++)
+	{
+		for(qint32 column = left; column <= right; column++)
+		{
+			auto cellIter = mCells.find(cellKey(column, row));
+			if (cellIter != mCells.end())
+			{
+				const QList<DrawingItemPoint*>& cellPoints = cellIter.value();
+				for(auto pointIter = cellPoints.begin(); pointIter != cellPoints.end(); pointIter++)
+				{
+					scenePos = mPositions.value(*pointIter);
+					if (rect.left() <= scenePos.x() && scenePos.x() <= rect.right() &&
+						rect.top() <= scenePos.y() && scenePos.y() <= rect.bottom())
+					{
+						points.append(*pointIter);
+					}
+				}
+			}
+		}
+	}
+
+	return points;
+}
+
+//==================================================================================================
+
+qint32 DrawingItemPointHash::cellCoordinate(qreal value) const
+{
+	return (qint32)qFloor(value / mCellSize);
+}
+
+quint64 DrawingItemPointHash::cellKey(qint32 column, qint32 row)
+{
+	return ((quint64)(quint32)column << 32) | (quint64)(quint32)row;
+}
@@ -0,0 +1,62 @@
+/* DrawingItemPointHash.h
+ *
+ * Copyright (C) 2013-2014 Jason Allen
+ *
+ * This file is part of the Jade Diagram Editor.
+ *
+ * Jade is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Jade is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Jade.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef DRAWINGITEMPOINTHASH_H
+#define DRAWINGITEMPOINTHASH_H
+
+#include <DrawingGlobals.h>
+
+/* The DrawingItemPointHash class buckets DrawingItemPoints by their scene position on a uniform
+ * grid so that DrawingScene can find the points near a given location without visiting every
+ * item in the scene.
+ *
+ * The cell size is normally set to the scene's grid spacing.  Connection thresholds are a fraction
+ * of the grid, so a typical query only touches one to four cells.
+ */
+class DrawingItemPointHash
+{
+private:
+	qreal mCellSize;
+
+	QHash<quint64, QList<DrawingItemPoint*> > mCells;
+	QHash<DrawingItemPoint*, QPointF> mPositions;
+
+public:
+	DrawingItemPointHash(qreal cellSize = 100);
+	~DrawingItemPointHash();
+
+	void setCellSize(qreal cellSize);
+	qreal cellSize() const;
+
+	void insertPoint(DrawingItemPoint* itemPoint, const QPointF& scenePos);
+	void removePoint(DrawingItemPoint* itemPoint);
+	void clear();
+
+	bool containsPoint(DrawingItemPoint* itemPoint) const;
+	int numberOfPoints() const;
+
+	QList<DrawingItemPoint*> points(const QRectF& sceneRect) const;
+
+private:
+	qint32 cellCoordinate(qreal value) const;
+	static quint64 cellKey(qint32 column, qint32 row);
+};
+
+#endif
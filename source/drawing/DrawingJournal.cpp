@@ -0,0 +1,483 @@
+/* DrawingJournal.cpp
+ *
+ * Copyright (C) 2013-2014 Jason Allen
+ *
+ * This file is part of the Jade Diagram Editor.
+ *
+ * Jade is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Jade is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Jade.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <DrawingJournal.h>
+#include <DrawingScene.h>
+#include <DrawingItem.h>
+#include <DrawingItemPoint.h>
+#include <DrawingUndo.h>
+
+static const char kJournalMagic[4] = { 'J', 'A', 'D', 'J' };
+static const quint32 kJournalVersion = 1;
+
+DrawingJournal::DrawingJournal()
+{
+	mSaveOffset = -1;
+	mScene = nullptr;
+}
+
+DrawingJournal::~DrawingJournal()
+{
+	// The file is left behind so that the changes can still be recovered
+	close(false);
+}
+
+//==================================================================================================
+
+bool DrawingJournal::open(const QString& documentPath)
+{
+	close(false);
+	return openFile(documentPath, QByteArray());
+}
+
+void DrawingJournal::close(bool remove)
+{
+	if (mFile.isOpen())
+	{
+		mFile.close();
+		if (remove) mFile.remove();
+	}
+
+	mDocumentPath.clear();
+	mSaveOffset = -1;
+	mPendingRecords.clear();
+}
+
+bool DrawingJournal::isOpen() const
+{
+	return mFile.isOpen();
+}
+
+QString DrawingJournal::documentPath() const
+{
+	return mDocumentPath;
+}
+
+//==================================================================================================
+
+void DrawingJournal::writeCommand(const QUndoCommand* command, bool undone)
+{
+	if (command && (mFile.isOpen() || mSaveOffset >= 0))
+	{
+		QByteArray record;
+		QDataStream recordStream(&record, QIODevice::WriteOnly);
+
+		setupStream(recordStream);
+		recordStream << undone;
+		writeCommandData(recordStream, command, undone);
+
+		// Each record is written whole and flushed at once, so a crash can only cut off the last one
+		if (mFile.isOpen())
+		{
+			QDataStream stream(&mFile);
+			setupStream(stream);
+			stream << record;
+			mFile.flush();
+		}
+		else
+		{
+			QDataStream stream(&mPendingRecords, QIODevice::Append);
+			setupStream(stream);
+			stream << record;
+		}
+	}
+}
+
+//==================================================================================================
+
+void DrawingJournal::setSavePoint()
+{
+	// A document without a journal file yet (such as a new diagram being saved for the first time)
+	// holds on to the records written during the save, to become the start of its journal
+	mPendingRecords.clear();
+	mSaveOffset = (mFile.isOpen()) ? mFile.size() : 0;
+}
+
+bool DrawingJournal::commitSavePoint(const QString& documentPath)
+{
+	bool committed = false;
+
+	if (mSaveOffset >= 0)
+	{
+		QByteArray records;
+
+		if (mFile.isOpen())
+		{
+			QString previousFilePath = mFile.fileName();
+
+			mFile.seek(mSaveOffset);
+			records = mFile.readAll();
+			mFile.close();
+
+			committed = openFile(documentPath, records);
+			if (committed && previousFilePath != mFile.fileName()) QFile::remove(previousFilePath);
+			else if (!committed)
+			{
+				mFile.setFileName(previousFilePath);
+				if (mFile.open(QIODevice::ReadWrite)) mFile.seek(mFile.size());
+			}
+		}
+		else committed = openFile(documentPath, mPendingRecords);
+	}
+
+	mSaveOffset = -1;
+	mPendingRecords.clear();
+
+	return committed;
+}
+
+void DrawingJournal::discardSavePoint()
+{
+	mSaveOffset = -1;
+	mPendingRecords.clear();
+}
+
+//==================================================================================================
+
+bool DrawingJournal::replay(const QString& documentPath, DrawingScene* scene)
+{
+	bool replayed = false;
+	bool validHeader = false;
+	qint64 validSize = 0;
+	QFile journalFile(journalFilePath(documentPath));
+
+	close(false);
+
+	if (scene && journalFile.open(QIODevice::ReadWrite))
+	{
+		QDataStream stream(&journalFile);
+		setupStream(stream);
+
+		validHeader = readHeader(stream, documentPath);
+		if (validHeader)
+		{
+			QByteArray record;
+			QUndoCommand* command;
+			bool undone;
+
+			replayed = true;
+			validSize = journalFile.pos();
+			mScene = scene;
+
+			while (replayed && !stream.atEnd())
+			{
+				stream >> record;
+				replayed = (stream.status() == QDataStream::Ok);
+
+				if (replayed)
+				{
+					QDataStream recordStream(record);
+					setupStream(recordStream);
+
+					undone = false;
+					recordStream >> undone;
+
+					mReadItems.clear();
+					command = readCommandData(recordStream, undone, nullptr);
+					replayed = (command && recordStream.status() == QDataStream::Ok);
+
+					// Each command is applied in the direction it was recorded and then discarded;
+					// deleting it frees whatever it owns in that state, just as the undo stack would
+					if (replayed)
+					{
+						if (undone) command->undo();
+						else command->redo();
+
+						validSize = journalFile.pos();
+					}
+
+					delete command;
+				}
+			}
+
+			mReadItems.clear();
+			mScene = nullptr;
+
+			// Anything after the last record that could be replayed is dropped, so that the records
+			// written from now on follow on from it
+			journalFile.resize(validSize);
+		}
+
+		journalFile.close();
+	}
+
+	if (validHeader)
+	{
+		mFile.setFileName(journalFile.fileName());
+		if (mFile.open(QIODevice::ReadWrite))
+		{
+			mFile.seek(mFile.size());
+			mDocumentPath = documentPath;
+		}
+	}
+
+	return replayed;
+}
+
+//==================================================================================================
+
+QString DrawingJournal::journalFilePath(const QString& documentPath)
+{
+	return documentPath + ".journal";
+}
+
+bool DrawingJournal::canReplay(const QString& documentPath)
+{
+	bool validJournal = false;
+	QFile journalFile(journalFilePath(documentPath));
+
+	if (journalFile.open(QIODevice::ReadOnly))
+	{
+		QDataStream stream(&journalFile);
+		setupStream(stream);
+
+		validJournal = (readHeader(stream, documentPath) && !stream.atEnd());
+		journalFile.close();
+	}
+
+	return validJournal;
+}
+
+//==================================================================================================
+
+DrawingScene* DrawingJournal::scene() const
+{
+	return mScene;
+}
+
+//==================================================================================================
+
+void DrawingJournal::writeItemReference(QDataStream& stream, DrawingItem* item)
+{
+	stream << (quint64)((item) ? item->id() : 0);
+}
+
+void DrawingJournal::writeItemReferences(QDataStream& stream, const QList<DrawingItem*>& items)
+{
+	stream << (quint32)items.size();
+
+	for(auto itemIter = items.begin(); itemIter != items.end(); itemIter++)
+		writeItemReference(stream, *itemIter);
+}
+
+void DrawingJournal::writePointReference(QDataStream& stream, DrawingItemPoint* point)
+{
+	DrawingItem* item = (point) ? point->item() : nullptr;
+
+	writeItemReference(stream, item);
+	stream << (qint32)((item) ? item->points().indexOf(point) : -1);
+}
+
+void DrawingJournal::writeItems(QDataStream& stream, const QList<DrawingItem*>& items)
+{
+	DrawingItem::writeItemsToBinary(stream, items);
+}
+
+void DrawingJournal::writePoint(QDataStream& stream, DrawingItemPoint* point)
+{
+	stream << point->pos() << (qint32)point->size() << (quint32)point->flags() << (qint32)point->category();
+}
+
+//==================================================================================================
+
+DrawingItem* DrawingJournal::readItemReference(QDataStream& stream)
+{
+	DrawingItem* item = nullptr;
+	quint64 id = 0;
+
+	stream >> id;
+
+	// Items brought in by the record being read take precedence over the scene's
+	item = mReadItems.value(id);
+	if (item == nullptr && mScene) item = mScene->itemFromId(id);
+
+	if (item == nullptr) stream.setStatus(QDataStream::ReadCorruptData);
+
+	return item;
+}
+
+QList<DrawingItem*> DrawingJournal::readItemReferences(QDataStream& stream)
+{
+	QList<DrawingItem*> items;
+	DrawingItem* item;
+	quint32 numberOfItems = 0;
+
+	stream >> numberOfItems;
+
+	for(quint32 i = 0; i < numberOfItems && stream.status() == QDataStream::Ok; i++)
+	{
+		item = readItemReference(stream);
+		if (item) items.append(item);
+	}
+
+	return items;
+}
+
+DrawingItemPoint* DrawingJournal::readPointReference(QDataStream& stream)
+{
+	DrawingItemPoint* point = nullptr;
+	DrawingItem* item = readItemReference(stream);
+	qint32 pointIndex = -1;
+
+	stream >> pointIndex;
+
+	if (item && pointIndex >= 0 && pointIndex < item->numberOfPoints()) point = item->point(pointIndex);
+	else stream.setStatus(QDataStream::ReadCorruptData);
+
+	return point;
+}
+
+QList<DrawingItem*> DrawingJournal::readItems(QDataStream& stream)
+{
+	QList<DrawingItem*> items = DrawingItem::readItemsFromBinary(stream);
+
+	for(auto itemIter = items.begin(); itemIter != items.end(); itemIter++)
+		mReadItems.insert((*itemIter)->id(), *itemIter);
+
+	return items;
+}
+
+DrawingItemPoint* DrawingJournal::readPoint(QDataStream& stream)
+{
+	DrawingItemPoint* point;
+	QPointF position;
+	qint32 size = 0, category = 0;
+	quint32 flags = 0;
+
+	stream >> position >> size >> flags >> category;
+
+	point = new DrawingItemPoint(position, (DrawingItemPoint::Flags)flags, category);
+	point->setSize(size);
+
+	return point;
+}
+
+//==================================================================================================
+
+bool DrawingJournal::openFile(const QString& documentPath, const QByteArray& records)
+{
+	// The journal is replaced as a whole, so a failure leaves the previous journal as it was
+	QSaveFile journalFile(journalFilePath(documentPath));
+
+	bool fileError = !journalFile.open(QIODevice::WriteOnly);
+	if (!fileError)
+	{
+		QDataStream stream(&journalFile);
+		setupStream(stream);
+
+		writeHeader(stream, documentPath);
+		stream.writeRawData(records.constData(), records.size());
+
+		fileError = (stream.status() != QDataStream::Ok);
+	}
+
+	if (!fileError) fileError = !journalFile.commit();
+	else journalFile.cancelWriting();
+
+	if (!fileError)
+	{
+		mFile.close();
+		mFile.setFileName(journalFile.fileName());
+
+		fileError = !mFile.open(QIODevice::ReadWrite);
+		if (!fileError)
+		{
+			mFile.seek(mFile.size());
+			mDocumentPath = documentPath;
+		}
+	}
+
+	return (!fileError);
+}
+
+//==================================================================================================
+
+void DrawingJournal::writeCommandData(QDataStream& stream, const QUndoCommand* command, bool undone)
+{
+	const DrawingUndoCommand* drawingCommand = dynamic_cast<const DrawingUndoCommand*>(command);
+	qint32 type = (drawingCommand) ? command->id() : -1;
+
+	stream << type;
+	if (type >= 0) drawingCommand->writeJournalData(stream, undone);
+
+	stream << (quint32)command->childCount();
+	for(int i = 0; i < command->childCount(); i++)
+		writeCommandData(stream, command->child(i), undone);
+}
+
+QUndoCommand* DrawingJournal::readCommandData(QDataStream& stream, bool undone, QUndoCommand* parent)
+{
+	QUndoCommand* command = nullptr;
+	qint32 type = -1;
+	quint32 numberOfChildren = 0;
+
+	stream >> type;
+
+	// Commands without a type of their own only group their children
+	if (type < 0) command = new QUndoCommand(parent);
+	else if (mScene) command = mScene->readUndoCommand(type, stream, undone, *this, parent);
+
+	if (command)
+	{
+		stream >> numberOfChildren;
+		for(quint32 i = 0; i < numberOfChildren && stream.status() == QDataStream::Ok; i++)
+			readCommandData(stream, undone, command);
+	}
+	else stream.setStatus(QDataStream::ReadCorruptData);
+
+	return command;
+}
+
+//==================================================================================================
+
+void DrawingJournal::writeHeader(QDataStream& stream, const QString& documentPath)
+{
+	QFileInfo documentInfo(documentPath);
+
+	stream.writeRawData(kJournalMagic, sizeof(kJournalMagic));
+	stream << kJournalVersion;
+	stream << (qint64)((documentInfo.exists()) ? documentInfo.size() : -1) << documentInfo.lastModified();
+}
+
+bool DrawingJournal::readHeader(QDataStream& stream, const QString& documentPath)
+{
+	QFileInfo documentInfo(documentPath);
+	char magic[sizeof(kJournalMagic)];
+	quint32 version = 0;
+	qint64 documentSize = -1;
+	QDateTime documentModified;
+
+	stream.readRawData(magic, sizeof(magic));
+	stream >> version >> documentSize >> documentModified;
+
+	// The journal only applies to the document as it was when the journal was started
+	return (stream.status() == QDataStream::Ok &&
+		QByteArray(magic, sizeof(magic)) == QByteArray(kJournalMagic, sizeof(kJournalMagic)) &&
+		version == kJournalVersion &&
+		documentInfo.exists() && documentInfo.size() == documentSize &&
+		documentInfo.lastModified() == documentModified);
+}
+
+void DrawingJournal::setupStream(QDataStream& stream)
+{
+	stream.setVersion(QDataStream::Qt_5_0);
+	stream.setByteOrder(QDataStream::LittleEndian);
+	stream.setFloatingPointPrecision(QDataStream::DoublePrecision);
+}
@@ -0,0 +1,106 @@
+/* DrawingJournal.h
+ *
+ * Copyright (C) 2013-2014 Jason Allen
+ *
+ * This file is part of the Jade Diagram Editor.
+ *
+ * Jade is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Jade is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Jade.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef DRAWINGJOURNAL_H
+#define DRAWINGJOURNAL_H
+
+#include <DrawingGlobals.h>
+
+/* The DrawingJournal class is an append-only log of the changes made to a scene since its document
+ * was last saved, kept next to the document so that the changes can be recovered after a crash.
+ *
+ * When a journal is set on a scene, every command that is pushed, undone, or redone on the scene's
+ * undo stack is appended to the journal as one record and flushed to the file.  A record holds the
+ * command (and its children) in the direction it was applied, with items and points referred to by
+ * their ids rather than by pointer.  Items that the command creates or brings back into the scene
+ * are stored in full.  Commands describe themselves through
+ * DrawingUndoCommand::writeJournalData and are recreated by DrawingScene::readUndoCommand.
+ *
+ * replay() applies the records in order to a scene that has just loaded the document.  The file
+ * starts with the size and modification time of the document it applies to, so a journal is only
+ * replayed onto the save it was started from.  A record cut short by a crash ends the replay.
+ *
+ * Saving the document compacts the journal.  setSavePoint() marks the end of the journal when a
+ * save starts; commitSavePoint() then rewrites the journal with only the records written after that
+ * mark, since the rest are now part of the saved document.  A document with no journal file yet
+ * (such as a new diagram being saved for the first time) keeps the records written during the save
+ * in memory until then.
+ */
+class DrawingJournal
+{
+private:
+	QFile mFile;
+	QString mDocumentPath;
+	qint64 mSaveOffset;
+	QByteArray mPendingRecords;
+
+	DrawingScene* mScene;
+	QHash<quint64, DrawingItem*> mReadItems;
+
+public:
+	DrawingJournal();
+	~DrawingJournal();
+
+	bool open(const QString& documentPath);
+	void close(bool remove);
+	bool isOpen() const;
+	QString documentPath() const;
+
+	void writeCommand(const QUndoCommand* command, bool undone);
+
+	void setSavePoint();
+	bool commitSavePoint(const QString& documentPath);
+	void discardSavePoint();
+
+	bool replay(const QString& documentPath, DrawingScene* scene);
+
+	static QString journalFilePath(const QString& documentPath);
+	static bool canReplay(const QString& documentPath);
+
+	// Used by the undo commands to write and read their data
+	DrawingScene* scene() const;
+
+	static void writeItemReference(QDataStream& stream, DrawingItem* item);
+	static void writeItemReferences(QDataStream& stream, const QList<DrawingItem*>& items);
+	static void writePointReference(QDataStream& stream, DrawingItemPoint* point);
+	static void writeItems(QDataStream& stream, const QList<DrawingItem*>& items);
+	static void writePoint(QDataStream& stream, DrawingItemPoint* point);
+
+	DrawingItem* readItemReference(QDataStream& stream);
+	QList<DrawingItem*> readItemReferences(QDataStream& stream);
+	DrawingItemPoint* readPointReference(QDataStream& stream);
+	QList<DrawingItem*> readItems(QDataStream& stream);
+	DrawingItemPoint* readPoint(QDataStream& stream);
+
+private:
+	bool openFile(const QString& documentPath, const QByteArray& records);
+
+	void writeCommandData(QDataStream& stream, const QUndoCommand* command, bool undone);
+	QUndoCommand* readCommandData(QDataStream& stream, bool undone, QUndoCommand* parent);
+
+	static void writeHeader(QDataStream& stream, const QString& documentPath);
+	static bool readHeader(QDataStream& stream, const QString& documentPath);
+	static void setupStream(QDataStream& stream);
+
+	DrawingJournal(const DrawingJournal&);
+	DrawingJournal& operator=(const DrawingJournal&);
+};
+
+#endif
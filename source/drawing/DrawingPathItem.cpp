@@ -239,6 +239,23 @@ void DrawingPathItem::readXmlAttributes(QXmlStreamReader& xmlReader, const QList
 		setPath(Drawing::pathFromString(attributes.value("path").toString()));
 }
 
+void DrawingPathItem::writeBinaryData(QDataStream& stream)
+{
+	DrawingRectResizeItem::writeBinaryData(stream);
+
+	stream << path();
+}
+
+void DrawingPathItem::readBinaryData(QDataStream& stream)
+{
+	QPainterPath path;
+
+	DrawingRectResizeItem::readBinaryData(stream);
+
+	stream >> path;
+	setPath(path);
+}
+
 //==================================================================================================
 
 void DrawingPathItem::setInitialPath(const QPainterPath& path)
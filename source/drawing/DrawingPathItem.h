@@ -62,6 +62,9 @@ protected:
 
 	virtual void writeXmlAttributes(QXmlStreamWriter& xmlWriter, const QList<DrawingItem*>& items);
 	virtual void readXmlAttributes(QXmlStreamReader& xmlReader, const QList<DrawingItem*>& items);
+
+	virtual void writeBinaryData(QDataStream& stream);
+	virtual void readBinaryData(QDataStream& stream);
 };
 
 #endif
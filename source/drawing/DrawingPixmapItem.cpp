@@ -25,7 +25,7 @@ DrawingPixmapItem::DrawingPixmapItem() : DrawingRectResizeItem()
 {
 	QRect rect(-200, -200, 400, 400);
 
-	addProperty("Image", QPixmap());
+	addProperty(ImageProperty, QPixmap());
 
 	setPlaceType(PlaceMouseUp);
 
@@ -61,12 +61,12 @@ QString DrawingPixmapItem::uniqueKey() const
 
 void DrawingPixmapItem::setPixmap(const QPixmap& pixmap)
 {
-	setPropertyValue("Image", pixmap);
+	setPropertyValue(ImageProperty, pixmap);
 }
 
 QPixmap DrawingPixmapItem::pixmap() const
 {
-	return propertyValue("Image").value<QPixmap>();
+	return propertyValue(ImageProperty).value<QPixmap>();
 }
 
 //==================================================================================================
@@ -140,10 +140,14 @@ void DrawingPixmapItem::writeXmlAttributes(QXmlStreamWriter& xmlWriter, const QL
 {
 	DrawingRectResizeItem::writeXmlAttributes(xmlWriter, items);
 
-	QPixmap pixmap = DrawingPixmapItem::pixmap();
+	QVariant image = propertyValue(ImageProperty);
 	QBuffer buffer;
 	buffer.open(QIODevice::WriteOnly);
-	pixmap.save(&buffer, "PNG");
+
+	// Items in a snapshot that is saved on another thread hold a QImage (see DrawingSnapshot)
+	if (image.type() == QVariant::Image) image.value<QImage>().save(&buffer, "PNG");
+	else pixmap().save(&buffer, "PNG");
+
 	buffer.close();
 
 	xmlWriter.writeAttribute("data", buffer.buffer().toPercentEncoding());
@@ -163,6 +167,17 @@ void DrawingPixmapItem::readXmlAttributes(QXmlStreamReader& xmlReader, const QLi
 	}
 }
 
+void DrawingPixmapItem::readBinaryData(QDataStream& stream)
+{
+	QVariant image = propertyValue(ImageProperty);
+
+	DrawingRectResizeItem::readBinaryData(stream);
+
+	// Files saved from a snapshot store the image as a QImage, which is converted back here so
+	// that it is not converted every time the item is drawn
+	if (image.type() == QVariant::Image) setPixmap(QPixmap::fromImage(image.value<QImage>()));
+}
+
 //==================================================================================================
 
 QVariant DrawingPixmapItem::aboutToChangeEvent(Reason reason, const QVariant& value)
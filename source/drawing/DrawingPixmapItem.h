@@ -45,6 +45,8 @@ protected:
 
 	virtual void writeXmlAttributes(QXmlStreamWriter& xmlWriter, const QList<DrawingItem*>& items);
 	virtual void readXmlAttributes(QXmlStreamReader& xmlReader, const QList<DrawingItem*>& items);
+
+	virtual void readBinaryData(QDataStream& stream);
 };
 
 #endif
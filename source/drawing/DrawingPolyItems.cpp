@@ -23,11 +23,11 @@
 
 DrawingPolyItem::DrawingPolyItem() : DrawingItem()
 {
-	addProperty("Pen Color", QColor(255, 0, 255));
-	addProperty("Pen Width", 12.0);
-	addProperty("Pen Style", (unsigned int)Qt::SolidLine);
-	addProperty("Pen Cap Style", (unsigned int)Qt::RoundCap);
-	addProperty("Pen Join Style", (unsigned int)Qt::RoundJoin);
+	addProperty(PenColorProperty, QColor(255, 0, 255));
+	addProperty(PenWidthProperty, 12.0);
+	addProperty(PenStyleProperty, (unsigned int)Qt::SolidLine);
+	addProperty(PenCapStyleProperty, (unsigned int)Qt::RoundCap);
+	addProperty(PenJoinStyleProperty, (unsigned int)Qt::RoundJoin);
 
 	setFlags(CanMove | CanRotate | CanFlip | CanResize | CanInsertRemovePoints | MatchUnitsWithParent);
 	setPlaceType(PlaceMouseDownAndUp);
@@ -92,27 +92,27 @@ void DrawingPolyItem::setPen(const QPen& pen)
 
 void DrawingPolyItem::setPenColor(const QColor& color)
 {
-	setPropertyValue("Pen Color", color);
+	setPropertyValue(PenColorProperty, color);
 }
 
 void DrawingPolyItem::setPenWidth(qreal width)
 {
-	setPropertyValue("Pen Width", width);
+	setPropertyValue(PenWidthProperty, width);
 }
 
 void DrawingPolyItem::setPenStyle(Qt::PenStyle style)
 {
-	setPropertyValue("Pen Style", (unsigned int)style);
+	setPropertyValue(PenStyleProperty, (unsigned int)style);
 }
 
 void DrawingPolyItem::setPenCapStyle(Qt::PenCapStyle style)
 {
-	setPropertyValue("Pen Cap Style", (unsigned int)style);
+	setPropertyValue(PenCapStyleProperty, (unsigned int)style);
 }
 
 void DrawingPolyItem::setPenJoinStyle(Qt::PenJoinStyle style)
 {
-	setPropertyValue("Pen Join Style", (unsigned int)style);
+	setPropertyValue(PenJoinStyleProperty, (unsigned int)style);
 }
 
 QPen DrawingPolyItem::pen() const
@@ -122,27 +122,27 @@ QPen DrawingPolyItem::pen() const
 
 QColor DrawingPolyItem::penColor() const
 {
-	return propertyValue("Pen Color").value<QColor>();
+	return propertyValue(PenColorProperty).value<QColor>();
 }
 
 qreal DrawingPolyItem::penWidth() const
 {
-	return propertyValue("Pen Width").toDouble();
+	return propertyValue(PenWidthProperty).toDouble();
 }
 
 Qt::PenStyle DrawingPolyItem::penStyle() const
 {
-	return (Qt::PenStyle)propertyValue("Pen Style").toUInt();
+	return (Qt::PenStyle)propertyValue(PenStyleProperty).toUInt();
 }
 
 Qt::PenCapStyle DrawingPolyItem::penCapStyle() const
 {
-	return (Qt::PenCapStyle)propertyValue("Pen Cap Style").toUInt();
+	return (Qt::PenCapStyle)propertyValue(PenCapStyleProperty).toUInt();
 }
 
 Qt::PenJoinStyle DrawingPolyItem::penJoinStyle() const
 {
-	return (Qt::PenJoinStyle)propertyValue("Pen Join Style").toUInt();
+	return (Qt::PenJoinStyle)propertyValue(PenJoinStyleProperty).toUInt();
 }
 
 //==================================================================================================
@@ -184,34 +184,43 @@ QVariant DrawingPolyItem::aboutToChangeEvent(Reason reason, const QVariant& valu
 
 //==================================================================================================
 
-void DrawingPolyItem::writeXmlAttributes(QXmlStreamWriter& xmlWriter, const QList<DrawingItem*>& items)
+bool DrawingPolyItem::outlineContains(const QPointF& itemPos, bool closed) const
 {
-	DrawingItem::writeXmlAttributes(xmlWriter, items);
+	QList<DrawingItemPoint*> points = DrawingPolyItem::points();
+	qreal halfWidth = itemOutlineWidth(pen()) / 2;
+	bool contains = false;
 
-	xmlWriter.writeAttribute("penColor", Drawing::colorToString(penColor()));
-	xmlWriter.writeAttribute("penWidth", QString::number(penWidth()));
-	xmlWriter.writeAttribute("penStyle", QString::number((unsigned int)penStyle()));
-	xmlWriter.writeAttribute("penCapStyle", QString::number((unsigned int)penCapStyle()));
-	xmlWriter.writeAttribute("penJoinStyle", QString::number((unsigned int)penJoinStyle()));
+	for(int i = 1; !contains && i < points.size(); i++)
+	{
+		contains = (Drawing::distanceFromPointToLineSegment(itemPos,
+			QLineF(points[i-1]->pos(), points[i]->pos())) <= halfWidth);
+	}
+
+	if (!contains && closed && points.size() > 2)
+	{
+		contains = (Drawing::distanceFromPointToLineSegment(itemPos,
+			QLineF(points.last()->pos(), points.first()->pos())) <= halfWidth);
+	}
+
+	return contains;
 }
 
-void DrawingPolyItem::readXmlAttributes(QXmlStreamReader& xmlReader, const QList<DrawingItem*>& items)
+bool DrawingPolyItem::outlineIntersects(const QRectF& itemRect, bool closed) const
 {
-	QXmlStreamAttributes attributes = xmlReader.attributes();
+	QList<DrawingItemPoint*> points = DrawingPolyItem::points();
+	qreal halfWidth = itemOutlineWidth(pen()) / 2;
+	QRectF rect = itemRect.normalized().adjusted(-halfWidth, -halfWidth, halfWidth, halfWidth);
+	bool intersects = false;
+
+	for(int i = 1; !intersects && i < points.size(); i++)
+		intersects = Drawing::lineSegmentIntersectsRect(QLineF(points[i-1]->pos(), points[i]->pos()), rect);
 
-	DrawingItem::readXmlAttributes(xmlReader, items);
+	if (!intersects && closed && points.size() > 2)
+		intersects = Drawing::lineSegmentIntersectsRect(QLineF(points.last()->pos(), points.first()->pos()), rect);
 
-	if (attributes.hasAttribute("penColor"))
-		setPenColor(Drawing::colorFromString(attributes.value("penColor").toString()));
-	if (attributes.hasAttribute("penWidth"))
-		setPenWidth(attributes.value("penWidth").toString().toDouble());
-	if (attributes.hasAttribute("penStyle"))
-		setPenStyle((Qt::PenStyle)attributes.value("penStyle").toString().toUInt());
-	if (attributes.hasAttribute("penCapStyle"))
-		setPenCapStyle((Qt::PenCapStyle)attributes.value("penCapStyle").toString().toUInt());
-	if (attributes.hasAttribute("penJoinStyle"))
-		setPenJoinStyle((Qt::PenJoinStyle)attributes.value("penJoinStyle").toString().toUInt());
+	return intersects;
 }
+
 //==================================================================================================
 //==================================================================================================
 //==================================================================================================
@@ -221,10 +230,10 @@ DrawingPolylineItem::DrawingPolylineItem() : DrawingPolyItem()
 	QVariant variant;
 	variant.setValue(DrawingArrow());
 
-	addProperty("Start Arrow Style", DrawingArrow::None);
-	addProperty("Start Arrow Size", 100.0);
-	addProperty("End Arrow Style", DrawingArrow::None);
-	addProperty("End Arrow Size", 100.0);
+	addProperty(StartArrowStyleProperty, DrawingArrow::None);
+	addProperty(StartArrowSizeProperty, 100.0);
+	addProperty(EndArrowStyleProperty, DrawingArrow::None);
+	addProperty(EndArrowSizeProperty, 100.0);
 
 	addPoint(new DrawingItemPoint(QPointF(0.0, 0.0),
 		DrawingItemPoint::Control | DrawingItemPoint::Connection | DrawingItemPoint::Free, 0));
@@ -258,12 +267,12 @@ void DrawingPolylineItem::setStartArrow(const DrawingArrow& arrow)
 
 void DrawingPolylineItem::setStartArrowStyle(DrawingArrow::Style style)
 {
-	setPropertyValue("Start Arrow Style", (unsigned int)style);
+	setPropertyValue(StartArrowStyleProperty, (unsigned int)style);
 }
 
 void DrawingPolylineItem::setStartArrowSize(qreal size)
 {
-	setPropertyValue("Start Arrow Size", size);
+	setPropertyValue(StartArrowSizeProperty, size);
 }
 
 DrawingArrow DrawingPolylineItem::startArrow() const
@@ -273,12 +282,12 @@ DrawingArrow DrawingPolylineItem::startArrow() const
 
 DrawingArrow::Style DrawingPolylineItem::startArrowStyle() const
 {
-	return (DrawingArrow::Style)propertyValue("Start Arrow Style").toUInt();
+	return (DrawingArrow::Style)propertyValue(StartArrowStyleProperty).toUInt();
 }
 
 qreal DrawingPolylineItem::startArrowSize() const
 {
-	return propertyValue("Start Arrow Size").toDouble();
+	return propertyValue(StartArrowSizeProperty).toDouble();
 }
 
 //==================================================================================================
@@ -291,12 +300,12 @@ void DrawingPolylineItem::setEndArrow(const DrawingArrow& arrow)
 
 void DrawingPolylineItem::setEndArrowStyle(DrawingArrow::Style style)
 {
-	setPropertyValue("End Arrow Style", (unsigned int)style);
+	setPropertyValue(EndArrowStyleProperty, (unsigned int)style);
 }
 
 void DrawingPolylineItem::setEndArrowSize(qreal size)
 {
-	setPropertyValue("End Arrow Size", size);
+	setPropertyValue(EndArrowSizeProperty, size);
 }
 
 DrawingArrow DrawingPolylineItem::endArrow() const
@@ -306,12 +315,12 @@ DrawingArrow DrawingPolylineItem::endArrow() const
 
 DrawingArrow::Style DrawingPolylineItem::endArrowStyle() const
 {
-	return (DrawingArrow::Style)propertyValue("End Arrow Style").toUInt();
+	return (DrawingArrow::Style)propertyValue(EndArrowStyleProperty).toUInt();
 }
 
 qreal DrawingPolylineItem::endArrowSize() const
 {
-	return propertyValue("End Arrow Size").toDouble();
+	return propertyValue(EndArrowSizeProperty).toDouble();
 }
 
 //==================================================================================================
@@ -356,6 +365,16 @@ QPainterPath DrawingPolylineItem::shape() const
 	return itemShapeFromPath(path, pen());
 }
 
+bool DrawingPolylineItem::shapeContains(const QPointF& itemPos) const
+{
+	return outlineContains(itemPos, false);
+}
+
+bool DrawingPolylineItem::shapeIntersects(const QRectF& itemRect) const
+{
+	return outlineIntersects(itemRect, false);
+}
+
 //==================================================================================================
 
 void DrawingPolylineItem::render(QPainter* painter, const DrawingStyleOptions& styleOptions)
@@ -516,7 +535,7 @@ void DrawingPolylineItem::readXmlAttributes(QXmlStreamReader& xmlReader, const Q
 
 DrawingPolygonItem::DrawingPolygonItem() : DrawingPolyItem()
 {
-	addProperty("Brush Color", QColor(0, 0, 0, 0));
+	addProperty(BrushColorProperty, QColor(0, 0, 0, 0));
 	setPlaceType(PlaceMouseUp);
 
 	addPoint(new DrawingItemPoint(QPointF(-200.0, -200.0),
@@ -552,7 +571,7 @@ void DrawingPolygonItem::setBrush(const QBrush& brush)
 
 void DrawingPolygonItem::setBrushColor(const QColor& color)
 {
-	setPropertyValue("Brush Color", color);
+	setPropertyValue(BrushColorProperty, color);
 }
 
 QBrush DrawingPolygonItem::brush() const
@@ -562,7 +581,7 @@ QBrush DrawingPolygonItem::brush() const
 
 QColor DrawingPolygonItem::brushColor() const
 {
-	return propertyValue("Brush Color").value<QColor>();
+	return propertyValue(BrushColorProperty).value<QColor>();
 }
 
 //==================================================================================================
@@ -599,6 +618,43 @@ QPainterPath DrawingPolygonItem::shape() const
 	return shape;
 }
 
+bool DrawingPolygonItem::shapeContains(const QPointF& itemPos) const
+{
+	bool contains = outlineContains(itemPos, true);
+
+	if (!contains && brush().color().alpha() > 0)
+	{
+		// Even-odd crossing test, matching the fill rule of the painter path used by shape()
+		QList<DrawingItemPoint*> points = DrawingPolygonItem::points();
+		QPointF point0, point1;
+
+		for(int i = 0, j = points.size() - 1; i < points.size(); j = i++)
+		{
+			point0 = points[i]->pos();
+			point1 = points[j]->pos();
+
+			if ((point0.y() > itemPos.y()) != (point1.y() > itemPos.y()) &&
+				itemPos.x() < (point1.x() - point0.x()) * (itemPos.y() - point0.y()) / (point1.y() - point0.y()) + point0.x())
+			{
+				contains = !contains;
+			}
+		}
+	}
+
+	return contains;
+}
+
+bool DrawingPolygonItem::shapeIntersects(const QRectF& itemRect) const
+{
+	bool intersects = outlineIntersects(itemRect, true);
+
+	// If no edge crosses the rect, it either lies entirely inside the polygon or entirely outside
+	if (!intersects && brush().color().alpha() > 0)
+		intersects = DrawingPolygonItem::shapeContains(itemRect.normalized().topLeft());
+
+	return intersects;
+}
+
 //==================================================================================================
 
 void DrawingPolygonItem::render(QPainter* painter, const DrawingStyleOptions& styleOptions)
@@ -682,22 +738,3 @@ QVariant DrawingPolygonItem::aboutToChangeEvent(Reason reason, const QVariant& v
 	if (reason == AddNewItemToScene) adjustReferencePoint();
 	return result;
 }
-
-//==================================================================================================
-
-void DrawingPolygonItem::writeXmlAttributes(QXmlStreamWriter& xmlWriter, const QList<DrawingItem*>& items)
-{
-	DrawingPolyItem::writeXmlAttributes(xmlWriter, items);
-
-	xmlWriter.writeAttribute("brushColor", Drawing::colorToString(brushColor()));
-}
-
-void DrawingPolygonItem::readXmlAttributes(QXmlStreamReader& xmlReader, const QList<DrawingItem*>& items)
-{
-	QXmlStreamAttributes attributes = xmlReader.attributes();
-
-	DrawingPolyItem::readXmlAttributes(xmlReader, items);
-
-	if (attributes.hasAttribute("brushColor"))
-		setBrushColor(Drawing::colorFromString(attributes.value("brushColor").toString()));
-}
@@ -58,8 +58,9 @@ public:
 protected:
 	virtual QVariant aboutToChangeEvent(Reason reason, const QVariant& value);
 
-	virtual void writeXmlAttributes(QXmlStreamWriter& xmlWriter, const QList<DrawingItem*>& items);
-	virtual void readXmlAttributes(QXmlStreamReader& xmlReader, const QList<DrawingItem*>& items);
+	bool outlineContains(const QPointF& itemPos, bool closed) const;
+	bool outlineIntersects(const QRectF& itemRect, bool closed) const;
+
 };
 
 //==================================================================================================
@@ -93,6 +94,8 @@ public:
 
 	virtual QRectF boundingRect() const;
 	virtual QPainterPath shape() const;
+	virtual bool shapeContains(const QPointF& itemPos) const;
+	virtual bool shapeIntersects(const QRectF& itemRect) const;
 
 	virtual void render(QPainter* painter, const DrawingStyleOptions& styleOptions);
 
@@ -126,6 +129,8 @@ public:
 
 	virtual QRectF boundingRect() const;
 	virtual QPainterPath shape() const;
+	virtual bool shapeContains(const QPointF& itemPos) const;
+	virtual bool shapeIntersects(const QRectF& itemRect) const;
 
 	virtual void render(QPainter* painter, const DrawingStyleOptions& styleOptions);
 
@@ -135,9 +140,6 @@ public:
 
 protected:
 	virtual QVariant aboutToChangeEvent(Reason reason, const QVariant& value);
-
-	virtual void writeXmlAttributes(QXmlStreamWriter& xmlWriter, const QList<DrawingItem*>& items);
-	virtual void readXmlAttributes(QXmlStreamReader& xmlReader, const QList<DrawingItem*>& items);
 };
 
 #endif
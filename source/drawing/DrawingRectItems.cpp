@@ -23,11 +23,11 @@
 
 DrawingRectResizeItem::DrawingRectResizeItem() : DrawingItem()
 {
-	addProperty("Pen Color", QColor(255, 0, 255));
-	addProperty("Pen Width", 12.0);
-	addProperty("Pen Style", (unsigned int)Qt::SolidLine);
-	addProperty("Pen Cap Style", (unsigned int)Qt::RoundCap);
-	addProperty("Pen Join Style", (unsigned int)Qt::RoundJoin);
+	addProperty(PenColorProperty, QColor(255, 0, 255));
+	addProperty(PenWidthProperty, 12.0);
+	addProperty(PenStyleProperty, (unsigned int)Qt::SolidLine);
+	addProperty(PenCapStyleProperty, (unsigned int)Qt::RoundCap);
+	addProperty(PenJoinStyleProperty, (unsigned int)Qt::RoundJoin);
 
 	setFlags(CanMove | CanRotate | CanFlip | CanResize | MatchUnitsWithParent);
 	setPlaceType(PlaceMouseDownAndUp);
@@ -72,27 +72,27 @@ void DrawingRectResizeItem::setPen(const QPen& pen)
 
 void DrawingRectResizeItem::setPenColor(const QColor& color)
 {
-	setPropertyValue("Pen Color", color);
+	setPropertyValue(PenColorProperty, color);
 }
 
 void DrawingRectResizeItem::setPenWidth(qreal width)
 {
-	setPropertyValue("Pen Width", width);
+	setPropertyValue(PenWidthProperty, width);
 }
 
 void DrawingRectResizeItem::setPenStyle(Qt::PenStyle style)
 {
-	setPropertyValue("Pen Style", (unsigned int)style);
+	setPropertyValue(PenStyleProperty, (unsigned int)style);
 }
 
 void DrawingRectResizeItem::setPenCapStyle(Qt::PenCapStyle style)
 {
-	setPropertyValue("Pen Cap Style", (unsigned int)style);
+	setPropertyValue(PenCapStyleProperty, (unsigned int)style);
 }
 
 void DrawingRectResizeItem::setPenJoinStyle(Qt::PenJoinStyle style)
 {
-	setPropertyValue("Pen Join Style", (unsigned int)style);
+	setPropertyValue(PenJoinStyleProperty, (unsigned int)style);
 }
 
 QPen DrawingRectResizeItem::pen() const
@@ -102,27 +102,27 @@ QPen DrawingRectResizeItem::pen() const
 
 QColor DrawingRectResizeItem::penColor() const
 {
-	return propertyValue("Pen Color").value<QColor>();
+	return propertyValue(PenColorProperty).value<QColor>();
 }
 
 qreal DrawingRectResizeItem::penWidth() const
 {
-	return propertyValue("Pen Width").toDouble();
+	return propertyValue(PenWidthProperty).toDouble();
 }
 
 Qt::PenStyle DrawingRectResizeItem::penStyle() const
 {
-	return (Qt::PenStyle)propertyValue("Pen Style").toUInt();
+	return (Qt::PenStyle)propertyValue(PenStyleProperty).toUInt();
 }
 
 Qt::PenCapStyle DrawingRectResizeItem::penCapStyle() const
 {
-	return (Qt::PenCapStyle)propertyValue("Pen Cap Style").toUInt();
+	return (Qt::PenCapStyle)propertyValue(PenCapStyleProperty).toUInt();
 }
 
 Qt::PenJoinStyle DrawingRectResizeItem::penJoinStyle() const
 {
-	return (Qt::PenJoinStyle)propertyValue("Pen Join Style").toUInt();
+	return (Qt::PenJoinStyle)propertyValue(PenJoinStyleProperty).toUInt();
 }
 
 //==================================================================================================
@@ -158,37 +158,6 @@ QVariant DrawingRectResizeItem::aboutToChangeEvent(Reason reason, const QVariant
 
 //==================================================================================================
 
-void DrawingRectResizeItem::writeXmlAttributes(QXmlStreamWriter& xmlWriter, const QList<DrawingItem*>& items)
-{
-	DrawingItem::writeXmlAttributes(xmlWriter, items);
-
-	xmlWriter.writeAttribute("penColor", Drawing::colorToString(penColor()));
-	xmlWriter.writeAttribute("penWidth", QString::number(penWidth()));
-	xmlWriter.writeAttribute("penStyle", QString::number((unsigned int)penStyle()));
-	xmlWriter.writeAttribute("penCapStyle", QString::number((unsigned int)penCapStyle()));
-	xmlWriter.writeAttribute("penJoinStyle", QString::number((unsigned int)penJoinStyle()));
-}
-
-void DrawingRectResizeItem::readXmlAttributes(QXmlStreamReader& xmlReader, const QList<DrawingItem*>& items)
-{
-	QXmlStreamAttributes attributes = xmlReader.attributes();
-
-	DrawingItem::readXmlAttributes(xmlReader, items);
-
-	if (attributes.hasAttribute("penColor"))
-		setPenColor(Drawing::colorFromString(attributes.value("penColor").toString()));
-	if (attributes.hasAttribute("penWidth"))
-		setPenWidth(attributes.value("penWidth").toString().toDouble());
-	if (attributes.hasAttribute("penStyle"))
-		setPenStyle((Qt::PenStyle)attributes.value("penStyle").toString().toUInt());
-	if (attributes.hasAttribute("penCapStyle"))
-		setPenCapStyle((Qt::PenCapStyle)attributes.value("penCapStyle").toString().toUInt());
-	if (attributes.hasAttribute("penJoinStyle"))
-		setPenJoinStyle((Qt::PenJoinStyle)attributes.value("penJoinStyle").toString().toUInt());
-}
-
-//==================================================================================================
-
 void DrawingRectResizeItem::adjustBoxControlPoints(DrawingItemPoint* activePoint)
 {
 	if (activePoint == nullptr) activePoint = selectedPoint();
@@ -307,15 +276,73 @@ void DrawingRectResizeItem::adjustEllipseControlPoints(DrawingItemPoint* activeP
 	}
 }
 
+//==================================================================================================
+
+bool DrawingRectResizeItem::roundedRectShapeContains(const QRectF& rect, qreal xRadius, qreal yRadius,
+	bool filled, const QPointF& itemPos) const
+{
+	// The outline is treated as the band between the rounded rect grown and shrunk by half the
+	// outline width; ellipses are rounded rects whose radii are half their size
+	qreal halfWidth = itemOutlineWidth(pen()) / 2;
+	QRectF bounds = rect.normalized();
+	QRectF innerRect = bounds.adjusted(halfWidth, halfWidth, -halfWidth, -halfWidth);
+	bool contains = false;
+
+	xRadius = qMin(qAbs(xRadius), bounds.width() / 2);
+	yRadius = qMin(qAbs(yRadius), bounds.height() / 2);
+
+	contains = Drawing::roundedRectContainsPoint(bounds.adjusted(-halfWidth, -halfWidth, halfWidth, halfWidth),
+		(xRadius > 0) ? xRadius + halfWidth : 0, (yRadius > 0) ? yRadius + halfWidth : 0, itemPos);
+
+	if (contains && !filled && innerRect.width() > 0 && innerRect.height() > 0)
+	{
+		contains = !Drawing::roundedRectContainsPoint(innerRect,
+			qMax(xRadius - halfWidth, 0.0), qMax(yRadius - halfWidth, 0.0), itemPos);
+	}
+
+	return contains;
+}
+
+bool DrawingRectResizeItem::roundedRectShapeIntersects(const QRectF& rect, qreal xRadius, qreal yRadius,
+	bool filled, const QRectF& itemRect) const
+{
+	qreal halfWidth = itemOutlineWidth(pen()) / 2;
+	QRectF bounds = rect.normalized();
+	QRectF innerRect = bounds.adjusted(halfWidth, halfWidth, -halfWidth, -halfWidth);
+	QRectF testRect = itemRect.normalized();
+	bool intersects = false;
+
+	xRadius = qMin(qAbs(xRadius), bounds.width() / 2);
+	yRadius = qMin(qAbs(yRadius), bounds.height() / 2);
+
+	intersects = Drawing::roundedRectIntersectsRect(bounds.adjusted(-halfWidth, -halfWidth, halfWidth, halfWidth),
+		(xRadius > 0) ? xRadius + halfWidth : 0, (yRadius > 0) ? yRadius + halfWidth : 0, testRect);
+
+	// The shape is convex, so the test rect misses an unfilled outline only if all four of its
+	// corners lie inside the hole
+	if (intersects && !filled && innerRect.width() > 0 && innerRect.height() > 0)
+	{
+		qreal innerRadiusX = qMax(xRadius - halfWidth, 0.0);
+		qreal innerRadiusY = qMax(yRadius - halfWidth, 0.0);
+
+		intersects = !(Drawing::roundedRectContainsPoint(innerRect, innerRadiusX, innerRadiusY, testRect.topLeft()) &&
+			Drawing::roundedRectContainsPoint(innerRect, innerRadiusX, innerRadiusY, testRect.topRight()) &&
+			Drawing::roundedRectContainsPoint(innerRect, innerRadiusX, innerRadiusY, testRect.bottomLeft()) &&
+			Drawing::roundedRectContainsPoint(innerRect, innerRadiusX, innerRadiusY, testRect.bottomRight()));
+	}
+
+	return intersects;
+}
+
 //==================================================================================================
 //==================================================================================================
 //==================================================================================================
 
 DrawingRectItem::DrawingRectItem() : DrawingRectResizeItem()
 {
-	addProperty("Brush Color", QColor(0, 0, 0, 0));
-	addProperty("Corner X-Radius", QVariant(0.0));
-	addProperty("Corner Y-Radius", QVariant(0.0));
+	addProperty(BrushColorProperty, QColor(0, 0, 0, 0));
+	addProperty(CornerXRadiusProperty, QVariant(0.0));
+	addProperty(CornerYRadiusProperty, QVariant(0.0));
 
 	for(int i = 0; i < 4; i++)
 		point(i)->setFlags(DrawingItemPoint::Control | DrawingItemPoint::Connection);
@@ -346,7 +373,7 @@ void DrawingRectItem::setBrush(const QBrush& brush)
 
 void DrawingRectItem::setBrushColor(const QColor& color)
 {
-	setPropertyValue("Brush Color", color);
+	setPropertyValue(BrushColorProperty, color);
 }
 
 QBrush DrawingRectItem::brush() const
@@ -356,35 +383,35 @@ QBrush DrawingRectItem::brush() const
 
 QColor DrawingRectItem::brushColor() const
 {
-	return propertyValue("Brush Color").value<QColor>();
+	return propertyValue(BrushColorProperty).value<QColor>();
 }
 
 //==================================================================================================
 
 void DrawingRectItem::setCornerRadii(qreal xRadius, qreal yRadius)
 {
-	setPropertyValue("Corner X-Radius", xRadius);
-	setPropertyValue("Corner Y-Radius", yRadius);
+	setPropertyValue(CornerXRadiusProperty, xRadius);
+	setPropertyValue(CornerYRadiusProperty, yRadius);
 }
 
 void DrawingRectItem::setCornerRadiusX(qreal radius)
 {
-	setPropertyValue("Corner X-Radius", radius);
+	setPropertyValue(CornerXRadiusProperty, radius);
 }
 
 void DrawingRectItem::setCornerRadiusY(qreal radius)
 {
-	setPropertyValue("Corner Y-Radius", radius);
+	setPropertyValue(CornerYRadiusProperty, radius);
 }
 
 qreal DrawingRectItem::cornerRadiusX() const
 {
-	return propertyValue("Corner X-Radius").toDouble();
+	return propertyValue(CornerXRadiusProperty).toDouble();
 }
 
 qreal DrawingRectItem::cornerRadiusY() const
 {
-	return propertyValue("Corner Y-Radius").toDouble();
+	return propertyValue(CornerYRadiusProperty).toDouble();
 }
 
 //==================================================================================================
@@ -406,6 +433,18 @@ QPainterPath DrawingRectItem::shape() const
 	return shape;
 }
 
+bool DrawingRectItem::shapeContains(const QPointF& itemPos) const
+{
+	return roundedRectShapeContains(boundingRect(), orientedCornerRadiusX(), orientedCornerRadiusY(),
+		brush().color().alpha() > 0, itemPos);
+}
+
+bool DrawingRectItem::shapeIntersects(const QRectF& itemRect) const
+{
+	return roundedRectShapeIntersects(boundingRect(), orientedCornerRadiusX(), orientedCornerRadiusY(),
+		brush().color().alpha() > 0, itemRect);
+}
+
 //==================================================================================================
 
 void DrawingRectItem::render(QPainter* painter, const DrawingStyleOptions& styleOptions)
@@ -449,7 +488,6 @@ void DrawingRectItem::writeXmlAttributes(QXmlStreamWriter& xmlWriter, const QLis
 {
 	DrawingRectResizeItem::writeXmlAttributes(xmlWriter, items);
 
-	xmlWriter.writeAttribute("brushColor", Drawing::colorToString(brushColor()));
 	xmlWriter.writeAttribute("cornerRadiusX", QString::number(cornerRadiusX()));
 	xmlWriter.writeAttribute("cornerRadiusY", QString::number(cornerRadiusY()));
 }
@@ -460,8 +498,6 @@ void DrawingRectItem::readXmlAttributes(QXmlStreamReader& xmlReader, const QList
 
 	DrawingRectResizeItem::readXmlAttributes(xmlReader, items);
 
-	if (attributes.hasAttribute("brushColor"))
-		setBrushColor(Drawing::colorFromString(attributes.value("brushColor").toString()));
 	if (attributes.hasAttribute("cornerRadiusX"))
 		setCornerRadiusX(attributes.value("cornerRadiusX").toString().toDouble());
 	if (attributes.hasAttribute("cornerRadiusY"))
@@ -490,7 +526,7 @@ qreal DrawingRectItem::orientedCornerRadiusY() const
 
 DrawingEllipseItem::DrawingEllipseItem() : DrawingRectResizeItem()
 {
-	addProperty("Brush Color", QColor(0, 0, 0, 0));
+	addProperty(BrushColorProperty, QColor(0, 0, 0, 0));
 
 	for(int i = 8; i < 12; i++)
 		addPoint(new DrawingItemPoint(QPointF(0.0, 0.0), DrawingItemPoint::Connection, 0));
@@ -521,7 +557,7 @@ void DrawingEllipseItem::setBrush(const QBrush& brush)
 
 void DrawingEllipseItem::setBrushColor(const QColor& color)
 {
-	setPropertyValue("Brush Color", color);
+	setPropertyValue(BrushColorProperty, color);
 }
 
 QBrush DrawingEllipseItem::brush() const
@@ -531,7 +567,7 @@ QBrush DrawingEllipseItem::brush() const
 
 QColor DrawingEllipseItem::brushColor() const
 {
-	return propertyValue("Brush Color").value<QColor>();
+	return propertyValue(BrushColorProperty).value<QColor>();
 }
 
 //==================================================================================================
@@ -553,6 +589,22 @@ QPainterPath DrawingEllipseItem::shape() const
 	return shape;
 }
 
+bool DrawingEllipseItem::shapeContains(const QPointF& itemPos) const
+{
+	QRectF bounds = Drawing::rectFromPoints(point(0)->pos(), point(1)->pos());
+
+	return roundedRectShapeContains(bounds, bounds.width() / 2, bounds.height() / 2,
+		brush().color().alpha() > 0, itemPos);
+}
+
+bool DrawingEllipseItem::shapeIntersects(const QRectF& itemRect) const
+{
+	QRectF bounds = Drawing::rectFromPoints(point(0)->pos(), point(1)->pos());
+
+	return roundedRectShapeIntersects(bounds, bounds.width() / 2, bounds.height() / 2,
+		brush().color().alpha() > 0, itemRect);
+}
+
 //==================================================================================================
 
 void DrawingEllipseItem::render(QPainter* painter, const DrawingStyleOptions& styleOptions)
@@ -577,22 +629,3 @@ void DrawingEllipseItem::resizeItem(DrawingItemPoint* point, const QPointF& pare
 	adjustEllipseControlPoints(point);
 }
 
-//==================================================================================================
-
-void DrawingEllipseItem::writeXmlAttributes(QXmlStreamWriter& xmlWriter, const QList<DrawingItem*>& items)
-{
-	DrawingRectResizeItem::writeXmlAttributes(xmlWriter, items);
-
-	xmlWriter.writeAttribute("brushColor", Drawing::colorToString(brushColor()));
-}
-
-void DrawingEllipseItem::readXmlAttributes(QXmlStreamReader& xmlReader, const QList<DrawingItem*>& items)
-{
-	QXmlStreamAttributes attributes = xmlReader.attributes();
-
-	DrawingRectResizeItem::readXmlAttributes(xmlReader, items);
-
-	if (attributes.hasAttribute("brushColor"))
-		setBrushColor(Drawing::colorFromString(attributes.value("brushColor").toString()));
-}
-
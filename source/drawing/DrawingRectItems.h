@@ -53,11 +53,13 @@ public:
 protected:
 	virtual QVariant aboutToChangeEvent(Reason reason, const QVariant& value);
 
-	virtual void writeXmlAttributes(QXmlStreamWriter& xmlWriter, const QList<DrawingItem*>& items);
-	virtual void readXmlAttributes(QXmlStreamReader& xmlReader, const QList<DrawingItem*>& items);
-
 	void adjustBoxControlPoints(DrawingItemPoint* activePoint);
 	void adjustEllipseControlPoints(DrawingItemPoint* activePoint);
+
+	bool roundedRectShapeContains(const QRectF& rect, qreal xRadius, qreal yRadius, bool filled,
+		const QPointF& itemPos) const;
+	bool roundedRectShapeIntersects(const QRectF& rect, qreal xRadius, qreal yRadius, bool filled,
+		const QRectF& itemRect) const;
 };
 
 //==================================================================================================
@@ -85,6 +87,8 @@ public:
 
 	virtual QRectF boundingRect() const;
 	virtual QPainterPath shape() const;
+	virtual bool shapeContains(const QPointF& itemPos) const;
+	virtual bool shapeIntersects(const QRectF& itemRect) const;
 
 	virtual void render(QPainter* painter, const DrawingStyleOptions& styleOptions);
 
@@ -117,14 +121,12 @@ public:
 
 	virtual QRectF boundingRect() const;
 	virtual QPainterPath shape() const;
+	virtual bool shapeContains(const QPointF& itemPos) const;
+	virtual bool shapeIntersects(const QRectF& itemRect) const;
 
 	virtual void render(QPainter* painter, const DrawingStyleOptions& styleOptions);
 
 	virtual void resizeItem(DrawingItemPoint* point, const QPointF& parentPos);
-
-protected:
-	virtual void writeXmlAttributes(QXmlStreamWriter& xmlWriter, const QList<DrawingItem*>& items);
-	virtual void readXmlAttributes(QXmlStreamReader& xmlReader, const QList<DrawingItem*>& items);
 };
 
 #endif
@@ -37,15 +37,25 @@ DrawingScene::DrawingScene() : QObject()
 
 	mSelectionMode = Qt::ContainsItemBoundingRect;
 	mForcingItemsInside = true;
+	mDeferringDragUpdates = true;
 
 	mNewItem = nullptr;
+	mNextItemId = 1;
 
 	mMouseState = MouseReady;
 	mMouseDownItem = nullptr;
+	mDragItemPoint = nullptr;
 	mNewClickCount = 0;
 	mConsecutivePastes = 0;
 
-	mUndoStack.setUndoLimit(64);
+	mNumberOfItemsDrawn = 0;
+	mNumberOfItemsCulled = 0;
+
+	mPointHash.setCellSize(mGrid);
+
+	// The undo history is limited by the memory its commands use rather than by their number, so
+	// that a large paste counts for more than a small move
+	mUndoStack.setMemoryLimit(64 * 1024 * 1024);
 	connect(&mUndoStack, SIGNAL(cleanChanged(bool)), this, SIGNAL(cleanChanged(bool)));
 	connect(&mUndoStack, SIGNAL(canRedoChanged(bool)), this, SIGNAL(canRedoChanged(bool)));
 	connect(&mUndoStack, SIGNAL(canUndoChanged(bool)), this, SIGNAL(canUndoChanged(bool)));
@@ -70,6 +80,14 @@ DrawingView* DrawingScene::view() const
 void DrawingScene::setUnits(DrawingUnits units)
 {
 	mUnits = units;
+
+	// Items map to the scene through the scene's units
+	const QList<DrawingItem*>& lItems = mItems.items();
+	for(auto itemIter = lItems.begin(); itemIter != lItems.end(); itemIter++)
+		(*itemIter)->invalidateGeometry();
+	if (mNewItem) mNewItem->invalidateSceneGeometry();
+
+	invalidateRect(mSceneRect);
 }
 
 void DrawingScene::updateUnits(DrawingUnits units)
@@ -80,18 +98,24 @@ void DrawingScene::updateUnits(DrawingUnits units)
 
 	if (scaleFactor != 1.0)
 	{
+		invalidateRect(mSceneRect);
+		if (mNewItem) mNewItem->invalidateSceneGeometry();
 		mSceneRect.setRect(mSceneRect.left() * scaleFactor, mSceneRect.top() * scaleFactor,
 			mSceneRect.width() * scaleFactor, mSceneRect.height() * scaleFactor);
 		mContentsRect.setRect(mContentsRect.left() * scaleFactor, mContentsRect.top() * scaleFactor,
 			mContentsRect.width() * scaleFactor, mContentsRect.height() * scaleFactor);
 		mBorderWidth *= scaleFactor;
 		mGrid *= scaleFactor;
+		mPointHash.setCellSize(mGrid);
 
-		for(auto itemIter = mItems.begin(); itemIter != mItems.end(); itemIter++)
+		const QList<DrawingItem*>& lItems = mItems.items();
+		for(auto itemIter = lItems.begin(); itemIter != lItems.end(); itemIter++)
 		{
 			(*itemIter)->setPos((*itemIter)->pos() * scaleFactor);
 			if ((*itemIter)->shouldMatchUnitsWithParent()) (*itemIter)->setUnits(mUnits);
 		}
+
+		invalidateRect(mSceneRect);
 	}
 }
 
@@ -104,17 +128,21 @@ DrawingUnits DrawingScene::units() const
 
 void DrawingScene::setSceneRect(const QRectF& rect)
 {
+	invalidateRect(mSceneRect);
 	mSceneRect = rect;
+	invalidateRect(mSceneRect);
 }
 
 void DrawingScene::setContentsRect(const QRectF& rect)
 {
 	mContentsRect = rect;
+	invalidateRect(mSceneRect);
 }
 
 void DrawingScene::setBorderWidth(qreal borderWidth)
 {
 	mBorderWidth = borderWidth;
+	invalidateRect(mSceneRect);
 }
 
 QRectF DrawingScene::sceneRect() const
@@ -137,6 +165,8 @@ qreal DrawingScene::borderWidth() const
 void DrawingScene::setGrid(qreal grid)
 {
 	mGrid = grid;
+	mPointHash.setCellSize(mGrid);
+	invalidateRect(mSceneRect);
 }
 
 qreal DrawingScene::grid() const
@@ -171,6 +201,11 @@ void DrawingScene::setForcingItemsInside(bool inside)
 	mForcingItemsInside = inside;
 }
 
+void DrawingScene::setDeferringDragUpdates(bool defer)
+{
+	mDeferringDragUpdates = defer;
+}
+
 Qt::ItemSelectionMode DrawingScene::selectionMode() const
 {
 	return mSelectionMode;
@@ -181,14 +216,22 @@ bool DrawingScene::isForcingItemsInside() const
 	return mForcingItemsInside;
 }
 
+bool DrawingScene::isDeferringDragUpdates() const
+{
+	return mDeferringDragUpdates;
+}
+
 //==================================================================================================
 
 void DrawingScene::addItem(DrawingItem* item)
 {
 	if (item && item->parent() == nullptr && !containsItem(item))
 	{
-		mItems.append(item);
+		mItems.appendItem(item);
+		registerItemId(item);
 		item->mScene = this;
+		item->invalidateSceneGeometry();
+		mItemsToReindex.insert(item);
 	}
 }
 
@@ -196,8 +239,11 @@ void DrawingScene::insertItem(int index, DrawingItem* item)
 {
 	if (item && item->parent() == nullptr && !containsItem(item))
 	{
-		mItems.insert(index, item);
+		mItems.insertItem(index, item);
+		registerItemId(item);
 		item->mScene = this;
+		item->invalidateSceneGeometry();
+		mItemsToReindex.insert(item);
 	}
 }
 
@@ -206,8 +252,16 @@ void DrawingScene::removeItem(DrawingItem* item)
 	if (item && containsItem(item))
 	{
 		deselectItem(item);
-		mItems.removeAll(item);
+		mItems.removeItem(item);
+		mItemIds.remove(item->mId);
 		item->mScene = nullptr;
+		item->invalidateSceneGeometry();
+		mItemsToReindex.remove(item);
+		if (mSpatialIndex.containsItem(item)) invalidateRect(mSpatialIndex.itemRect(item));
+		mSpatialIndex.removeItem(item);
+		mUnboundedItems.remove(item);
+		unhashItemPoints(item);
+		item->mStyleId = -1;
 	}
 }
 
@@ -215,44 +269,76 @@ void DrawingScene::clearItems()
 {
 	DrawingItem* item;
 
-	while (!mItems.isEmpty())
+	endDrag();
+
+	while (mItems.numberOfItems() > 0)
 	{
-		item = mItems.first();
+		item = mItems.item(0);
 		removeItem(item);
 		delete item;
 	}
 
 	mMouseDownItem = nullptr;
 	mUndoStack.clear();
+	mStyles.clear();
 }
 
-QList<DrawingItem*> DrawingScene::items() const
+const QList<DrawingItem*>& DrawingScene::items() const
 {
-	return mItems;
+	return mItems.items();
 }
 
 int DrawingScene::numberOfItems() const
 {
-	return mItems.size();
+	return mItems.numberOfItems();
 }
 
 int DrawingScene::itemIndex(DrawingItem* item) const
 {
 	int index = -1;
-	if (item) index = mItems.indexOf(item);
+	if (item) index = mItems.itemIndex(item);
 	return index;
 }
 
 bool DrawingScene::containsItem(DrawingItem* item) const
 {
 	bool result = false;
-	if (item) result = mItems.contains(item);
+	if (item) result = mItems.containsItem(item);
 	return result;
 }
 
+DrawingItem* DrawingScene::itemFromId(quint64 id) const
+{
+	return mItemIds.value(id, nullptr);
+}
+
 void DrawingScene::reorderItems(const QList<DrawingItem*>& items)
 {
-	mItems = items;
+	const QList<DrawingItem*>& lItems = mItems.items();
+
+	// Items that changed their place in the stacking order need to be redrawn
+	for(int itemIndex = 0; itemIndex < items.size(); itemIndex++)
+	{
+		if ((itemIndex >= lItems.size() || lItems[itemIndex] != items[itemIndex]) &&
+			mSpatialIndex.containsItem(items[itemIndex]))
+		{
+			invalidateRect(mSpatialIndex.itemRect(items[itemIndex]));
+		}
+	}
+
+	mItems.setItems(items);
+}
+
+void DrawingScene::reorderItem(DrawingItem* item, int index)
+{
+	// Only the moved item changes its place relative to the others, so only it needs to be redrawn
+	if (item && mItems.containsItem(item) && mItems.itemIndex(item) != index)
+	{
+		mItems.removeItem(item);
+		mItems.insertItem(index, item);
+
+		if (mSpatialIndex.containsItem(item)) invalidateRect(mSpatialIndex.itemRect(item));
+	}
 }
 
 //==================================================================================================
@@ -260,9 +346,9 @@ void DrawingScene::reorderItems(const QList<DrawingItem*>& items)
 QList<DrawingItem*> DrawingScene::items(const QRectF& sceneRect) const
 {
 	QList<DrawingItem*> itemsInRect;
-	QRectF itemRect;
+	QList<DrawingItem*> candidates = indexedItems(sceneRect);
 
-	for(auto itemIter = mItems.begin(); itemIter != mItems.end(); itemIter++)
+	for(auto itemIter = candidates.begin(); itemIter != candidates.end(); itemIter++)
 	{
 		if (itemMatchesRect(*itemIter, sceneRect, mSelectionMode))
 			itemsInRect.append(*itemIter);
@@ -274,13 +360,12 @@ QList<DrawingItem*> DrawingScene::items(const QRectF& sceneRect) const
 QList<DrawingItem*> DrawingScene::childItems(const QRectF& sceneRect) const
 {
 	QList<DrawingItem*> itemsInRect;
-	QList<DrawingItem*> children;
-	QRectF itemRect;
+	QList<DrawingItem*> candidates = indexedItems(sceneRect);
 
-	for(auto itemIter = mItems.begin(); itemIter != mItems.end(); itemIter++)
+	for(auto itemIter = candidates.begin(); itemIter != candidates.end(); itemIter++)
 	{
-		children = (*itemIter)->children();
-		for(auto childIter = mItems.begin(); childIter != mItems.end(); childIter++)
+		const QList<DrawingItem*>& children = (*itemIter)->children();
+		for(auto childIter = children.begin(); childIter != children.end(); childIter++)
 		{
 			if (itemMatchesRect(*childIter, sceneRect, mSelectionMode))
 				itemsInRect.append(*childIter);
@@ -293,18 +378,26 @@ QList<DrawingItem*> DrawingScene::childItems(const QRectF& sceneRect) const
 DrawingItem* DrawingScene::itemAt(const QPointF& scenePos) const
 {
 	DrawingItem* item = nullptr;
+	DrawingItem* topLevelItem;
+	QList<DrawingItem*> candidates = indexedItems(QRectF(scenePos, QSizeF(0, 0)));
+	QSet<DrawingItem*> candidateSet = candidates.toSet();
 
 	// Favor selected items
-	auto itemIter = mSelectedItems.end();
-	while (item == nullptr && itemIter != mSelectedItems.begin())
+	const QList<DrawingItem*>& lSelectedItems = mSelectedItems.items();
+	auto itemIter = lSelectedItems.end();
+	while (item == nullptr && itemIter != lSelectedItems.begin())
 	{
 		itemIter--;
-		if (itemMatchesPoint(*itemIter, scenePos)) item = *itemIter;
+
+		topLevelItem = *itemIter;
+		while (topLevelItem->parent()) topLevelItem = topLevelItem->parent();
+
+		if (candidateSet.contains(topLevelItem) && itemMatchesPoint(*itemIter, scenePos)) item = *itemIter;
 	}
 
-	// Search all items
-	itemIter = mItems.end();
-	while (item == nullptr && itemIter != mItems.begin())
+	// Search all items near scenePos
+	itemIter = candidates.end();
+	while (item == nullptr && itemIter != candidates.begin())
 	{
 		itemIter--;
 		if (itemMatchesPoint(*itemIter, scenePos)) item = *itemIter;
@@ -316,23 +409,30 @@ DrawingItem* DrawingScene::itemAt(const QPointF& scenePos) const
 DrawingItem* DrawingScene::childAt(const QPointF& scenePos) const
 {
 	DrawingItem* item = nullptr;
-	QList<DrawingItem*> children;
+	DrawingItem* topLevelItem;
+	QList<DrawingItem*> candidates = indexedItems(QRectF(scenePos, QSizeF(0, 0)));
+	QSet<DrawingItem*> candidateSet = candidates.toSet();
 
 	// Favor selected items
-	auto itemIter = mSelectedItems.end();
-	while (item == nullptr && itemIter != mSelectedItems.begin())
+	const QList<DrawingItem*>& lSelectedItems = mSelectedItems.items();
+	auto itemIter = lSelectedItems.end();
+	while (item == nullptr && itemIter != lSelectedItems.begin())
 	{
 		itemIter--;
-		if (itemMatchesPoint(*itemIter, scenePos)) item = *itemIter;
+
+		topLevelItem = *itemIter;
+		while (topLevelItem->parent()) topLevelItem = topLevelItem->parent();
+
+		if (candidateSet.contains(topLevelItem) && itemMatchesPoint(*itemIter, scenePos)) item = *itemIter;
 	}
 
-	// Search all items
-	itemIter = mItems.end();
-	while (item == nullptr && itemIter != mItems.begin())
+	// Search all items near scenePos
+	itemIter = candidates.end();
+	while (item == nullptr && itemIter != candidates.begin())
 	{
 		itemIter--;
 
-		children = (*itemIter)->children();
+		const QList<DrawingItem*>& children = (*itemIter)->children();
 		for(auto childIter = children.begin(); item == nullptr && childIter != children.end(); childIter++)
 		{
 			if (itemMatchesPoint(*childIter, scenePos)) item = *childIter;
@@ -344,12 +444,13 @@ DrawingItem* DrawingScene::childAt(const QPointF& scenePos) const
 
 QRectF DrawingScene::itemsRect() const
 {
+	const QList<DrawingItem*>& lItems = mItems.items();
 	QRectF rect;
 
-	for(auto itemIter = mItems.begin(); itemIter != mItems.end(); itemIter++)
+	for(auto itemIter = lItems.begin(); itemIter != lItems.end(); itemIter++)
 	{
-		if (!rect.isValid()) rect = (*itemIter)->boundingRect().translated((*itemIter)->pos());
-		else rect = rect.united((*itemIter)->boundingRect().translated((*itemIter)->pos()));
+		if (!rect.isValid()) rect = (*itemIter)->sceneBoundingRect();
+		else rect = rect.united((*itemIter)->sceneBoundingRect());
 	}
 
 	return rect;
@@ -357,9 +458,10 @@ QRectF DrawingScene::itemsRect() const
 
 QRectF DrawingScene::itemsShapeRect() const
 {
+	const QList<DrawingItem*>& lItems = mItems.items();
 	QRectF rect;
 
-	for(auto itemIter = mItems.begin(); itemIter != mItems.end(); itemIter++)
+	for(auto itemIter = lItems.begin(); itemIter != lItems.end(); itemIter++)
 	{
 		if (!rect.isValid())
 			rect = (*itemIter)->shape().boundingRect().translated((*itemIter)->pos());
@@ -370,6 +472,22 @@ QRectF DrawingScene::itemsShapeRect() const
 	return rect;
 }
 
+QList<DrawingItemPoint*> DrawingScene::connectionPoints(const QRectF& sceneRect) const
+{
+	updateSpatialIndex();
+	return mPointHash.points(sceneRect);
+}
+
+int DrawingScene::numberOfItemsDrawn() const
+{
+	return mNumberOfItemsDrawn;
+}
+
+int DrawingScene::numberOfItemsCulled() const
+{
+	return mNumberOfItemsCulled;
+}
+
 //==================================================================================================
 
 void DrawingScene::setNewItem(DrawingItem* item)
@@ -382,6 +500,7 @@ void DrawingScene::setNewItem(DrawingItem* item)
 	if (mNewItem)
 	{
 		mNewItem->mScene = this;
+		mNewItem->invalidateSceneGeometry();
 		if (mNewItem->shouldMatchUnitsWithParent()) mNewItem->setUnits(units());
 	}
 }
@@ -401,8 +520,13 @@ void DrawingScene::selectItem(DrawingItem* item)
 		for(int i = 0; i < item->numberOfChildren(); i++)
 			deselectItem(item->child(i));
 
+		// The item moves from the static layer to the overlay, so the area it covered in the static
+		// layer needs to be redrawn
+		updateSpatialIndex();
+		if (mSpatialIndex.containsItem(item)) invalidateRect(mSpatialIndex.itemRect(item));
+
 		item->setSelected(true);
-		mSelectedItems.append(item);
+		mSelectedItems.appendItem(item);
 	}
 }
 
@@ -410,26 +534,51 @@ void DrawingScene::deselectItem(DrawingItem* item)
 {
 	if (item && item->isSelected())
 	{
-		mSelectedItems.removeAll(item);
+		mSelectedItems.removeItem(item);
 		item->setSelected(false);
+
+		// The item moves back to the static layer wherever it ended up while it was selected
+		if (item->mScene == this) mItemsToReindex.insert(item);
 	}
 }
 
 void DrawingScene::selectItems(const QRectF& sceneRect)
 {
-	QList<DrawingItem*> lItems = items(sceneRect);
+	selectItems(items(sceneRect));
+}
+
+void DrawingScene::selectItems(const QList<DrawingItem*>& items)
+{
+	for(auto itemIter = items.begin(); itemIter != items.end(); itemIter++) selectItem(*itemIter);
+}
+
+void DrawingScene::deselectItems(const QList<DrawingItem*>& items)
+{
+	for(auto itemIter = items.begin(); itemIter != items.end(); itemIter++) deselectItem(*itemIter);
+}
+
+void DrawingScene::clearSelection()
+{
+	const QList<DrawingItem*>& lSelectedItems = mSelectedItems.items();
+
+	// Same as calling deselectItem for each item, but the selection is emptied in one step
+	for(auto itemIter = lSelectedItems.begin(); itemIter != lSelectedItems.end(); itemIter++)
+	{
+		(*itemIter)->setSelected(false);
+		if ((*itemIter)->mScene == this) mItemsToReindex.insert(*itemIter);
+	}
 
-	for(auto itemIter = lItems.begin();	itemIter != lItems.end(); itemIter++) selectItem(*itemIter);
+	mSelectedItems.clear();
 }
 
-QList<DrawingItem*> DrawingScene::selectedItems() const
+const QList<DrawingItem*>& DrawingScene::selectedItems() const
 {
-	return mSelectedItems;
+	return mSelectedItems.items();
 }
 
 int DrawingScene::numberOfSelectedItems() const
 {
-	return mSelectedItems.size();
+	return mSelectedItems.numberOfItems();
 }
 
 //==================================================================================================
@@ -439,11 +588,46 @@ void DrawingScene::setUndoLimit(int undoLimit)
 	mUndoStack.setUndoLimit(undoLimit);
 }
 
+void DrawingScene::setUndoMemoryLimit(qint64 bytes)
+{
+	mUndoStack.setMemoryLimit(bytes);
+}
+
+void DrawingScene::setJournal(DrawingJournal* journal)
+{
+	mUndoStack.setJournal(journal);
+}
+
+DrawingJournal* DrawingScene::journal() const
+{
+	return mUndoStack.journal();
+}
+
 void DrawingScene::setClean()
 {
 	mUndoStack.setClean();
 }
 
+void DrawingScene::resetClean()
+{
+	mUndoStack.resetClean();
+}
+
+void DrawingScene::setSavePoint()
+{
+	mUndoStack.setSavePoint();
+}
+
+void DrawingScene::commitSavePoint()
+{
+	mUndoStack.commitSavePoint();
+}
+
+void DrawingScene::discardSavePoint()
+{
+	mUndoStack.discardSavePoint();
+}
+
 void DrawingScene::pushUndo(QUndoCommand* command)
 {
 	mUndoStack.push(command);
@@ -454,6 +638,16 @@ int DrawingScene::undoLimit() const
 	return mUndoStack.undoLimit();
 }
 
+qint64 DrawingScene::undoMemoryLimit() const
+{
+	return mUndoStack.memoryLimit();
+}
+
+qint64 DrawingScene::undoMemoryUsage() const
+{
+	return mUndoStack.memoryUsage();
+}
+
 bool DrawingScene::isClean() const
 {
 	return mUndoStack.isClean();
@@ -506,7 +700,7 @@ void DrawingScene::cut()
 void DrawingScene::copy()
 {
 	QClipboard* clipboard = QApplication::clipboard();
-	if (clipboard && !mSelectedItems.isEmpty())
+	if (clipboard && mSelectedItems.numberOfItems() > 0)
 	{
 		QString xmlItems;
 		QXmlStreamWriter xmlWriter(&xmlItems);
@@ -515,7 +709,7 @@ void DrawingScene::copy()
 		xmlWriter.setAutoFormattingIndent(-1);
 
 		xmlWriter.writeStartElement("items");
-		DrawingItem::writeItemsToXml(xmlWriter, mSelectedItems);
+		DrawingItem::writeItemsToXml(xmlWriter, mSelectedItems.items());
 		xmlWriter.writeEndElement();
 
 		clipboard->setText(xmlItems);
@@ -561,9 +755,8 @@ void DrawingScene::paste()
 			addItems(newItems, DoNotPlace);
 
 			// Ensure new items are selected
-			deselectAll();
-			for(auto itemIter = newItems.begin(); itemIter != newItems.end(); itemIter++)
-				selectItem(*itemIter);
+			clearSelection();
+			selectItems(newItems);
 			emit selectionChanged();
 
 			mConsecutivePastes++;
@@ -579,13 +772,13 @@ void DrawingScene::paste()
 
 void DrawingScene::selectAll()
 {
-	for(auto itemIter = mItems.begin(); itemIter != mItems.end(); itemIter++) selectItem(*itemIter);
+	selectItems(mItems.items());
 	emit selectionChanged();
 }
 
 void DrawingScene::deselectAll()
 {
-	while (!mSelectedItems.empty()) deselectItem(mSelectedItems.last());
+	clearSelection();
 	emit selectionChanged();
 }
 
@@ -600,8 +793,8 @@ void DrawingScene::rotateSelection()
 	}
 	else
 	{
-		if (mSelectedItems.size() > 0 && tryRotate(mSelectedItems, mSelectionCenter))
-			rotateItems(mSelectedItems, mSelectionCenter);
+		if (mSelectedItems.numberOfItems() > 0 && tryRotate(mSelectedItems.items(), mSelectionCenter))
+			rotateItems(mSelectedItems.items(), mSelectionCenter);
 	}
 }
 
@@ -614,8 +807,8 @@ void DrawingScene::rotateBackSelection()
 	}
 	else
 	{
-		if (mSelectedItems.size() > 0 && tryRotateBack(mSelectedItems, mSelectionCenter))
-			rotateBackItems(mSelectedItems, mSelectionCenter);
+		if (mSelectedItems.numberOfItems() > 0 && tryRotateBack(mSelectedItems.items(), mSelectionCenter))
+			rotateBackItems(mSelectedItems.items(), mSelectionCenter);
 	}
 }
 
@@ -628,8 +821,8 @@ void DrawingScene::flipSelection()
 	}
 	else
 	{
-		if (mSelectedItems.size() > 0 && tryFlip(mSelectedItems, mSelectionCenter))
-			flipItems(mSelectedItems, mSelectionCenter);
+		if (mSelectedItems.numberOfItems() > 0 && tryFlip(mSelectedItems.items(), mSelectionCenter))
+			flipItems(mSelectedItems.items(), mSelectionCenter);
 	}
 }
 
@@ -637,9 +830,10 @@ void DrawingScene::deleteSelection()
 {
 	if (numberOfSelectedItems() > 0)
 	{
+		const QList<DrawingItem*>& lSelectedItems = mSelectedItems.items();
 		QList<DrawingItem*> items;
 
-		for(auto itemIter = mSelectedItems.begin(); itemIter != mSelectedItems.end(); itemIter++)
+		for(auto itemIter = lSelectedItems.begin(); itemIter != lSelectedItems.end(); itemIter++)
 		{
 			if ((*itemIter)->parent() == nullptr) items.append(*itemIter);
 		}
@@ -652,8 +846,9 @@ void DrawingScene::deleteSelection()
 
 void DrawingScene::sendBackward()
 {
-	QList<DrawingItem*> lItems = mSelectedItems;
-	QList<DrawingItem*> lItemsOrdered = mItems;
+	QList<DrawingItem*> lItems = mSelectedItems.items();
+	QList<DrawingItem*> lMovedItems;
+	QList<int> lOriginalIndices, lNewIndices;
 
 	DrawingItem* item;
 	qint32 index;
@@ -661,21 +856,24 @@ void DrawingScene::sendBackward()
 	while (!lItems.empty())
 	{
 		item = lItems.takeLast();
-		index = lItemsOrdered.indexOf(item);
+		index = mItems.itemIndex(item);
 		if (index > 0)
 		{
-			lItemsOrdered.removeAll(item);
-			lItemsOrdered.insert(index - 1, item);
+			lMovedItems.append(item);
+			lOriginalIndices.append(index);
+			lNewIndices.append(index - 1);
+			reorderItem(item, index - 1);
 		}
 	}
 
-	mUndoStack.push(new DrawingReorderItemsCommand(this, lItemsOrdered));
+	pushReorderCommand(lMovedItems, lOriginalIndices, lNewIndices);
 }
 
 void DrawingScene::bringForward()
 {
-	QList<DrawingItem*> lItems = mSelectedItems;
-	QList<DrawingItem*> lItemsOrdered = mItems;
+	QList<DrawingItem*> lItems = mSelectedItems.items();
+	QList<DrawingItem*> lMovedItems;
+	QList<int> lOriginalIndices, lNewIndices;
 
 	DrawingItem* item;
 	qint32 index;
@@ -683,55 +881,81 @@ void DrawingScene::bringForward()
 	while (!lItems.empty())
 	{
 		item = lItems.takeLast();
-		index = lItemsOrdered.indexOf(item);
-		if (index >= 0)
+		index = mItems.itemIndex(item);
+		if (index >= 0 && index < mItems.numberOfItems() - 1)
 		{
-			lItemsOrdered.removeAll(item);
-			lItemsOrdered.insert(index + 1, item);
+			lMovedItems.append(item);
+			lOriginalIndices.append(index);
+			lNewIndices.append(index + 1);
+			reorderItem(item, index + 1);
 		}
 	}
 
-	mUndoStack.push(new DrawingReorderItemsCommand(this, lItemsOrdered));
+	pushReorderCommand(lMovedItems, lOriginalIndices, lNewIndices);
 }
 
 void DrawingScene::sendToBack()
 {
-	QList<DrawingItem*> lItems = mSelectedItems;
-	QList<DrawingItem*> lItemsOrdered = mItems;
+	QList<DrawingItem*> lItems = mSelectedItems.items();
+	QList<DrawingItem*> lMovedItems;
+	QList<int> lOriginalIndices, lNewIndices;
 
 	DrawingItem* item;
+	qint32 index;
 
 	while (!lItems.empty())
 	{
 		item = lItems.takeLast();
-		if (lItemsOrdered.contains(item))
+		index = mItems.itemIndex(item);
+		if (index > 0)
 		{
-			lItemsOrdered.removeAll(item);
-			lItemsOrdered.prepend(item);
+			lMovedItems.append(item);
+			lOriginalIndices.append(index);
+			lNewIndices.append(0);
+			reorderItem(item, 0);
 		}
 	}
 
-	mUndoStack.push(new DrawingReorderItemsCommand(this, lItemsOrdered));
+	pushReorderCommand(lMovedItems, lOriginalIndices, lNewIndices);
 }
 
 void DrawingScene::bringToFront()
 {
-	QList<DrawingItem*> lItems = mSelectedItems;
-	QList<DrawingItem*> lItemsOrdered = mItems;
+	QList<DrawingItem*> lItems = mSelectedItems.items();
+	QList<DrawingItem*> lMovedItems;
+	QList<int> lOriginalIndices, lNewIndices;
 
 	DrawingItem* item;
+	qint32 index;
 
 	while (!lItems.empty())
 	{
 		item = lItems.takeLast();
-		if (lItemsOrdered.contains(item))
+		index = mItems.itemIndex(item);
+		if (index >= 0 && index < mItems.numberOfItems() - 1)
 		{
-			lItemsOrdered.removeAll(item);
-			lItemsOrdered.append(item);
+			lMovedItems.append(item);
+			lOriginalIndices.append(index);
+			lNewIndices.append(mItems.numberOfItems() - 1);
+			reorderItem(item, mItems.numberOfItems() - 1);
 		}
 	}
 
-	mUndoStack.push(new DrawingReorderItemsCommand(this, lItemsOrdered));
+	pushReorderCommand(lMovedItems, lOriginalIndices, lNewIndices);
+}
+
+void DrawingScene::pushReorderCommand(const QList<DrawingItem*>& items,
+	const QList<int>& originalIndices, const QList<int>& newIndices)
+{
+	// The items have already been reordered; put them back so that pushing the command redoes it
+	if (!items.isEmpty())
+	{
+		DrawingReorderItemsCommand* reorderCommand =
+			new DrawingReorderItemsCommand(this, items, originalIndices, newIndices);
+
+		reorderCommand->undo();
+		mUndoStack.push(reorderCommand);
+	}
 }
 
 //==================================================================================================
@@ -739,7 +963,7 @@ void DrawingScene::bringToFront()
 void DrawingScene::insertItemPoint()
 {
 	DrawingItem* item = nullptr;
-	if (mSelectedItems.size() == 1) item = mSelectedItems.first();
+	if (mSelectedItems.numberOfItems() == 1) item = mSelectedItems.item(0);
 
 	if (item && item->canInsertRemovePoints())
 	{
@@ -758,7 +982,7 @@ void DrawingScene::insertItemPoint()
 void DrawingScene::removeItemPoint()
 {
 	DrawingItem* item = nullptr;
-	if (mSelectedItems.size() == 1) item = mSelectedItems.first();
+	if (mSelectedItems.numberOfItems() == 1) item = mSelectedItems.item(0);
 
 	if (item && item->canInsertRemovePoints())
 	{
@@ -834,10 +1058,11 @@ void DrawingScene::ungroup()
 
 void DrawingScene::updateSelectionCenter()
 {
+	const QList<DrawingItem*>& lSelectedItems = mSelectedItems.items();
 	int count = 0;
 
 	mSelectionCenter = QPointF(0.0, 0.0);
-	for(auto itemIter = mSelectedItems.begin(); itemIter != mSelectedItems.end(); itemIter++)
+	for(auto itemIter = lSelectedItems.begin(); itemIter != lSelectedItems.end(); itemIter++)
 	{
 		mSelectionCenter += (*itemIter)->mapToScene((*itemIter)->centerPos());
 		count++;
@@ -857,12 +1082,12 @@ bool DrawingScene::itemMatchesPoint(DrawingItem* item, const QPointF& scenePos)
 	if (item)
 	{
 		// Check item shape
-		match = item->shape().contains(item->mapFromScene(scenePos));
+		match = item->shapeContains(item->mapFromScene(scenePos));
 
 		// Check item points
 		if (!match && item->isSelected())
 		{
-			QList<DrawingItemPoint*> itemPoints = item->points();
+			const QList<DrawingItemPoint*>& itemPoints = item->points();
 			for(auto pointIter = itemPoints.begin(); !match && pointIter != itemPoints.end(); pointIter++)
 				match = (*pointIter)->sceneRect().contains(scenePos);
 		}
@@ -881,23 +1106,23 @@ bool DrawingScene::itemMatchesRect(DrawingItem* item, const QRectF& rect, Qt::It
 		switch (mode)
 		{
 		case Qt::IntersectsItemShape:
-			match = item->shape().intersects(item->mapFromScene(rect));
+			match = item->shapeIntersects(item->mapFromScene(rect));
 			break;
 		case Qt::ContainsItemShape:
 			match = rect.contains(Drawing::adjustRectForMinimumSize(item->mapToScene(item->shape().boundingRect())));
 			break;
 		case Qt::IntersectsItemBoundingRect:
-			match = rect.intersects(Drawing::adjustRectForMinimumSize(item->mapToScene(item->boundingRect())));
+			match = rect.intersects(Drawing::adjustRectForMinimumSize(item->sceneBoundingRect()));
 			break;
 		default:	// Qt::ContainsItemBoundingRect
-			match = rect.contains(Drawing::adjustRectForMinimumSize(item->mapToScene(item->boundingRect())));
+			match = rect.contains(Drawing::adjustRectForMinimumSize(item->sceneBoundingRect()));
 			break;
 		}
 
 		// Check item points
 		if (!match && item->isSelected())
 		{
-			QList<DrawingItemPoint*> itemPoints = item->points();
+			const QList<DrawingItemPoint*>& itemPoints = item->points();
 			for(auto pointIter = itemPoints.begin(); !match && pointIter != itemPoints.end(); pointIter++)
 			{
 				if (mode == Qt::IntersectsItemBoundingRect || mode == Qt::IntersectsItemShape)
@@ -925,7 +1150,7 @@ void DrawingScene::contextMenuEvent(DrawingMouseEvent& event)
 		if (mMouseDownItem)
 			mMouseDownItemPos = mMouseDownItem->mapFromScene(event.buttonDownScenePos());
 
-		if (mMouseDownItem && mMouseDownItem->isSelected() && mSelectedItems.size() == 1)
+		if (mMouseDownItem && mMouseDownItem->isSelected() && mSelectedItems.numberOfItems() == 1)
 			mMouseDownItem->contextMenuEvent(event);
 	}
 }
@@ -936,7 +1161,7 @@ void DrawingScene::mouseDoubleClickEvent(DrawingMouseEvent& event)
 
 	if (!mNewItem)
 	{
-		if (mMouseDownItem && mMouseDownItem->isSelected() && mSelectedItems.size() == 1)
+		if (mMouseDownItem && mMouseDownItem->isSelected() && mSelectedItems.numberOfItems() == 1)
 			mMouseDownItem->mouseDoubleClickEvent(event);
 	}
 }
@@ -955,7 +1180,7 @@ void DrawingScene::mousePressEvent(DrawingMouseEvent& event)
 		if (mMouseDownItem)
 			mMouseDownItemPos = mMouseDownItem->mapFromScene(event.buttonDownScenePos());
 
-		if (mMouseDownItem && mMouseDownItem->isSelected() && mSelectedItems.size() == 1)
+		if (mMouseDownItem && mMouseDownItem->isSelected() && mSelectedItems.numberOfItems() == 1)
 			mMouseDownItem->mousePressEvent(event);
 	}
 	else newMousePressEvent(event);
@@ -967,6 +1192,7 @@ void DrawingScene::mouseMoveEvent(DrawingMouseEvent& event)
 
 	if (!mNewItem)
 	{
+		QList<DrawingItem*> lSelectedItems;
 		QPointF deltaPos;
 		bool canMove = true;
 
@@ -979,23 +1205,28 @@ void DrawingScene::mouseMoveEvent(DrawingMouseEvent& event)
 				{
 					if (mMouseDownItem && mMouseDownItem->isSelected())
 					{
-						bool resizeItem = (mSelectedItems.size() == 1 &&
-										   mSelectedItems.first()->hasSelectedPoint() &&
-										   mSelectedItems.first()->selectedPoint()->isControlPoint());
+						bool resizeItem = (mSelectedItems.numberOfItems() == 1 &&
+										   mSelectedItems.item(0)->hasSelectedPoint() &&
+										   mSelectedItems.item(0)->selectedPoint()->isControlPoint());
 						mMouseState = (resizeItem) ? MouseResizeItem : MouseMoveItems;
+
+						if (mDeferringDragUpdates)
+							beginDrag(mSelectedItems.items(), (resizeItem) ? mMouseDownItem->selectedPoint() : nullptr);
 					}
 					else mMouseState = MouseRubberBand;
 				}
 				break;
 
 			case MouseMoveItems:
-				for(auto itemIter = mSelectedItems.begin();	canMove && itemIter != mSelectedItems.end(); itemIter++)
+				lSelectedItems = mSelectedItems.items();
+				for(auto itemIter = lSelectedItems.begin();	canMove && itemIter != lSelectedItems.end(); itemIter++)
 					canMove = (*itemIter)->canMove();
 
 				if (canMove)
 				{
-					deltaPos = tryMove(mSelectedItems, roundToGrid(event.scenePos()) - roundToGrid(mMouseDownItem->mapToScene(mMouseDownItemPos)));
-					moveItems(mSelectedItems, deltaPos, DoNotPlace);
+					deltaPos = tryMove(lSelectedItems, roundToGrid(event.scenePos()) - roundToGrid(mMouseDownItem->mapToScene(mMouseDownItemPos)));
+					if (mDeferringDragUpdates) dragItems(lSelectedItems, deltaPos);
+					else moveItems(lSelectedItems, deltaPos, DoNotPlace);
 					emit selectionChanged();
 				}
 				break;
@@ -1003,8 +1234,16 @@ void DrawingScene::mouseMoveEvent(DrawingMouseEvent& event)
 			case MouseResizeItem:
 				if (mMouseDownItem->canResize())
 				{
-					resizeItem(mMouseDownItem->selectedPoint(),
-						tryResize(mMouseDownItem->selectedPoint(), roundToGrid(event.scenePos())), DoNotPlace, true);
+					if (mDeferringDragUpdates)
+					{
+						dragItemPoint(mMouseDownItem->selectedPoint(),
+							tryResize(mMouseDownItem->selectedPoint(), roundToGrid(event.scenePos())));
+					}
+					else
+					{
+						resizeItem(mMouseDownItem->selectedPoint(),
+							tryResize(mMouseDownItem->selectedPoint(), roundToGrid(event.scenePos())), DoNotPlace, true);
+					}
 					emit selectionChanged();
 				}
 				break;
@@ -1013,7 +1252,7 @@ void DrawingScene::mouseMoveEvent(DrawingMouseEvent& event)
 				break;
 			}
 
-			if (mMouseDownItem && mMouseDownItem->isSelected() && mSelectedItems.size() == 1)
+			if (mMouseDownItem && mMouseDownItem->isSelected() && mSelectedItems.numberOfItems() == 1)
 				mMouseDownItem->mouseMoveEvent(event);
 		}
 	}
@@ -1024,9 +1263,14 @@ void DrawingScene::mouseReleaseEvent(DrawingMouseEvent& event)
 {
 	mLastMouseEvent = event;
 
+	// Return any dragged items to where they started so that the move or resize below is recorded
+	// as a single undoable change
+	endDrag();
+
 	if (!mNewItem)
 	{
 		bool controlDown = ((event.modifiers() & Qt::ControlModifier) != 0);
+		QList<DrawingItem*> lSelectedItems;
 		bool canMove = true;
 		QPointF deltaPos;
 		DrawingItemPlaceMode placeMode = (event.modifiers() & Qt::ShiftModifier) ? PlaceStrict : PlaceLoose;
@@ -1034,25 +1278,25 @@ void DrawingScene::mouseReleaseEvent(DrawingMouseEvent& event)
 		switch (mMouseState)
 		{
 		case MouseSelect:
-			if (!controlDown) deselectAll();
+			if (!controlDown) clearSelection();
 			if (mMouseDownItem)
 			{
 				if (controlDown && mMouseDownItem->isSelected())
 					deselectItem(mMouseDownItem);
 				else selectItem(mMouseDownItem);
-
-				emit selectionChanged();
 			}
+			if (!controlDown || mMouseDownItem) emit selectionChanged();
 			break;
 
 		case MouseMoveItems:
-			for(auto itemIter = mSelectedItems.begin(); canMove && itemIter != mSelectedItems.end(); itemIter++)
+			lSelectedItems = mSelectedItems.items();
+			for(auto itemIter = lSelectedItems.begin(); canMove && itemIter != lSelectedItems.end(); itemIter++)
 				canMove = (*itemIter)->canMove();
 
 			if (canMove)
 			{
-				deltaPos = tryMove(mSelectedItems, roundToGrid(event.scenePos()) - roundToGrid(mMouseDownItem->mapToScene(mMouseDownItemPos)));
-				moveItems(mSelectedItems, deltaPos, placeMode);
+				deltaPos = tryMove(lSelectedItems, roundToGrid(event.scenePos()) - roundToGrid(mMouseDownItem->mapToScene(mMouseDownItemPos)));
+				moveItems(lSelectedItems, deltaPos, placeMode);
 				emit selectionChanged();
 			}
 			break;
@@ -1067,7 +1311,7 @@ void DrawingScene::mouseReleaseEvent(DrawingMouseEvent& event)
 			break;
 
 		case MouseRubberBand:
-			if (!controlDown) deselectAll();
+			if (!controlDown) clearSelection();
 			selectItems(Drawing::rectFromPoints(event.scenePos(), event.buttonDownScenePos()));
 			emit selectionChanged();
 			break;
@@ -1076,7 +1320,7 @@ void DrawingScene::mouseReleaseEvent(DrawingMouseEvent& event)
 			break;
 		}
 
-		if (mMouseDownItem && mMouseDownItem->isSelected() && mSelectedItems.size() == 1)
+		if (mMouseDownItem && mMouseDownItem->isSelected() && mSelectedItems.numberOfItems() == 1)
 			mMouseDownItem->mouseReleaseEvent(event);
 
 		mMouseState = MouseReady;
@@ -1137,7 +1381,7 @@ void DrawingScene::newMouseReleaseEvent(DrawingMouseEvent& event)
 		bool adjustPoints = false;
 		DrawingItemPlaceMode placeMode = (event.modifiers() & Qt::ShiftModifier) ? PlaceStrict : PlaceLoose;
 
-		QRectF newItemRect = Drawing::adjustRectForMinimumSize(mNewItem->mapToScene(mNewItem->boundingRect()));
+		QRectF newItemRect = Drawing::adjustRectForMinimumSize(mNewItem->sceneBoundingRect());
 		if (!mNewItem->isSuperfluous() && (!mForcingItemsInside || contentsRect().contains(newItemRect)))
 		{
 			itemAdded = (mNewItem->placeType() != DrawingItem::PlaceTwoClick ||
@@ -1335,26 +1579,26 @@ void DrawingScene::disconnectItemPoints(DrawingItemPoint* point0, DrawingItemPoi
 
 void DrawingScene::placeItems(const QList<DrawingItem*>& items, DrawingItemPlaceMode placeMode,	QUndoCommand* command)
 {
-	QList<DrawingItemPoint*> itemPoints, otherItemPoints;
+	QList<DrawingItemPoint*> otherItemPoints;
 
 	if (placeMode != DoNotPlace)
 	{
+		QSet<DrawingItem*> itemSet = items.toSet();
+
 		for(auto itemIter = items.begin(); itemIter != items.end(); itemIter++)
 		{
-			for(auto otherItemIter = mItems.begin(); otherItemIter != mItems.end(); otherItemIter++)
+			const QList<DrawingItemPoint*>& itemPoints = (*itemIter)->points();
+
+			for(auto itemPointIter = itemPoints.begin(); itemPointIter != itemPoints.end(); itemPointIter++)
 			{
-				if (!items.contains(*otherItemIter) && (mNewItem == nullptr || (*otherItemIter) != mNewItem))
-				{
-					itemPoints = (*itemIter)->points();
-					otherItemPoints = (*otherItemIter)->points();
+				otherItemPoints = (*itemPointIter)->connectionCandidates(placeMode);
 
-					for(auto itemPointIter = itemPoints.begin(); itemPointIter != itemPoints.end(); itemPointIter++)
+				for(auto otherItemPointIter = otherItemPoints.begin(); otherItemPointIter != otherItemPoints.end(); otherItemPointIter++)
+				{
+					if (!itemSet.contains((*otherItemPointIter)->item()) &&
+						(*itemPointIter)->shouldConnect(*otherItemPointIter, placeMode))
 					{
-						for(auto otherItemPointIter = otherItemPoints.begin(); otherItemPointIter != otherItemPoints.end(); otherItemPointIter++)
-						{
-							if ((*itemPointIter)->shouldConnect(*otherItemPointIter, placeMode))
-								connectItemPoints(*itemPointIter, *otherItemPointIter, command);
-						}
+						connectItemPoints(*itemPointIter, *otherItemPointIter, command);
 					}
 				}
 			}
@@ -1376,20 +1620,23 @@ void DrawingScene::unplaceItems(const QList<DrawingItem*>& items, QUndoCommand*
 {
 	DrawingItem* item;
 	DrawingItemPoint* itemPoint;
-	QList<DrawingItemPoint*> itemPoints, targetPoints;
+	DrawingItemPoint::TargetList targetPoints;
+	QSet<DrawingItem*> itemSet = items.toSet();
 
 	for(auto itemIter = items.begin(); itemIter != items.end(); itemIter++)
 	{
 		item = *itemIter;
-		itemPoints = item->points();
+		const QList<DrawingItemPoint*>& itemPoints = item->points();
 
 		for(auto itemPointIter = itemPoints.begin(); itemPointIter != itemPoints.end(); itemPointIter++)
 		{
 			itemPoint = *itemPointIter;
-			targetPoints = itemPoint->targets();
+
+			// Disconnecting changes the point's targets, so iterate over a copy
+			targetPoints = itemPoint->targetList();
 			for(auto targetPointIter = targetPoints.begin(); targetPointIter != targetPoints.end(); targetPointIter++)
 			{
-				if (!items.contains((*targetPointIter)->item()))
+				if (!itemSet.contains((*targetPointIter)->item()))
 					disconnectItemPoints(itemPoint, *targetPointIter, command);
 			}
 		}
@@ -1411,7 +1658,7 @@ void DrawingScene::unplaceItems(DrawingItem* item, QUndoCommand* command)
 void DrawingScene::tryToMaintainConnections(const QList<DrawingItem*>& items, bool allowResize,
 	bool checkControlPoints, DrawingItemPoint* pointToSkip, QUndoCommand* command)
 {
-	QList<DrawingItemPoint*> itemPoints, targetPoints;
+	DrawingItemPoint::TargetList targetPoints;
 	DrawingItem* item;
 	DrawingItem* targetItem;
 	DrawingItemPoint* itemPoint;
@@ -1420,14 +1667,15 @@ void DrawingScene::tryToMaintainConnections(const QList<DrawingItem*>& items, bo
 	for(auto itemIter = items.begin(); itemIter != items.end(); itemIter++)
 	{
 		item = *itemIter;
-		itemPoints = item->points();
+		const QList<DrawingItemPoint*>& itemPoints = item->points();
 
 		for(auto itemPointIter = itemPoints.begin(); itemPointIter != itemPoints.end(); itemPointIter++)
 		{
 			itemPoint = *itemPointIter;
 			if (itemPoint != pointToSkip && (checkControlPoints || !itemPoint->isControlPoint()))
 			{
-				targetPoints = itemPoint->targets();
+				// Resizing or disconnecting changes the point's targets, so iterate over a copy
+				targetPoints = itemPoint->targetList();
 				for(auto targetPointIter = targetPoints.begin(); targetPointIter != targetPoints.end(); targetPointIter++)
 				{
 					targetItemPoint = *targetPointIter;
@@ -1460,11 +1708,11 @@ void DrawingScene::tryToMaintainConnections(DrawingItem* item, bool allowResize,
 
 void DrawingScene::disconnectAll(DrawingItemPoint* itemPoint, QUndoCommand* command)
 {
-	QList<DrawingItemPoint*> targetPoints;
+	DrawingItemPoint::TargetList targetPoints;
 
 	if (itemPoint)
 	{
-		targetPoints = itemPoint->targets();
+		targetPoints = itemPoint->targetList();
 		for(auto targetPointIter = targetPoints.begin(); targetPointIter != targetPoints.end(); targetPointIter++)
 			disconnectItemPoints(itemPoint, *targetPointIter, command);
 	}
@@ -1485,7 +1733,7 @@ QPointF DrawingScene::tryMove(const QList<DrawingItem*>& items, const QPointF& d
 		{
 			(*itemIter)->setPos((*itemIter)->pos() + deltaPos);
 
-			rect = (*itemIter)->mapToScene((*itemIter)->boundingRect());
+			rect = (*itemIter)->sceneBoundingRect();
 			if (rect.left() < mContentsRect.left())
 			{
 				actualDeltaPos.setX(qMax(actualDeltaPos.x(),
@@ -1545,7 +1793,7 @@ bool DrawingScene::tryRotate(const QList<DrawingItem*>& items, const QPointF& sc
 	canRotate = true;
 	for(auto itemIter = items.begin(); canRotate && itemIter != items.end(); itemIter++)
 	{
-		itemRect = Drawing::adjustRectForMinimumSize((*itemIter)->mapToScene((*itemIter)->boundingRect()));
+		itemRect = Drawing::adjustRectForMinimumSize((*itemIter)->sceneBoundingRect());
 		canRotate = ((*itemIter)->canRotate() && (!mForcingItemsInside || sceneRect.contains(itemRect)));
 	}
 
@@ -1567,7 +1815,7 @@ bool DrawingScene::tryRotateBack(const QList<DrawingItem*>& items, const QPointF
 	canRotate = true;
 	for(auto itemIter = items.begin(); canRotate && itemIter != items.end(); itemIter++)
 	{
-		itemRect = Drawing::adjustRectForMinimumSize((*itemIter)->mapToScene((*itemIter)->boundingRect()));
+		itemRect = Drawing::adjustRectForMinimumSize((*itemIter)->sceneBoundingRect());
 		canRotate = ((*itemIter)->canRotate() && (!mForcingItemsInside || sceneRect.contains(itemRect)));
 	}
 
@@ -1589,7 +1837,7 @@ bool DrawingScene::tryFlip(const QList<DrawingItem*>& items, const QPointF& scen
 	canFlip = true;
 	for(auto itemIter = items.begin(); canFlip && itemIter != items.end(); itemIter++)
 	{
-		itemRect = Drawing::adjustRectForMinimumSize((*itemIter)->mapToScene((*itemIter)->boundingRect()));
+		itemRect = Drawing::adjustRectForMinimumSize((*itemIter)->sceneBoundingRect());
 		canFlip = ((*itemIter)->canFlip() && (!mForcingItemsInside || sceneRect.contains(itemRect)));
 	}
 
@@ -1666,39 +1914,77 @@ void DrawingScene::drawBackground(QPainter* painter, const DrawingStyleOptions&
 		painter->drawRect(mSceneRect);
 	}
 
-	if (styleOptions.shouldDrawGrid() && mGrid > 0) drawGrid(painter, styleOptions, mSceneRect);
+	if (styleOptions.shouldDrawGrid() && mGrid > 0)
+	{
+		// Only draw the part of the grid that overlaps the exposed rect, padded by one grid
+		// spacing so that lines along its edges are not lost
+		QRectF gridRect = mSceneRect;
+		qreal padding = mGrid * qMax(1, qMax(styleOptions.majorGridSpacing(), styleOptions.minorGridSpacing()));
+
+		if (rect.isValid()) gridRect = gridRect.intersected(rect.adjusted(-padding, -padding, padding, padding));
+		if (gridRect.isValid()) drawGrid(painter, styleOptions, gridRect);
+	}
 
 	painter->setRenderHints(QPainter::Antialiasing | QPainter::TextAntialiasing);
 	if (styleOptions.shouldDrawBorder()) drawBorder(painter, styleOptions, mContentsRect);
-
-	Q_UNUSED(rect);
 }
 
 void DrawingScene::drawItems(QPainter* painter, const DrawingStyleOptions& styleOptions, const QRectF& rect)
 {
-	painter->setRenderHints(QPainter::Antialiasing | QPainter::TextAntialiasing);
+	QList<DrawingItem*> lItems = exposedItems(rect);
+
+	mNumberOfItemsCulled = mItems.numberOfItems() - lItems.size();
+	mNumberOfItemsDrawn = drawItemList(painter, styleOptions, lItems);
+
+#ifdef DEBUG_DRAW_ITEM_COUNTS
+	qDebug() << "DrawingScene::drawItems: drawn" << mNumberOfItemsDrawn << "culled" << mNumberOfItemsCulled;
+#endif
+}
+
+void DrawingScene::drawStaticItems(QPainter* painter, const DrawingStyleOptions& styleOptions, const QRectF& rect)
+{
+	QList<DrawingItem*> lItems = exposedItems(rect);
+	QList<DrawingItem*> staticItems;
 
-	for(auto itemIter = mItems.begin(); itemIter != mItems.end(); itemIter++)
+	// Selected items are drawn by drawSelectedItems() on the interactive overlay instead
+	for(auto itemIter = lItems.begin(); itemIter != lItems.end(); itemIter++)
 	{
-		if ((*itemIter)->isVisible())
-		{
-			qreal scaleFactor = Drawing::unitsScale(units(), (*itemIter)->units());
+		if (!(*itemIter)->isSelected()) staticItems.append(*itemIter);
+	}
 
-			painter->save();
-			painter->translate((*itemIter)->pos());
-			painter->scale(scaleFactor, scaleFactor);
-			(*itemIter)->render(painter, styleOptions);
-			painter->restore();
+	mNumberOfItemsCulled = mItems.numberOfItems() - lItems.size();
+	mNumberOfItemsDrawn = drawItemList(painter, styleOptions, staticItems);
+
+#ifdef DEBUG_DRAW_ITEM_COUNTS
+	qDebug() << "DrawingScene::drawStaticItems: drawn" << mNumberOfItemsDrawn << "culled" << mNumberOfItemsCulled;
+#endif
+}
+
+void DrawingScene::drawSelectedItems(QPainter* painter, const DrawingStyleOptions& styleOptions, const QRectF& rect)
+{
+	const QList<DrawingItem*>& lSelectedItems = mSelectedItems.items();
+	QList<DrawingItem*> lItems;
+	QRectF exposedRect = rect.normalized();
+
+	updateSpatialIndex();
+
+	for(auto itemIter = lSelectedItems.begin(); itemIter != lSelectedItems.end(); itemIter++)
+	{
+		if (!rect.isValid() || mUnboundedItems.contains(*itemIter) ||
+			exposedRect.intersects(Drawing::adjustRectForMinimumSize(mSpatialIndex.itemRect(*itemIter))))
+		{
+			lItems.append(*itemIter);
 		}
 	}
 
-	Q_UNUSED(rect);
+	drawItemList(painter, styleOptions, sortItemsByZOrder(lItems));
 }
 
 void DrawingScene::drawForeground(QPainter* painter, const DrawingStyleOptions& styleOptions, const QRectF& rect)
 {
 	QList<DrawingItem*> items;
-	QList<DrawingItemPoint*> itemPoints, otherItemPoints;
+	QList<DrawingItemPoint*> otherItemPoints;
+	bool hotpoint;
 	DrawingItemPlaceMode placeMode = (mLastMouseEvent.modifiers() & Qt::ShiftModifier) ? PlaceStrict : PlaceLoose;
 
 	painter->setRenderHints(QPainter::Antialiasing | QPainter::TextAntialiasing);
@@ -1716,40 +2002,44 @@ void DrawingScene::drawForeground(QPainter* painter, const DrawingStyleOptions&
 	}
 
 	// Draw item points
-	for(auto itemIter = mSelectedItems.begin(); itemIter != mSelectedItems.end(); itemIter++)
+	items = mSelectedItems.items();
+	for(auto itemIter = items.begin(); itemIter != items.end(); itemIter++)
 	{
-		itemPoints = (*itemIter)->points();
+		const QList<DrawingItemPoint*>& itemPoints = (*itemIter)->points();
 		for(auto pointIter = itemPoints.begin(); pointIter != itemPoints.end(); pointIter++)
 			drawItemPoint(painter, styleOptions, *pointIter);
 	}
 
 	// Draw hotpoints
-	items = mSelectedItems;
 	if (mNewItem) items.prepend(mNewItem);
 
 	for(auto itemIter = items.begin(); itemIter != items.end(); itemIter++)
 	{
-		itemPoints = (*itemIter)->points();
+		const QList<DrawingItemPoint*>& itemPoints = (*itemIter)->points();
 
 		for(auto pointIter = itemPoints.begin(); pointIter != itemPoints.end(); pointIter++)
 		{
-			for(auto otherItemIter = mItems.begin(); otherItemIter != mItems.end(); otherItemIter++)
-			{
-				if ((*itemIter) != (*otherItemIter))
-				{
-					otherItemPoints = (*otherItemIter)->points();
+			otherItemPoints = (*pointIter)->connectionCandidates(placeMode);
 
-					for(auto otherItemPointIter = otherItemPoints.begin();
-						otherItemPointIter != otherItemPoints.end(); otherItemPointIter++)
-					{
-						if ((*pointIter)->shouldConnect(*otherItemPointIter, placeMode))
-							drawHotpoint(painter, styleOptions, *pointIter);
-					}
-				}
+			hotpoint = false;
+			for(auto otherItemPointIter = otherItemPoints.begin();
+				!hotpoint && otherItemPointIter != otherItemPoints.end(); otherItemPointIter++)
+			{
+				hotpoint = (*pointIter)->shouldConnect(*otherItemPointIter, placeMode);
 			}
+
+			if (hotpoint) drawHotpoint(painter, styleOptions, *pointIter);
 		}
 	}
 
+	// Draw connections that will be maintained when the current drag is finished
+	for(int i = 0; i < mDragPoints.size(); i++)
+	{
+		drawConnectionPreview(painter, styleOptions,
+			mDragTargetPoints[i]->item()->mapToScene(mDragTargetPoints[i]->pos()),
+			mDragPoints[i]->item()->mapToScene(mDragPoints[i]->pos()));
+	}
+
 	// Draw rubber band
 	if (mMouseState == MouseRubberBand)
 	{
@@ -1893,27 +2183,27 @@ void DrawingScene::drawRubberBand(QPainter* painter, const DrawingStyleOptions&
 	painter->drawRect(rubberBandRect);
 }
 
+void DrawingScene::drawConnectionPreview(QPainter* painter, const DrawingStyleOptions& styleOptions,
+	const QPointF& startPos, const QPointF& endPos)
+{
+	QPen previewPen(styleOptions.outputBrush(DrawingStyleOptions::Hotpoint), 1, Qt::DashLine);
+	previewPen.setCosmetic(true);
+
+	painter->setPen(previewPen);
+	painter->drawLine(startPos, endPos);
+}
+
 //==================================================================================================
 
 void DrawingScene::writeXmlAttributes(QXmlStreamWriter& xmlWriter)
 {
-	xmlWriter.writeAttribute("sceneRect", Drawing::rectToString(mSceneRect));
-	xmlWriter.writeAttribute("contentsRect", Drawing::rectToString(mContentsRect));
-	xmlWriter.writeAttribute("height", QString::number(mContentsRect.height()));
-	xmlWriter.writeAttribute("units", QString::number((quint16)units()));
-
-	xmlWriter.writeAttribute("borderWidth", QString::number(borderWidth()));
-	xmlWriter.writeAttribute("grid", QString::number(grid()));
-
-	xmlWriter.writeAttribute("selectionMode", QString::number((quint32)selectionMode()));
-	xmlWriter.writeAttribute("forceItemsInside", (isForcingItemsInside()) ? "true" : "false");
+	writeSceneXmlAttributes(xmlWriter, mSceneRect, mContentsRect, units(), borderWidth(), grid(),
+		selectionMode(), isForcingItemsInside());
 }
 
 void DrawingScene::writeXmlChildElements(QXmlStreamWriter& xmlWriter)
 {
-	xmlWriter.writeStartElement("items");
-	DrawingItem::writeItemsToXml(xmlWriter, items());
-	xmlWriter.writeEndElement();
+	writeItemsXmlElements(xmlWriter, items());
 }
 
 void DrawingScene::readXmlAttributes(QXmlStreamReader& xmlReader)
@@ -1943,10 +2233,588 @@ void DrawingScene::readXmlAttributes(QXmlStreamReader& xmlReader)
 
 void DrawingScene::readXmlChildElement(QXmlStreamReader& xmlReader)
 {
-	if (xmlReader.name() == "items")
+	if (xmlReader.name() == "styles")
 	{
-		QList<DrawingItem*> items = DrawingItem::readItemsFromXml(xmlReader);
+		mFileStyles.readFromXml(xmlReader);
+	}
+	else if (xmlReader.name() == "items")
+	{
+		QList<DrawingItem*> items = DrawingItem::readItemsFromXml(xmlReader, &mFileStyles);
 		while (!items.isEmpty()) addItem(items.takeFirst());
+		mFileStyles.clear();
 	}
 	else xmlReader.skipCurrentElement();
 }
+
+//==================================================================================================
+
+void DrawingScene::writeBinary(QDataStream& stream)
+{
+	writeSceneBinary(stream, mSceneRect, mContentsRect, units(), borderWidth(), grid(),
+		selectionMode(), isForcingItemsInside());
+	writeItemsBinary(stream, items());
+}
+
+void DrawingScene::readBinary(QDataStream& stream)
+{
+	QRectF sceneRect, contentsRect;
+	quint16 units = 0;
+	qreal borderWidth = 0, grid = 0;
+	quint32 selectionMode = 0;
+	bool forceItemsInside = false;
+	QList<DrawingItem*> items;
+
+	stream >> sceneRect >> contentsRect >> units;
+	stream >> borderWidth >> grid;
+	stream >> selectionMode >> forceItemsInside;
+
+	if (stream.status() == QDataStream::Ok)
+	{
+		setSceneRect(sceneRect);
+		setContentsRect(contentsRect);
+		setUnits((DrawingUnits)units);
+		setBorderWidth(borderWidth);
+		setGrid(grid);
+		setSelectionMode((Qt::ItemSelectionMode)selectionMode);
+		setForcingItemsInside(forceItemsInside);
+
+		mFileStyles.readFromBinary(stream);
+		items = DrawingItem::readItemsFromBinary(stream, &mFileStyles);
+		while (!items.isEmpty()) addItem(items.takeFirst());
+		mFileStyles.clear();
+	}
+}
+
+//==================================================================================================
+
+QUndoCommand* DrawingScene::readUndoCommand(int type, QDataStream& stream, bool undone,
+	DrawingJournal& journal, QUndoCommand* parent)
+{
+	QUndoCommand* command = nullptr;
+
+	switch (type)
+	{
+	case DrawingUndoCommand::AddItemsType:
+		command = DrawingAddItemsCommand::readJournalData(stream, undone, journal, parent);
+		break;
+	case DrawingUndoCommand::RemoveItemsType:
+		command = DrawingRemoveItemsCommand::readJournalData(stream, undone, journal, parent);
+		break;
+	case DrawingUndoCommand::MoveItemsDeltaType:
+		command = DrawingMoveItemsDeltaCommand::readJournalData(stream, undone, journal, parent);
+		break;
+	case DrawingUndoCommand::RotateItemsType:
+		command = DrawingRotateItemsCommand::readJournalData(stream, undone, journal, parent);
+		break;
+	case DrawingUndoCommand::RotateBackItemsType:
+		command = DrawingRotateBackItemsCommand::readJournalData(stream, undone, journal, parent);
+		break;
+	case DrawingUndoCommand::FlipItemsType:
+		command = DrawingFlipItemsCommand::readJournalData(stream, undone, journal, parent);
+		break;
+	case DrawingUndoCommand::ItemResizeType:
+		command = DrawingResizeItemCommand::readJournalData(stream, undone, journal, parent);
+		break;
+	case DrawingUndoCommand::ReorderItemsType:
+		command = DrawingReorderItemsCommand::readJournalData(stream, undone, journal, parent);
+		break;
+	case DrawingUndoCommand::InsertItemPointType:
+		command = DrawingItemInsertPointCommand::readJournalData(stream, undone, journal, parent);
+		break;
+	case DrawingUndoCommand::RemoveItemPointType:
+		command = DrawingItemRemovePointCommand::readJournalData(stream, undone, journal, parent);
+		break;
+	case DrawingUndoCommand::PointConnectType:
+		command = DrawingItemPointConnectCommand::readJournalData(stream, undone, journal, parent);
+		break;
+	case DrawingUndoCommand::PointDisconnectType:
+		command = DrawingItemPointDisconnectCommand::readJournalData(stream, undone, journal, parent);
+		break;
+	default:
+		break;
+	}
+
+	return command;
+}
+
+//==================================================================================================
+
+void DrawingScene::writeSceneXmlAttributes(QXmlStreamWriter& xmlWriter, const QRectF& sceneRect,
+	const QRectF& contentsRect, DrawingUnits units, qreal borderWidth, qreal grid,
+	Qt::ItemSelectionMode selectionMode, bool forcingItemsInside)
+{
+	xmlWriter.writeAttribute("sceneRect", Drawing::rectToString(sceneRect));
+	xmlWriter.writeAttribute("contentsRect", Drawing::rectToString(contentsRect));
+	xmlWriter.writeAttribute("height", QString::number(contentsRect.height()));
+	xmlWriter.writeAttribute("units", QString::number((quint16)units));
+
+	xmlWriter.writeAttribute("borderWidth", QString::number(borderWidth));
+	xmlWriter.writeAttribute("grid", QString::number(grid));
+
+	xmlWriter.writeAttribute("selectionMode", QString::number((quint32)selectionMode));
+	xmlWriter.writeAttribute("forceItemsInside", (forcingItemsInside) ? "true" : "false");
+}
+
+void DrawingScene::writeItemsXmlElements(QXmlStreamWriter& xmlWriter, const QList<DrawingItem*>& items,
+	QAtomicInt* itemsWritten)
+{
+	DrawingStyleTable styles;
+
+	// Only the styles of the current items are saved, not every style the scene has seen
+	for(auto itemIter = items.begin(); itemIter != items.end(); itemIter++)
+	{
+		if (!(*itemIter)->styleProperties().isEmpty()) styles.addStyle((*itemIter)->styleProperties());
+	}
+
+	if (styles.numberOfStyles() > 0)
+	{
+		xmlWriter.writeStartElement("styles");
+		styles.writeToXml(xmlWriter);
+		xmlWriter.writeEndElement();
+	}
+
+	xmlWriter.writeStartElement("items");
+	DrawingItem::writeItemsToXml(xmlWriter, items, &styles, itemsWritten);
+	xmlWriter.writeEndElement();
+}
+
+void DrawingScene::writeSceneBinary(QDataStream& stream, const QRectF& sceneRect,
+	const QRectF& contentsRect, DrawingUnits units, qreal borderWidth, qreal grid,
+	Qt::ItemSelectionMode selectionMode, bool forcingItemsInside)
+{
+	stream << sceneRect << contentsRect << (quint16)units;
+	stream << borderWidth << grid;
+	stream << (quint32)selectionMode << forcingItemsInside;
+}
+
+void DrawingScene::writeItemsBinary(QDataStream& stream, const QList<DrawingItem*>& items,
+	QAtomicInt* itemsWritten)
+{
+	DrawingStyleTable styles;
+
+	for(auto itemIter = items.begin(); itemIter != items.end(); itemIter++)
+	{
+		if (!(*itemIter)->styleProperties().isEmpty()) styles.addStyle((*itemIter)->styleProperties());
+	}
+
+	styles.writeToBinary(stream);
+	DrawingItem::writeItemsToBinary(stream, items, &styles, itemsWritten);
+}
+
+//==================================================================================================
+
+void DrawingScene::registerItemId(DrawingItem* item)
+{
+	// The item keeps the id it already has unless another item in the scene is using it
+	if (item->mId == 0 || mItemIds.contains(item->mId))
+		item->mId = mNextItemId;
+
+	mNextItemId = qMax(mNextItemId, item->mId + 1);
+	mItemIds.insert(item->mId, item);
+}
+
+//==================================================================================================
+
+void DrawingScene::invalidateItem(DrawingItem* item)
+{
+	// Geometry changes are collected here and applied to the spatial index on the next query, so
+	// that an item moved many times between queries is only reindexed once
+	if (item && item != mNewItem && item->mScene == this && !mItemsToReindex.contains(item))
+	{
+		// The area the item covered before the change needs to be redrawn.  Selected items are
+		// drawn on the overlay, so changing them does not affect the static layer.
+		if (!item->isSelected() && mSpatialIndex.containsItem(item))
+			invalidateRect(mSpatialIndex.itemRect(item));
+		mItemsToReindex.insert(item);
+	}
+}
+
+void DrawingScene::invalidateRect(const QRectF& sceneRect) const
+{
+	mChangedRects.append(sceneRect.normalized());
+}
+
+bool DrawingScene::hasChangedRects() const
+{
+	return (!mItemsToReindex.isEmpty() || !mChangedRects.isEmpty());
+}
+
+QList<QRectF> DrawingScene::changedRects() const
+{
+	updateSpatialIndex();
+	return mChangedRects;
+}
+
+QList<QRectF> DrawingScene::takeChangedRects()
+{
+	QList<QRectF> changedRects;
+
+	updateSpatialIndex();
+	changedRects.swap(mChangedRects);
+
+	return changedRects;
+}
+
+void DrawingScene::updateSpatialIndex() const
+{
+	QSet<DrawingItem*> itemsToReindex;
+
+	// Computing an item's rect may cause it to report another geometry change
+	itemsToReindex.swap(mItemsToReindex);
+
+	for(auto itemIter = itemsToReindex.begin(); itemIter != itemsToReindex.end(); itemIter++)
+	{
+		mSpatialIndex.updateItem(*itemIter, itemIndexRect(*itemIter));
+		if (!(*itemIter)->isSelected()) invalidateRect(mSpatialIndex.itemRect(*itemIter));
+		hashItemPoints(*itemIter);
+		updateItemStyle(*itemIter);
+
+		// Some items (such as text) only know their bounds once they have been rendered
+		if ((*itemIter)->boundingRect().isValid()) mUnboundedItems.remove(*itemIter);
+		else mUnboundedItems.insert(*itemIter);
+	}
+}
+
+void DrawingScene::updateItemStyle(DrawingItem* item) const
+{
+	// Replace the item's style with the table's copy so that all items of the same style share it.
+	// The values are equal, so this is not a change to the item.
+	if (item->mStyleId < 0 && !item->mStyleProperties.isEmpty())
+	{
+		item->mStyleId = mStyles.addStyle(item->mStyleProperties);
+		item->mStyleProperties = mStyles.style(item->mStyleId);
+	}
+}
+
+QList<QRectF> DrawingScene::foregroundRects() const
+{
+	// Returns the areas covered by everything drawn on top of the static layer: selected items
+	// (including their points and hotpoints), the new item, and the rubber band
+	const QList<DrawingItem*>& lSelectedItems = mSelectedItems.items();
+	QList<QRectF> rects;
+
+	updateSpatialIndex();
+
+	for(auto itemIter = lSelectedItems.begin(); itemIter != lSelectedItems.end(); itemIter++)
+	{
+		if (mUnboundedItems.contains(*itemIter)) rects.append(mSceneRect);
+		else rects.append(mSpatialIndex.itemRect(*itemIter));
+	}
+
+	if (mNewItem)
+	{
+		if (mNewItem->boundingRect().isValid()) rects.append(itemIndexRect(mNewItem));
+		else rects.append(mSceneRect);
+	}
+
+	if (mMouseState == MouseRubberBand)
+		rects.append(Drawing::rectFromPoints(mLastMouseEvent.scenePos(), mLastMouseEvent.buttonDownScenePos()));
+
+	for(int i = 0; i < mDragPoints.size(); i++)
+	{
+		rects.append(Drawing::rectFromPoints(mDragTargetPoints[i]->item()->mapToScene(mDragTargetPoints[i]->pos()),
+			mDragPoints[i]->item()->mapToScene(mDragPoints[i]->pos())));
+	}
+
+	return rects;
+}
+
+//==================================================================================================
+
+void DrawingScene::beginDrag(const QList<DrawingItem*>& items, DrawingItemPoint* itemPoint)
+{
+	QSet<DrawingItem*> itemSet = items.toSet();
+
+	endDrag();
+
+	// When itemPoint is set, that point is dragged to resize its item; otherwise the items are moved
+	if (itemPoint)
+	{
+		mDragItemPoint = itemPoint;
+		mDragOriginalScenePos = itemPoint->item()->mapToScene(itemPoint->pos());
+	}
+	else mDragItems = items;
+
+	// Remember each connection to an item that is not being dragged so that it can be previewed.
+	// The dragged point itself will be disconnected, so it has nothing to preview.
+	for(auto itemIter = items.begin(); itemIter != items.end(); itemIter++)
+	{
+		const QList<DrawingItemPoint*>& itemPoints = (*itemIter)->points();
+		for(auto pointIter = itemPoints.begin(); pointIter != itemPoints.end(); pointIter++)
+		{
+			if (*pointIter != itemPoint)
+			{
+				const DrawingItemPoint::TargetList& targetPoints = (*pointIter)->targetList();
+				for(auto targetIter = targetPoints.begin(); targetIter != targetPoints.end(); targetIter++)
+				{
+					if (!itemSet.contains((*targetIter)->item()))
+					{
+						mDragPoints.append(*pointIter);
+						mDragTargetPoints.append(*targetIter);
+					}
+				}
+			}
+		}
+	}
+}
+
+void DrawingScene::dragItems(const QList<DrawingItem*>& items, const QPointF& deltaPos)
+{
+	if (deltaPos != QPointF())
+	{
+		for(auto itemIter = items.begin(); itemIter != items.end(); itemIter++)
+			(*itemIter)->setPos((*itemIter)->pos() + deltaPos);
+
+		mDragDeltaPos += deltaPos;
+	}
+}
+
+void DrawingScene::dragItemPoint(DrawingItemPoint* itemPoint, const QPointF& scenePos)
+{
+	DrawingItem* item = (itemPoint) ? itemPoint->item() : nullptr;
+
+	if (item) item->resizeItem(itemPoint, item->mapToParent(item->mapFromScene(scenePos)));
+}
+
+void DrawingScene::endDrag()
+{
+	if (mDragDeltaPos != QPointF())
+	{
+		for(auto itemIter = mDragItems.begin(); itemIter != mDragItems.end(); itemIter++)
+			(*itemIter)->setPos((*itemIter)->pos() - mDragDeltaPos);
+	}
+
+	if (mDragItemPoint && mDragItemPoint->item())
+		dragItemPoint(mDragItemPoint, mDragOriginalScenePos);
+
+	mDragItems.clear();
+	mDragDeltaPos = QPointF();
+	mDragItemPoint = nullptr;
+	mDragPoints.clear();
+	mDragTargetPoints.clear();
+}
+
+QRectF DrawingScene::itemIndexRect(DrawingItem* item) const
+{
+	// The index rect must cover everything itemMatchesPoint/itemMatchesRect might test: the
+	// item's bounding rect, the outline of its shape, its points, and its children
+	QRectF rect = item->sceneBoundingRect().normalized();
+	QRectF shapeRect = item->mapToScene(item->shape().boundingRect()).normalized();
+	const QList<DrawingItemPoint*>& itemPoints = item->points();
+	const QList<DrawingItem*>& children = item->children();
+	QPointF pointPos;
+	QRectF childRect;
+
+	qreal left = qMin(rect.left(), shapeRect.left());
+	qreal top = qMin(rect.top(), shapeRect.top());
+	qreal right = qMax(rect.right(), shapeRect.right());
+	qreal bottom = qMax(rect.bottom(), shapeRect.bottom());
+
+	for(auto pointIter = itemPoints.begin(); pointIter != itemPoints.end(); pointIter++)
+	{
+		pointPos = item->mapToScene((*pointIter)->pos());
+		left = qMin(left, pointPos.x());
+		top = qMin(top, pointPos.y());
+		right = qMax(right, pointPos.x());
+		bottom = qMax(bottom, pointPos.y());
+	}
+
+	for(auto childIter = children.begin(); childIter != children.end(); childIter++)
+	{
+		childRect = itemIndexRect(*childIter);
+		left = qMin(left, childRect.left());
+		top = qMin(top, childRect.top());
+		right = qMax(right, childRect.right());
+		bottom = qMax(bottom, childRect.bottom());
+	}
+
+	return QRectF(left, top, right - left, bottom - top);
+}
+
+void DrawingScene::hashItemPoints(DrawingItem* item) const
+{
+	const QList<DrawingItemPoint*>& itemPoints = item->points();
+	QList<DrawingItemPoint*> hashedPoints;
+
+	unhashItemPoints(item);
+
+	for(auto pointIter = itemPoints.begin(); pointIter != itemPoints.end(); pointIter++)
+	{
+		if ((*pointIter)->isConnectionPoint())
+		{
+			mPointHash.insertPoint(*pointIter, item->mapToScene((*pointIter)->pos()));
+			hashedPoints.append(*pointIter);
+		}
+	}
+
+	if (!hashedPoints.isEmpty()) mHashedPoints.insert(item, hashedPoints);
+}
+
+void DrawingScene::unhashItemPoints(DrawingItem* item) const
+{
+	// Points removed from the item since it was last hashed may already be deleted, so remove the
+	// points that were hashed rather than the item's current points
+	QList<DrawingItemPoint*> hashedPoints = mHashedPoints.take(item);
+
+	for(auto pointIter = hashedPoints.begin(); pointIter != hashedPoints.end(); pointIter++)
+		mPointHash.removePoint(*pointIter);
+}
+
+QList<DrawingItem*> DrawingScene::indexedItems(const QRectF& sceneRect) const
+{
+	QList<DrawingItem*> candidates;
+
+	// Item shapes may be widened for the current zoom level and item points are drawn at a fixed
+	// size in pixels, so pad the query by a few pixels' worth of scene units
+	qreal margin = 0.001;
+	if (mView) margin = qMax(margin, mView->mapToScene(QRect(0, 0, 16, 16)).width());
+
+	updateSpatialIndex();
+	candidates = mSpatialIndex.items(sceneRect.normalized().adjusted(-margin, -margin, margin, margin));
+
+	return sortItemsByZOrder(candidates);
+}
+
+QList<DrawingItem*> DrawingScene::exposedItems(const QRectF& sceneRect) const
+{
+	QList<DrawingItem*> lItems = mItems.items();
+
+	// Skip items that do not overlap the exposed rect
+	if (sceneRect.isValid())
+	{
+		lItems = indexedItems(sceneRect);
+
+		if (!mUnboundedItems.isEmpty())
+			lItems = sortItemsByZOrder(lItems.toSet().unite(mUnboundedItems).toList());
+	}
+
+	return lItems;
+}
+
+int DrawingScene::drawItemList(QPainter* painter, const DrawingStyleOptions& styleOptions,
+	const QList<DrawingItem*>& items)
+{
+	QList<DrawingItem*> batchedItems = batchItemsByStyle(items);
+	QTransform sceneTransform;
+	int styleId = -1;
+	bool painterSaved = false;
+	int itemsDrawn = 0;
+
+	painter->setRenderHints(QPainter::Antialiasing | QPainter::TextAntialiasing);
+	sceneTransform = painter->worldTransform();
+
+	for(auto itemIter = batchedItems.begin(); itemIter != batchedItems.end(); itemIter++)
+	{
+		if ((*itemIter)->isVisible())
+		{
+			qreal scaleFactor = Drawing::unitsScale(units(), (*itemIter)->units());
+
+			// Consecutive items of the same style are drawn without restoring the painter in
+			// between, so that setting the same pen and brush again does not change its state
+			if (!painterSaved || (*itemIter)->mStyleId < 0 || (*itemIter)->mStyleId != styleId)
+			{
+				if (painterSaved) painter->restore();
+				painter->save();
+				painterSaved = true;
+				styleId = (*itemIter)->mStyleId;
+			}
+			else painter->setWorldTransform(sceneTransform);
+
+			painter->translate((*itemIter)->pos());
+			painter->scale(scaleFactor, scaleFactor);
+			(*itemIter)->render(painter, styleOptions);
+
+			itemsDrawn++;
+		}
+	}
+
+	if (painterSaved) painter->restore();
+
+	return itemsDrawn;
+}
+
+QList<DrawingItem*> DrawingScene::sortItemsByZOrder(const QList<DrawingItem*>& items) const
+{
+	QList<DrawingItem*> sortedItems;
+
+	// Looking up each item's index is O(log n), so a full pass over the stacking order only pays
+	// off when a large fraction of the scene's items is being sorted
+	if (items.size() > 16 && items.size() * 8 > mItems.numberOfItems())
+	{
+		const QList<DrawingItem*>& lItems = mItems.items();
+		QSet<DrawingItem*> itemSet = items.toSet();
+
+		for(auto itemIter = lItems.begin(); itemIter != lItems.end(); itemIter++)
+		{
+			if (itemSet.contains(*itemIter)) sortedItems.append(*itemIter);
+		}
+	}
+	else
+	{
+		QMap<int,DrawingItem*> orderedItems;
+
+		for(auto itemIter = items.begin(); itemIter != items.end(); itemIter++)
+			orderedItems.insert(mItems.itemIndex(*itemIter), *itemIter);
+
+		sortedItems = orderedItems.values();
+	}
+
+	return sortedItems;
+}
+
+QList<DrawingItem*> DrawingScene::batchItemsByStyle(const QList<DrawingItem*>& items) const
+{
+	// Each item joins the most recent batch of its style, provided that it does not overlap any item
+	// in the batches after that one; otherwise it starts a new batch.  Only a limited number of
+	// batches are searched so that a drawing with many styles stays linear.
+	const int maxBatchesSearched = 32;
+	QList< QList<DrawingItem*> > batches;
+	QList<int> batchStyleIds;
+	QList<QRectF> batchRects;
+	QList<DrawingItem*> batchedItems;
+	QRectF itemRect;
+	int styleId, batchIndex;
+
+	for(auto itemIter = items.begin(); itemIter != items.end(); itemIter++)
+	{
+		styleId = (*itemIter)->mStyleId;
+		batchIndex = -1;
+
+		// Items whose extent is not known are never moved, and nothing is moved past them
+		if (mSpatialIndex.containsItem(*itemIter) && !mUnboundedItems.contains(*itemIter))
+			itemRect = Drawing::adjustRectForMinimumSize(mSpatialIndex.itemRect(*itemIter));
+		else
+			itemRect = QRectF();
+
+		if (styleId >= 0 && itemRect.isValid())
+		{
+			for(int i = batches.size() - 1; i >= 0 && i >= batches.size() - maxBatchesSearched; i--)
+			{
+				if (batchStyleIds[i] == styleId)
+				{
+					batchIndex = i;
+					break;
+				}
+
+				if (!batchRects[i].isValid() || batchRects[i].intersects(itemRect)) break;
+			}
+		}
+
+		if (batchIndex >= 0)
+		{
+			batches[batchIndex].append(*itemIter);
+			batchRects[batchIndex] = batchRects[batchIndex].united(itemRect);
+		}
+		else
+		{
+			batches.append(QList<DrawingItem*>() << *itemIter);
+			batchStyleIds.append(styleId);
+			batchRects.append(itemRect);
+		}
+	}
+
+	for(auto batchIter = batches.begin(); batchIter != batches.end(); batchIter++)
+		batchedItems.append(*batchIter);
+
+	return batchedItems;
+}
@@ -22,6 +22,11 @@
 #define DRAWINGSCENE_H
 
 #include <DrawingTypes.h>
+#include <DrawingItemOrder.h>
+#include <DrawingItemPointHash.h>
+#include <DrawingSpatialIndex.h>
+#include <DrawingStyleTable.h>
+#include <DrawingUndoStack.h>
 
 /* The DrawingScene class provides a surface for managing a large number of 2D graphical
  * items.
@@ -54,12 +59,51 @@
  * The user can exit the new item mode by right-clicking in the scene.  The new item mode can be
  * exited programmatically by calling setNewItem with an invalid DrawingItem (nullptr) as the
  * argument.
+ *
+ * Moving and Resizing Items
+ * =========================
+ *
+ * By default, dragging items with the mouse only updates their geometry.  Connections to items
+ * outside the selection are shown as a preview line while the mouse button is held down.  When the
+ * mouse button is released, the items are returned to their original geometry and the move or
+ * resize is performed once, including maintaining connections and building the undo command.  Call
+ * setDeferringDragUpdates(false) to maintain connections on every mouse move instead.
+ *
+ * Item Styles
+ * ===========
+ *
+ * The scene keeps a table of the distinct styles used by its items, and items of the same style
+ * share a single copy of it.  When saved, the styles in use are written once in a styles section
+ * ahead of the items, which then refer to them by id.  When drawing, items are grouped by style so
+ * that the painter's pen and brush change less often; an item is only moved ahead of items that it
+ * does not overlap, so the result is the same as drawing in stacking order.
+ *
+ * Item Ids
+ * ========
+ *
+ * Each item in the scene has an id that is unique within the scene and does not change while the
+ * item exists, and itemFromId() finds an item from its id.  An item keeps its id when it is removed
+ * from the scene, so it gets the same id back if it is added again (for example, by undo), and
+ * items loaded from a file keep the ids they were saved with.  An item is only given a new id when
+ * it has none or its id is already taken, as when pasting a copy of items still in the scene.
+ * Connections between items are saved by item id rather than by position in the item list.
+ *
+ * Crash Recovery
+ * ==============
+ *
+ * A DrawingJournal set with setJournal() records every change made through the undo stack (see
+ * DrawingJournal).  To replay the journal, the scene recreates each command from its type with
+ * readUndoCommand().  Derived scenes that push DrawingUndoCommands of their own types should
+ * override readUndoCommand to recreate them, and pass any other type on to the base class.
  */
 class DrawingScene : public QObject
 {
 	Q_OBJECT
 
 	friend class DrawingView;
+	friend class DrawingItem;
+	friend class DrawingSnapshot;
+	friend class DrawingJournal;
 
 public:
 	enum MouseState { MouseReady, MouseSelect, MouseMoveItems, MouseResizeItem, MouseRubberBand };
@@ -75,21 +119,41 @@ private:
 
 	Qt::ItemSelectionMode mSelectionMode;
 	bool mForcingItemsInside;
-
-	QList<DrawingItem*> mItems;
-	QList<DrawingItem*> mSelectedItems;
+	bool mDeferringDragUpdates;
+
+	DrawingItemOrder mItems;
+	DrawingItemOrder mSelectedItems;
+	QHash<quint64, DrawingItem*> mItemIds;
+	quint64 mNextItemId;
+	mutable DrawingSpatialIndex mSpatialIndex;
+	mutable QSet<DrawingItem*> mItemsToReindex;
+	mutable DrawingItemPointHash mPointHash;
+	mutable QHash<DrawingItem*, QList<DrawingItemPoint*> > mHashedPoints;
+	mutable QSet<DrawingItem*> mUnboundedItems;
+	mutable DrawingStyleTable mStyles;
+	DrawingStyleTable mFileStyles;
+	mutable QList<QRectF> mChangedRects;
 	QPointF mSelectionCenter;
 	DrawingItem* mNewItem;
 
-	QUndoStack mUndoStack;
+	DrawingUndoStack mUndoStack;
 
 	DrawingMouseEvent mLastMouseEvent;
 	MouseState mMouseState;
 	DrawingItem* mMouseDownItem;
 	QPointF mMouseDownItemPos;
+	QList<DrawingItem*> mDragItems;
+	QPointF mDragDeltaPos;
+	DrawingItemPoint* mDragItemPoint;
+	QPointF mDragOriginalScenePos;
+	QList<DrawingItemPoint*> mDragPoints;
+	QList<DrawingItemPoint*> mDragTargetPoints;
 	int mNewClickCount;
 	int mConsecutivePastes;
 
+	int mNumberOfItemsDrawn;
+	int mNumberOfItemsCulled;
+
 public:
 	DrawingScene();
 	virtual ~DrawingScene();
@@ -115,19 +179,23 @@ public:
 
 	void setSelectionMode(Qt::ItemSelectionMode mode);
 	void setForcingItemsInside(bool inside);
+	void setDeferringDragUpdates(bool defer);
 	Qt::ItemSelectionMode selectionMode() const;
 	bool isForcingItemsInside() const;
+	bool isDeferringDragUpdates() const;
 
 	// Items
 	void addItem(DrawingItem* item);
 	void insertItem(int index, DrawingItem* item);
 	void removeItem(DrawingItem* item);
 	void clearItems();
-	QList<DrawingItem*> items() const;
+	const QList<DrawingItem*>& items() const;
 	int numberOfItems() const;
 	int itemIndex(DrawingItem* item) const;
 	bool containsItem(DrawingItem* item) const;
+	DrawingItem* itemFromId(quint64 id) const;
 	void reorderItems(const QList<DrawingItem*>& items);
+	void reorderItem(DrawingItem* item, int index);
 
 	QList<DrawingItem*> items(const QRectF& sceneRect) const;
 	QList<DrawingItem*> childItems(const QRectF& sceneRect) const;
@@ -136,6 +204,11 @@ public:
 	QRectF itemsRect() const;
 	QRectF itemsShapeRect() const;
 
+	QList<DrawingItemPoint*> connectionPoints(const QRectF& sceneRect) const;
+
+	int numberOfItemsDrawn() const;
+	int numberOfItemsCulled() const;
+
 	void setNewItem(DrawingItem* item);
 	DrawingItem* newItem() const;
 
@@ -143,14 +216,26 @@ public:
 	void selectItem(DrawingItem* item);
 	void deselectItem(DrawingItem* item);
 	void selectItems(const QRectF& sceneRect);
-	QList<DrawingItem*> selectedItems() const;
+	void selectItems(const QList<DrawingItem*>& items);
+	void deselectItems(const QList<DrawingItem*>& items);
+	void clearSelection();
+	const QList<DrawingItem*>& selectedItems() const;
 	int numberOfSelectedItems() const;
 
 	// Undo
 	void setUndoLimit(int undoLimit);
+	void setUndoMemoryLimit(qint64 bytes);
+	void setJournal(DrawingJournal* journal);
+	DrawingJournal* journal() const;
 	void setClean();
+	void resetClean();
+	void setSavePoint();
+	void commitSavePoint();
+	void discardSavePoint();
 	void pushUndo(QUndoCommand* command);
 	int undoLimit() const;
+	qint64 undoMemoryLimit() const;
+	qint64 undoMemoryUsage() const;
 	bool isClean() const;
 	bool canUndo() const;
 	bool canRedo() const;
@@ -250,6 +335,8 @@ protected:
 
 	virtual void drawBackground(QPainter* painter, const DrawingStyleOptions& styleOptions, const QRectF& rect);
 	virtual void drawItems(QPainter* painter, const DrawingStyleOptions& styleOptions, const QRectF& rect);
+	virtual void drawStaticItems(QPainter* painter, const DrawingStyleOptions& styleOptions, const QRectF& rect);
+	virtual void drawSelectedItems(QPainter* painter, const DrawingStyleOptions& styleOptions, const QRectF& rect);
 	virtual void drawForeground(QPainter* painter, const DrawingStyleOptions& styleOptions, const QRectF& rect);
 
 	virtual void drawBorder(QPainter* painter, const DrawingStyleOptions& styleOptions, const QRectF& rect);
@@ -258,11 +345,56 @@ protected:
 	virtual void drawItemPoint(QPainter* painter, const DrawingStyleOptions& styleOptions, DrawingItemPoint* point);
 	virtual void drawHotpoint(QPainter* painter, const DrawingStyleOptions& styleOptions, DrawingItemPoint* point);
 	virtual void drawRubberBand(QPainter* painter, const DrawingStyleOptions& styleOptions, const QRectF& rubberBandRect);
+	virtual void drawConnectionPreview(QPainter* painter, const DrawingStyleOptions& styleOptions,
+		const QPointF& startPos, const QPointF& endPos);
 
 	virtual void writeXmlAttributes(QXmlStreamWriter& xmlWriter);
 	virtual void writeXmlChildElements(QXmlStreamWriter& xmlWriter);
 	virtual void readXmlAttributes(QXmlStreamReader& xmlReader);
 	virtual void readXmlChildElement(QXmlStreamReader& xmlReader);
+
+	virtual void writeBinary(QDataStream& stream);
+	virtual void readBinary(QDataStream& stream);
+
+	virtual QUndoCommand* readUndoCommand(int type, QDataStream& stream, bool undone,
+		DrawingJournal& journal, QUndoCommand* parent);
+
+	static void writeSceneXmlAttributes(QXmlStreamWriter& xmlWriter, const QRectF& sceneRect,
+		const QRectF& contentsRect, DrawingUnits units, qreal borderWidth, qreal grid,
+		Qt::ItemSelectionMode selectionMode, bool forcingItemsInside);
+	static void writeItemsXmlElements(QXmlStreamWriter& xmlWriter, const QList<DrawingItem*>& items,
+		QAtomicInt* itemsWritten = nullptr);
+	static void writeSceneBinary(QDataStream& stream, const QRectF& sceneRect,
+		const QRectF& contentsRect, DrawingUnits units, qreal borderWidth, qreal grid,
+		Qt::ItemSelectionMode selectionMode, bool forcingItemsInside);
+	static void writeItemsBinary(QDataStream& stream, const QList<DrawingItem*>& items,
+		QAtomicInt* itemsWritten = nullptr);
+
+private:
+	void registerItemId(DrawingItem* item);
+
+	void invalidateItem(DrawingItem* item);
+	void invalidateRect(const QRectF& sceneRect) const;
+	bool hasChangedRects() const;
+	QList<QRectF> changedRects() const;
+	QList<QRectF> takeChangedRects();
+	QList<QRectF> foregroundRects() const;
+	void beginDrag(const QList<DrawingItem*>& items, DrawingItemPoint* itemPoint);
+	void dragItems(const QList<DrawingItem*>& items, const QPointF& deltaPos);
+	void dragItemPoint(DrawingItemPoint* itemPoint, const QPointF& scenePos);
+	void endDrag();
+	void updateSpatialIndex() const;
+	void updateItemStyle(DrawingItem* item) const;
+	QRectF itemIndexRect(DrawingItem* item) const;
+	void hashItemPoints(DrawingItem* item) const;
+	void unhashItemPoints(DrawingItem* item) const;
+	QList<DrawingItem*> indexedItems(const QRectF& sceneRect) const;
+	QList<DrawingItem*> exposedItems(const QRectF& sceneRect) const;
+	int drawItemList(QPainter* painter, const DrawingStyleOptions& styleOptions, const QList<DrawingItem*>& items);
+	QList<DrawingItem*> sortItemsByZOrder(const QList<DrawingItem*>& items) const;
+	QList<DrawingItem*> batchItemsByStyle(const QList<DrawingItem*>& items) const;
+	void pushReorderCommand(const QList<DrawingItem*>& items,
+		const QList<int>& originalIndices, const QList<int>& newIndices);
 };
 
 #endif
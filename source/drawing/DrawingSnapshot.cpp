@@ -0,0 +1,134 @@
+/* DrawingSnapshot.cpp
+ *
+ * Copyright (C) 2013-2014 Jason Allen
+ *
+ * This file is part of the Jade Diagram Editor.
+ *
+ * Jade is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Jade is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Jade.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <DrawingSnapshot.h>
+#include <DrawingScene.h>
+#include <DrawingItem.h>
+#include <DrawingItemGroup.h>
+
+DrawingSnapshot::DrawingSnapshot(DrawingView* view)
+{
+	DrawingScene* scene = (view) ? view->scene() : nullptr;
+
+	mUnits = UnitsMils;
+	mBorderWidth = 0;
+	mGrid = 0;
+	mSelectionMode = Qt::ContainsItemBoundingRect;
+	mForcingItemsInside = false;
+	mHasScene = (scene != nullptr);
+
+	mAlignment = Qt::AlignCenter;
+	mViewportAnchor = DrawingView::AnchorUnderMouse;
+
+	if (view)
+	{
+		mStyleOptions = view->styleOptions();
+		mAlignment = view->alignment();
+		mViewportAnchor = view->viewportAnchor();
+	}
+
+	if (scene)
+	{
+		const QList<DrawingItem*>& lItems = scene->items();
+
+		mSceneRect = scene->sceneRect();
+		mContentsRect = scene->contentsRect();
+		mUnits = scene->units();
+		mBorderWidth = scene->borderWidth();
+		mGrid = scene->grid();
+		mSelectionMode = scene->selectionMode();
+		mForcingItemsInside = scene->isForcingItemsInside();
+
+		mItems = DrawingItem::copyItems(lItems);
+		convertPixmaps(mItems);
+
+		for(int itemIndex = 0; itemIndex < lItems.size(); itemIndex++)
+			mItems[itemIndex]->mId = lItems[itemIndex]->mId;
+	}
+}
+
+DrawingSnapshot::~DrawingSnapshot()
+{
+	while (!mItems.isEmpty()) delete mItems.takeFirst();
+}
+
+//==================================================================================================
+
+int DrawingSnapshot::numberOfItems() const
+{
+	return mItems.size();
+}
+
+int DrawingSnapshot::numberOfItemsWritten() const
+{
+	return mNumberOfItemsWritten.load();
+}
+
+//==================================================================================================
+
+void DrawingSnapshot::writeXmlAttributes(QXmlStreamWriter& xmlWriter)
+{
+	if (mHasScene)
+	{
+		DrawingScene::writeSceneXmlAttributes(xmlWriter, mSceneRect, mContentsRect, mUnits,
+			mBorderWidth, mGrid, mSelectionMode, mForcingItemsInside);
+	}
+
+	DrawingView::writeViewXmlAttributes(xmlWriter, mAlignment, mViewportAnchor, mStyleOptions);
+}
+
+void DrawingSnapshot::writeXmlChildElements(QXmlStreamWriter& xmlWriter)
+{
+	mNumberOfItemsWritten.store(0);
+
+	if (mHasScene) DrawingScene::writeItemsXmlElements(xmlWriter, mItems, &mNumberOfItemsWritten);
+}
+
+void DrawingSnapshot::writeBinary(QDataStream& stream)
+{
+	mNumberOfItemsWritten.store(0);
+
+	DrawingView::writeViewBinary(stream, mAlignment, mViewportAnchor, mStyleOptions);
+
+	stream << mHasScene;
+	if (mHasScene)
+	{
+		DrawingScene::writeSceneBinary(stream, mSceneRect, mContentsRect, mUnits,
+			mBorderWidth, mGrid, mSelectionMode, mForcingItemsInside);
+		DrawingScene::writeItemsBinary(stream, mItems, &mNumberOfItemsWritten);
+	}
+}
+
+//==================================================================================================
+
+void DrawingSnapshot::convertPixmaps(const QList<DrawingItem*>& items)
+{
+	DrawingItemGroup* itemGroup;
+
+	for(auto itemIter = items.begin(); itemIter != items.end(); itemIter++)
+	{
+		auto propertyIter = (*itemIter)->mProperties.find(DrawingItem::ImageProperty);
+		if (propertyIter != (*itemIter)->mProperties.end() && propertyIter.value().type() == QVariant::Pixmap)
+			propertyIter.value() = propertyIter.value().value<QPixmap>().toImage();
+
+		itemGroup = dynamic_cast<DrawingItemGroup*>(*itemIter);
+		if (itemGroup) convertPixmaps(itemGroup->items());
+	}
+}
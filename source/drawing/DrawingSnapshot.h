@@ -0,0 +1,77 @@
+/* DrawingSnapshot.h
+ *
+ * Copyright (C) 2013-2014 Jason Allen
+ *
+ * This file is part of the Jade Diagram Editor.
+ *
+ * Jade is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Jade is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Jade.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef DRAWINGSNAPSHOT_H
+#define DRAWINGSNAPSHOT_H
+
+#include <DrawingView.h>
+
+/* The DrawingSnapshot class holds a copy of a view's settings, its scene's settings, and its scene's
+ * items so that the diagram can be written out on another thread while the user keeps editing the
+ * original.
+ *
+ * The copied items are only kept in a list, not added to a scene, so taking the snapshot does not
+ * build any of the indexes a scene keeps for its items.  The items' properties and styles are
+ * implicitly shared with the originals.  Item ids are kept, so the file is the same as one written
+ * from the original scene.
+ *
+ * A snapshot must be created on the GUI thread, since images held as QPixmap (which may only be
+ * used on the GUI thread) are converted to QImage when the snapshot is taken.  After that it may be
+ * written from any one thread, and numberOfItemsWritten() may be read from the GUI thread at the
+ * same time to report progress.
+ */
+class DrawingSnapshot
+{
+private:
+	QList<DrawingItem*> mItems;
+	QAtomicInt mNumberOfItemsWritten;
+
+	QRectF mSceneRect;
+	QRectF mContentsRect;
+	DrawingUnits mUnits;
+	qreal mBorderWidth;
+	qreal mGrid;
+	Qt::ItemSelectionMode mSelectionMode;
+	bool mForcingItemsInside;
+	bool mHasScene;
+
+	DrawingStyleOptions mStyleOptions;
+	Qt::Alignment mAlignment;
+	DrawingView::ViewportAnchor mViewportAnchor;
+
+public:
+	DrawingSnapshot(DrawingView* view);
+	~DrawingSnapshot();
+
+	int numberOfItems() const;
+	int numberOfItemsWritten() const;
+
+	void writeXmlAttributes(QXmlStreamWriter& xmlWriter);
+	void writeXmlChildElements(QXmlStreamWriter& xmlWriter);
+	void writeBinary(QDataStream& stream);
+
+private:
+	static void convertPixmaps(const QList<DrawingItem*>& items);
+
+	DrawingSnapshot(const DrawingSnapshot&);
+	DrawingSnapshot& operator=(const DrawingSnapshot&);
+};
+
+#endif
@@ -0,0 +1,411 @@
+/* DrawingSpatialIndex.cpp
+ *
+ * Copyright (C) 2013-2014 Jason Allen
+ *
+ * This file is part of the Jade Diagram Editor.
+ *
+ * Jade is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Jade is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Jade.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <DrawingSpatialIndex.h>
+
+DrawingSpatialIndex::DrawingSpatialIndex()
+{
+	mRoot = -1;
+	mFreeList = -1;
+}
+
+DrawingSpatialIndex::~DrawingSpatialIndex() { }
+
+//==================================================================================================
+
+void DrawingSpatialIndex::insertItem(DrawingItem* item, const QRectF& sceneRect)
+{
+	if (item && !mLeaves.contains(item))
+	{
+		int leaf = allocateNode();
+
+		mNodes[leaf].rect = sceneRect.normalized();
+		mNodes[leaf].item = item;
+		insertLeaf(leaf);
+
+		mLeaves.insert(item, leaf);
+	}
+}
+
+void DrawingSpatialIndex::removeItem(DrawingItem* item)
+{
+	auto leafIter = mLeaves.find(item);
+
+	if (leafIter != mLeaves.end())
+	{
+		int leaf = leafIter.value();
+
+		mLeaves.erase(leafIter);
+		removeLeaf(leaf);
+		freeNode(leaf);
+	}
+}
+
+void DrawingSpatialIndex::updateItem(DrawingItem* item, const QRectF& sceneRect)
+{
+	auto leafIter = mLeaves.find(item);
+
+	if (leafIter != mLeaves.end())
+	{
+		int leaf = leafIter.value();
+		QRectF rect = sceneRect.normalized();
+
+		if (mNodes[leaf].rect != rect)
+		{
+			removeLeaf(leaf);
+			mNodes[leaf].rect = rect;
+			insertLeaf(leaf);
+		}
+	}
+	else insertItem(item, sceneRect);
+}
+
+void DrawingSpatialIndex::clear()
+{
+	mNodes.clear();
+	mLeaves.clear();
+	mRoot = -1;
+	mFreeList = -1;
+}
+
+//==================================================================================================
+
+bool DrawingSpatialIndex::containsItem(DrawingItem* item) const
+{
+	return mLeaves.contains(item);
+}
+
+QRectF DrawingSpatialIndex::itemRect(DrawingItem* item) const
+{
+	QRectF rect;
+
+	auto leafIter = mLeaves.find(item);
+	if (leafIter != mLeaves.end()) rect = mNodes[leafIter.value()].rect;
+
+	return rect;
+}
+
+int DrawingSpatialIndex::numberOfItems() const
+{
+	return mLeaves.size();
+}
+
+//==================================================================================================
+
+QList<DrawingItem*> DrawingSpatialIndex::items(const QRectF& sceneRect) const
+{
+	QList<DrawingItem*> items;
+	QVarLengthArray<int,64> nodesToVisit;
+	QRectF rect = sceneRect.normalized();
+	int index;
+
+	if (mRoot >= 0) nodesToVisit.append(mRoot);
+
+	while (!nodesToVisit.isEmpty())
+	{
+		index = nodesToVisit.last();
+		nodesToVisit.removeLast();
+
+		const Node& node = mNodes[index];
+		if (overlaps(node.rect, rect))
+		{
+			if (node.child1 < 0) items.append(node.item);
+			else
+			{
+				nodesToVisit.append(node.child1);
+				nodesToVisit.append(node.child2);
+			}
+		}
+	}
+
+	return items;
+}
+
+QList<DrawingItem*> DrawingSpatialIndex::items(const QPointF& scenePos) const
+{
+	return items(QRectF(scenePos, QSizeF(0, 0)));
+}
+
+//==================================================================================================
+
+int DrawingSpatialIndex::allocateNode()
+{
+	int index;
+
+	if (mFreeList >= 0)
+	{
+		index = mFreeList;
+		mFreeList = mNodes[index].parent;
+	}
+	else
+	{
+		index = mNodes.size();
+		mNodes.append(Node());
+	}
+
+	Node& node = mNodes[index];
+	node.rect = QRectF();
+	node.item = nullptr;
+	node.parent = -1;
+	node.child1 = -1;
+	node.child2 = -1;
+	node.height = 0;
+
+	return index;
+}
+
+void DrawingSpatialIndex::freeNode(int index)
+{
+	mNodes[index].item = nullptr;
+	mNodes[index].parent = mFreeList;
+	mNodes[index].height = -1;
+	mFreeList = index;
+}
+
+//==================================================================================================
+
+void DrawingSpatialIndex::insertLeaf(int leaf)
+{
+	if (mRoot < 0)
+	{
+		mRoot = leaf;
+		mNodes[leaf].parent = -1;
+	}
+	else
+	{
+		QRectF leafRect = mNodes[leaf].rect;
+		int index = mRoot;
+
+		// Find the best sibling for the new leaf, growing the tree's total perimeter as little as
+		// possible
+		while (mNodes[index].child1 >= 0)
+		{
+			int child1 = mNodes[index].child1;
+			int child2 = mNodes[index].child2;
+
+			qreal combinedPerimeter = perimeter(unite(mNodes[index].rect, leafRect));
+			qreal cost = 2 * combinedPerimeter;
+			qreal inheritanceCost = 2 * (combinedPerimeter - perimeter(mNodes[index].rect));
+
+			qreal cost1 = perimeter(unite(leafRect, mNodes[child1].rect)) + inheritanceCost;
+			if (mNodes[child1].child1 >= 0) cost1 -= perimeter(mNodes[child1].rect);
+
+			qreal cost2 = perimeter(unite(leafRect, mNodes[child2].rect)) + inheritanceCost;
+			if (mNodes[child2].child1 >= 0) cost2 -= perimeter(mNodes[child2].rect);
+
+			if (cost < cost1 && cost < cost2) break;
+
+			index = (cost1 < cost2) ? child1 : child2;
+		}
+
+		// Create a new parent for the sibling and the new leaf
+		int sibling = index;
+		int oldParent = mNodes[sibling].parent;
+		int newParent = allocateNode();
+
+		mNodes[newParent].parent = oldParent;
+		mNodes[newParent].rect = unite(leafRect, mNodes[sibling].rect);
+		mNodes[newParent].height = mNodes[sibling].height + 1;
+		mNodes[newParent].child1 = sibling;
+		mNodes[newParent].child2 = leaf;
+		mNodes[sibling].parent = newParent;
+		mNodes[leaf].parent = newParent;
+
+		if (oldParent < 0) mRoot = newParent;
+		else if (mNodes[oldParent].child1 == sibling) mNodes[oldParent].child1 = newParent;
+		else mNodes[oldParent].child2 = newParent;
+
+		// Walk back up the tree fixing heights and rects
+		index = mNodes[leaf].parent;
+		while (index >= 0)
+		{
+			index = balance(index);
+
+			Node& node = mNodes[index];
+			node.height = 1 + qMax(mNodes[node.child1].height, mNodes[node.child2].height);
+			node.rect = unite(mNodes[node.child1].rect, mNodes[node.child2].rect);
+
+			index = node.parent;
+		}
+	}
+}
+
+void DrawingSpatialIndex::removeLeaf(int leaf)
+{
+	if (leaf == mRoot)
+	{
+		mRoot = -1;
+	}
+	else
+	{
+		int parent = mNodes[leaf].parent;
+		int grandParent = mNodes[parent].parent;
+		int sibling = (mNodes[parent].child1 == leaf) ? mNodes[parent].child2 : mNodes[parent].child1;
+
+		if (grandParent >= 0)
+		{
+			// Destroy parent and connect sibling to grandParent
+			if (mNodes[grandParent].child1 == parent) mNodes[grandParent].child1 = sibling;
+			else mNodes[grandParent].child2 = sibling;
+			mNodes[sibling].parent = grandParent;
+			freeNode(parent);
+
+			// Walk back up the tree fixing heights and rects
+			int index = grandParent;
+			while (index >= 0)
+			{
+				index = balance(index);
+
+				Node& node = mNodes[index];
+				node.height = 1 + qMax(mNodes[node.child1].height, mNodes[node.child2].height);
+				node.rect = unite(mNodes[node.child1].rect, mNodes[node.child2].rect);
+
+				index = node.parent;
+			}
+		}
+		else
+		{
+			mRoot = sibling;
+			mNodes[sibling].parent = -1;
+			freeNode(parent);
+		}
+	}
+
+	mNodes[leaf].parent = -1;
+}
+
+int DrawingSpatialIndex::balance(int indexA)
+{
+	Node& a = mNodes[indexA];
+	if (a.child1 < 0 || a.height < 2) return indexA;
+
+	int indexB = a.child1;
+	int indexC = a.child2;
+	Node& b = mNodes[indexB];
+	Node& c = mNodes[indexC];
+	int heightDifference = c.height - b.height;
+
+	if (heightDifference > 1)
+	{
+		// Rotate C up
+		int indexF = c.child1;
+		int indexG = c.child2;
+		Node& f = mNodes[indexF];
+		Node& g = mNodes[indexG];
+
+		c.child1 = indexA;
+		c.parent = a.parent;
+		a.parent = indexC;
+
+		if (c.parent < 0) mRoot = indexC;
+		else if (mNodes[c.parent].child1 == indexA) mNodes[c.parent].child1 = indexC;
+		else mNodes[c.parent].child2 = indexC;
+
+		if (f.height > g.height)
+		{
+			c.child2 = indexF;
+			a.child2 = indexG;
+			g.parent = indexA;
+			a.rect = unite(b.rect, g.rect);
+			c.rect = unite(a.rect, f.rect);
+			a.height = 1 + qMax(b.height, g.height);
+			c.height = 1 + qMax(a.height, f.height);
+		}
+		else
+		{
+			c.child2 = indexG;
+			a.child2 = indexF;
+			f.parent = indexA;
+			a.rect = unite(b.rect, f.rect);
+			c.rect = unite(a.rect, g.rect);
+			a.height = 1 + qMax(b.height, f.height);
+			c.height = 1 + qMax(a.height, g.height);
+		}
+
+		return indexC;
+	}
+
+	if (heightDifference < -1)
+	{
+		// Rotate B up
+		int indexD = b.child1;
+		int indexE = b.child2;
+		Node& d = mNodes[indexD];
+		Node& e = mNodes[indexE];
+
+		b.child1 = indexA;
+		b.parent = a.parent;
+		a.parent = indexB;
+
+		if (b.parent < 0) mRoot = indexB;
+		else if (mNodes[b.parent].child1 == indexA) mNodes[b.parent].child1 = indexB;
+		else mNodes[b.parent].child2 = indexB;
+
+		if (d.height > e.height)
+		{
+			b.child2 = indexD;
+			a.child1 = indexE;
+			e.parent = indexA;
+			a.rect = unite(c.rect, e.rect);
+			b.rect = unite(a.rect, d.rect);
+			a.height = 1 + qMax(c.height, e.height);
+			b.height = 1 + qMax(a.height, d.height);
+		}
+		else
+		{
+			b.child2 = indexE;
+			a.child1 = indexD;
+			d.parent = indexA;
+			a.rect = unite(c.rect, d.rect);
+			b.rect = unite(a.rect, e.rect);
+			a.height = 1 + qMax(c.height, d.height);
+			b.height = 1 + qMax(a.height, e.height);
+		}
+
+		return indexB;
+	}
+
+	return indexA;
+}
+
+//==================================================================================================
+
+QRectF DrawingSpatialIndex::unite(const QRectF& rect1, const QRectF& rect2)
+{
+	// QRectF::united() ignores null rects, but zero-sized rects are valid entries in the index
+	qreal left = qMin(rect1.left(), rect2.left());
+	qreal top = qMin(rect1.top(), rect2.top());
+	qreal right = qMax(rect1.right(), rect2.right());
+	qreal bottom = qMax(rect1.bottom(), rect2.bottom());
+
+	return QRectF(left, top, right - left, bottom - top);
+}
+
+bool DrawingSpatialIndex::overlaps(const QRectF& rect1, const QRectF& rect2)
+{
+	// QRectF::intersects() always fails for zero-sized rects, so test the edges directly
+	return (rect1.left() <= rect2.right() && rect2.left() <= rect1.right() &&
+		rect1.top() <= rect2.bottom() && rect2.top() <= rect1.bottom());
+}
+
+qreal DrawingSpatialIndex::perimeter(const QRectF& rect)
+{
+	return 2 * (rect.width() + rect.height());
+}
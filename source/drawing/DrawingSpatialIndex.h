@@ -0,0 +1,86 @@
+/* DrawingSpatialIndex.h
+ *
+ * Copyright (C) 2013-2014 Jason Allen
+ *
+ * This file is part of the Jade Diagram Editor.
+ *
+ * Jade is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Jade is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Jade.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef DRAWINGSPATIALINDEX_H
+#define DRAWINGSPATIALINDEX_H
+
+#include <DrawingGlobals.h>
+
+/* The DrawingSpatialIndex class is a dynamic bounding volume hierarchy used by DrawingScene to
+ * find items by their location in the scene.
+ *
+ * Each item is stored as a leaf of a balanced binary tree of rects, where each internal node
+ * holds the union of its two children.  Inserting, removing, or updating an item takes O(log n)
+ * time.  A rect or point query only descends into branches that overlap it, so it takes
+ * O(log n + k) time for k results.
+ *
+ * The index only narrows down the candidates for a query.  The rect stored for an item must
+ * contain everything about the item that a query could match, and the caller is responsible for
+ * testing each candidate returned against the item's actual shape.
+ */
+class DrawingSpatialIndex
+{
+private:
+	struct Node
+	{
+		QRectF rect;
+		DrawingItem* item;
+		int parent;
+		int child1;
+		int child2;
+		int height;
+	};
+
+	QVector<Node> mNodes;
+	int mRoot;
+	int mFreeList;
+
+	QHash<DrawingItem*,int> mLeaves;
+
+public:
+	DrawingSpatialIndex();
+	~DrawingSpatialIndex();
+
+	void insertItem(DrawingItem* item, const QRectF& sceneRect);
+	void removeItem(DrawingItem* item);
+	void updateItem(DrawingItem* item, const QRectF& sceneRect);
+	void clear();
+
+	bool containsItem(DrawingItem* item) const;
+	QRectF itemRect(DrawingItem* item) const;
+	int numberOfItems() const;
+
+	QList<DrawingItem*> items(const QRectF& sceneRect) const;
+	QList<DrawingItem*> items(const QPointF& scenePos) const;
+
+private:
+	int allocateNode();
+	void freeNode(int index);
+
+	void insertLeaf(int leaf);
+	void removeLeaf(int leaf);
+	int balance(int index);
+
+	static QRectF unite(const QRectF& rect1, const QRectF& rect2);
+	static bool overlaps(const QRectF& rect1, const QRectF& rect2);
+	static qreal perimeter(const QRectF& rect);
+};
+
+#endif
@@ -0,0 +1,277 @@
+/* DrawingStyleTable.cpp
+ *
+ * Copyright (C) 2013-2014 Jason Allen
+ *
+ * This file is part of the Jade Diagram Editor.
+ *
+ * Jade is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Jade is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Jade.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <DrawingStyleTable.h>
+#include <DrawingItem.h>
+
+DrawingStyleTable::DrawingStyleTable() { }
+
+DrawingStyleTable::~DrawingStyleTable() { }
+
+//==================================================================================================
+
+int DrawingStyleTable::addStyle(const QHash<int, QVariant>& style)
+{
+	QString key = styleKey(style);
+
+	auto idIter = mStyleIds.find(key);
+	if (idIter == mStyleIds.end())
+	{
+		idIter = mStyleIds.insert(key, mStyles.size());
+		mStyles.append(style);
+	}
+
+	return idIter.value();
+}
+
+void DrawingStyleTable::clear()
+{
+	mStyles.clear();
+	mStyleIds.clear();
+}
+
+//==================================================================================================
+
+int DrawingStyleTable::styleId(const QHash<int, QVariant>& style) const
+{
+	return mStyleIds.value(styleKey(style), -1);
+}
+
+QHash<int, QVariant> DrawingStyleTable::style(int id) const
+{
+	return mStyles.value(id);
+}
+
+int DrawingStyleTable::numberOfStyles() const
+{
+	return mStyles.size();
+}
+
+//==================================================================================================
+
+void DrawingStyleTable::writeToXml(QXmlStreamWriter& xmlWriter) const
+{
+	for(auto styleIter = mStyles.begin(); styleIter != mStyles.end(); styleIter++)
+	{
+		xmlWriter.writeStartElement("style");
+		writeStyleAttributes(xmlWriter, *styleIter);
+		xmlWriter.writeEndElement();
+	}
+}
+
+void DrawingStyleTable::readFromXml(QXmlStreamReader& xmlReader)
+{
+	QHash<int, QVariant> style;
+	QString key;
+
+	clear();
+
+	while (xmlReader.readNextStartElement())
+	{
+		if (xmlReader.name() == "style")
+		{
+			// Styles are referred to by their position in the file, so duplicates keep their place
+			style = readStyleAttributes(xmlReader.attributes());
+			key = styleKey(style);
+
+			if (!mStyleIds.contains(key)) mStyleIds.insert(key, mStyles.size());
+			mStyles.append(style);
+		}
+
+		xmlReader.skipCurrentElement();
+	}
+}
+
+//==================================================================================================
+
+void DrawingStyleTable::writeToBinary(QDataStream& stream) const
+{
+	stream << (quint32)mStyles.size();
+
+	for(auto styleIter = mStyles.begin(); styleIter != mStyles.end(); styleIter++)
+		DrawingItem::writePropertiesToBinary(stream, *styleIter);
+}
+
+void DrawingStyleTable::readFromBinary(QDataStream& stream)
+{
+	QHash<int, QVariant> style;
+	QString key;
+	quint32 numberOfStyles;
+
+	clear();
+
+	stream >> numberOfStyles;
+
+	for(quint32 i = 0; i < numberOfStyles && stream.status() == QDataStream::Ok; i++)
+	{
+		style = DrawingItem::readPropertiesFromBinary(stream);
+		key = styleKey(style);
+
+		if (!mStyleIds.contains(key)) mStyleIds.insert(key, mStyles.size());
+		mStyles.append(style);
+	}
+}
+
+//==================================================================================================
+
+void DrawingStyleTable::writeStyleAttributes(QXmlStreamWriter& xmlWriter, const QHash<int, QVariant>& style)
+{
+	QList<int> properties = style.keys();
+
+	qSort(properties);
+
+	for(auto propertyIter = properties.begin(); propertyIter != properties.end(); propertyIter++)
+	{
+		QString name = attributeName(*propertyIter);
+		if (!name.isEmpty())
+			xmlWriter.writeAttribute(name, valueToString(*propertyIter, style.value(*propertyIter)));
+	}
+}
+
+QHash<int, QVariant> DrawingStyleTable::readStyleAttributes(const QXmlStreamAttributes& attributes)
+{
+	QHash<int, QVariant> style;
+	QString name;
+
+	for(int property = 0; property < DrawingItem::NumberOfStandardProperties; property++)
+	{
+		name = attributeName(property);
+		if (!name.isEmpty() && attributes.hasAttribute(name))
+			style[property] = valueFromString(property, attributes.value(name).toString());
+	}
+
+	return style;
+}
+
+//==================================================================================================
+
+QString DrawingStyleTable::styleKey(const QHash<int, QVariant>& style)
+{
+	QList<int> properties = style.keys();
+	QString key;
+
+	qSort(properties);
+
+	for(auto propertyIter = properties.begin(); propertyIter != properties.end(); propertyIter++)
+	{
+		key += QString::number(*propertyIter) + "=" +
+			valueToString(*propertyIter, style.value(*propertyIter)) + ";";
+	}
+
+	return key;
+}
+
+//==================================================================================================
+
+QString DrawingStyleTable::attributeName(int property)
+{
+	QString name;
+
+	switch (property)
+	{
+	case DrawingItem::PenColorProperty: name = "penColor"; break;
+	case DrawingItem::PenWidthProperty: name = "penWidth"; break;
+	case DrawingItem::PenStyleProperty: name = "penStyle"; break;
+	case DrawingItem::PenCapStyleProperty: name = "penCapStyle"; break;
+	case DrawingItem::PenJoinStyleProperty: name = "penJoinStyle"; break;
+	case DrawingItem::BrushColorProperty: name = "brushColor"; break;
+	case DrawingItem::FontFamilyProperty: name = "fontFamily"; break;
+	case DrawingItem::FontSizeProperty: name = "fontSize"; break;
+	case DrawingItem::FontBoldProperty: name = "fontBold"; break;
+	case DrawingItem::FontItalicProperty: name = "fontItalic"; break;
+	case DrawingItem::FontUnderlineProperty: name = "fontUnderline"; break;
+	case DrawingItem::FontOverlineProperty: name = "fontOverline"; break;
+	case DrawingItem::FontStrikeOutProperty: name = "fontStrikeOut"; break;
+	case DrawingItem::TextColorProperty: name = "textColor"; break;
+	default: break;
+	}
+
+	return name;
+}
+
+QString DrawingStyleTable::valueToString(int property, const QVariant& value)
+{
+	QString str;
+
+	switch (property)
+	{
+	case DrawingItem::PenColorProperty:
+	case DrawingItem::BrushColorProperty:
+	case DrawingItem::TextColorProperty:
+		str = Drawing::colorToString(value.value<QColor>());
+		break;
+	case DrawingItem::PenWidthProperty:
+	case DrawingItem::FontSizeProperty:
+		str = QString::number(value.toDouble());
+		break;
+	case DrawingItem::PenStyleProperty:
+	case DrawingItem::PenCapStyleProperty:
+	case DrawingItem::PenJoinStyleProperty:
+		str = QString::number(value.toUInt());
+		break;
+	case DrawingItem::FontBoldProperty:
+	case DrawingItem::FontItalicProperty:
+	case DrawingItem::FontUnderlineProperty:
+	case DrawingItem::FontOverlineProperty:
+	case DrawingItem::FontStrikeOutProperty:
+		str = (value.toBool()) ? "true" : "false";
+		break;
+	default:
+		str = value.toString();
+		break;
+	}
+
+	return str;
+}
+
+QVariant DrawingStyleTable::valueFromString(int property, const QString& str)
+{
+	QVariant value;
+
+	switch (property)
+	{
+	case DrawingItem::PenColorProperty:
+	case DrawingItem::BrushColorProperty:
+	case DrawingItem::TextColorProperty:
+		value = Drawing::colorFromString(str);
+		break;
+	case DrawingItem::PenWidthProperty:
+	case DrawingItem::FontSizeProperty:
+		value = str.toDouble();
+		break;
+	case DrawingItem::PenStyleProperty:
+	case DrawingItem::PenCapStyleProperty:
+	case DrawingItem::PenJoinStyleProperty:
+		value = str.toUInt();
+		break;
+	case DrawingItem::FontBoldProperty:
+	case DrawingItem::FontItalicProperty:
+	case DrawingItem::FontUnderlineProperty:
+	case DrawingItem::FontOverlineProperty:
+	case DrawingItem::FontStrikeOutProperty:
+		value = (str.toLower() == "true");
+		break;
+	default:
+		value = str;
+		break;
+	}
+
+	return value;
+}
@@ -0,0 +1,71 @@
+/* DrawingStyleTable.h
+ *
+ * Copyright (C) 2013-2014 Jason Allen
+ *
+ * This file is part of the Jade Diagram Editor.
+ *
+ * Jade is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Jade is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Jade.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef DRAWINGSTYLETABLE_H
+#define DRAWINGSTYLETABLE_H
+
+#include <DrawingGlobals.h>
+
+/* The DrawingStyleTable class holds one copy of each distinct item style.
+ *
+ * An item's style is the set of its pen, brush, font, and text color properties (see
+ * DrawingItem::isStyleProperty).  Styles are identified by their position in the table.  Since the
+ * stored styles are implicitly shared, an item that is given the table's copy of its style shares
+ * that copy with every other item of the same style.
+ *
+ * DrawingScene keeps a table of the styles of its items, and a table of only the styles in use is
+ * written once at the start of a diagram file so that each item only needs to refer to its style
+ * by id.
+ */
+class DrawingStyleTable
+{
+private:
+	QList< QHash<int, QVariant> > mStyles;
+	QHash<QString, int> mStyleIds;
+
+public:
+	DrawingStyleTable();
+	~DrawingStyleTable();
+
+	int addStyle(const QHash<int, QVariant>& style);
+	void clear();
+
+	int styleId(const QHash<int, QVariant>& style) const;
+	QHash<int, QVariant> style(int id) const;
+	int numberOfStyles() const;
+
+	void writeToXml(QXmlStreamWriter& xmlWriter) const;
+	void readFromXml(QXmlStreamReader& xmlReader);
+
+	void writeToBinary(QDataStream& stream) const;
+	void readFromBinary(QDataStream& stream);
+
+	static void writeStyleAttributes(QXmlStreamWriter& xmlWriter, const QHash<int, QVariant>& style);
+	static QHash<int, QVariant> readStyleAttributes(const QXmlStreamAttributes& attributes);
+
+private:
+	static QString styleKey(const QHash<int, QVariant>& style);
+
+	static QString attributeName(int property);
+	static QString valueToString(int property, const QVariant& value);
+	static QVariant valueFromString(int property, const QString& str);
+};
+
+#endif
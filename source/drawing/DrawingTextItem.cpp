@@ -23,17 +23,17 @@
 
 DrawingTextItem::DrawingTextItem() : DrawingItem()
 {
-	addProperty("Font Family", "Arial");
-	addProperty("Font Size", 100.0);
-	addProperty("Font Bold", false);
-	addProperty("Font Italic", false);
-	addProperty("Font Underline", false);
-	addProperty("Font Overline", false);
-	addProperty("Font Strike-Out", false);
-	addProperty("Text Horizontal Alignment", Qt::AlignHCenter);
-	addProperty("Text Vertical Alignment", Qt::AlignVCenter);
-	addProperty("Text Color", QColor(255, 0, 255));
-	addProperty("Caption", "Label");
+	addProperty(FontFamilyProperty, "Arial");
+	addProperty(FontSizeProperty, 100.0);
+	addProperty(FontBoldProperty, false);
+	addProperty(FontItalicProperty, false);
+	addProperty(FontUnderlineProperty, false);
+	addProperty(FontOverlineProperty, false);
+	addProperty(FontStrikeOutProperty, false);
+	addProperty(TextHorizontalAlignmentProperty, Qt::AlignHCenter);
+	addProperty(TextVerticalAlignmentProperty, Qt::AlignVCenter);
+	addProperty(TextColorProperty, QColor(255, 0, 255));
+	addProperty(CaptionProperty, "Label");
 
 	setFlags(CanMove | CanRotate | CanFlip | MatchUnitsWithParent);
 	setPlaceType(PlaceMouseUp);
@@ -72,37 +72,37 @@ void DrawingTextItem::setFont(const QFont& font)
 
 void DrawingTextItem::setFontFamily(const QString& family)
 {
-	setPropertyValue("Font Family", family);
+	setPropertyValue(FontFamilyProperty, family);
 }
 
 void DrawingTextItem::setFontSize(qreal size)
 {
-	setPropertyValue("Font Size", size);
+	setPropertyValue(FontSizeProperty, size);
 }
 
 void DrawingTextItem::setFontBold(bool bold)
 {
-	setPropertyValue("Font Bold", bold);
+	setPropertyValue(FontBoldProperty, bold);
 }
 
 void DrawingTextItem::setFontItalic(bool italic)
 {
-	setPropertyValue("Font Italic", italic);
+	setPropertyValue(FontItalicProperty, italic);
 }
 
 void DrawingTextItem::setFontUnderline(bool underline)
 {
-	setPropertyValue("Font Underline", underline);
+	setPropertyValue(FontUnderlineProperty, underline);
 }
 
 void DrawingTextItem::setFontOverline(bool overline)
 {
-	setPropertyValue("Font Overline", overline);
+	setPropertyValue(FontOverlineProperty, overline);
 }
 
 void DrawingTextItem::setFontStrikeOut(bool strikeOut)
 {
-	setPropertyValue("Font Strike-Out", strikeOut);
+	setPropertyValue(FontStrikeOutProperty, strikeOut);
 }
 
 QFont DrawingTextItem::font() const
@@ -122,49 +122,49 @@ QFont DrawingTextItem::font() const
 
 QString DrawingTextItem::fontFamily() const
 {
-	return propertyValue("Font Family").toString();
+	return propertyValue(FontFamilyProperty).toString();
 }
 
 qreal DrawingTextItem::fontSize() const
 {
-	return propertyValue("Font Size").toDouble();
+	return propertyValue(FontSizeProperty).toDouble();
 }
 
 bool DrawingTextItem::isFontBold() const
 {
-	return propertyValue("Font Bold").toBool();
+	return propertyValue(FontBoldProperty).toBool();
 }
 
 bool DrawingTextItem::isFontItalic() const
 {
-	return propertyValue("Font Italic").toBool();
+	return propertyValue(FontItalicProperty).toBool();
 }
 
 bool DrawingTextItem::isFontUnderline() const
 {
-	return propertyValue("Font Underline").toBool();
+	return propertyValue(FontUnderlineProperty).toBool();
 }
 
 bool DrawingTextItem::isFontOverline() const
 {
-	return propertyValue("Font Overline").toBool();
+	return propertyValue(FontOverlineProperty).toBool();
 }
 
 bool DrawingTextItem::isFontStrikeOut() const
 {
-	return propertyValue("Font Strike-Out").toBool();
+	return propertyValue(FontStrikeOutProperty).toBool();
 }
 
 //==================================================================================================
 
 void DrawingTextItem::setAlignmentHorizontal(Qt::Alignment alignment)
 {
-	setPropertyValue("Text Horizontal Alignment", QVariant((quint32)(alignment & Qt::AlignHorizontal_Mask)));
+	setPropertyValue(TextHorizontalAlignmentProperty, QVariant((quint32)(alignment & Qt::AlignHorizontal_Mask)));
 }
 
 void DrawingTextItem::setAlignmentVertical(Qt::Alignment alignment)
 {
-	setPropertyValue("Text Vertical Alignment", QVariant((quint32)(alignment & Qt::AlignVertical_Mask)));
+	setPropertyValue(TextVerticalAlignmentProperty, QVariant((quint32)(alignment & Qt::AlignVertical_Mask)));
 }
 
 void DrawingTextItem::setAlignment(Qt::Alignment alignment)
@@ -175,12 +175,12 @@ void DrawingTextItem::setAlignment(Qt::Alignment alignment)
 
 Qt::Alignment DrawingTextItem::alignmentHorizontal() const
 {
-	return (Qt::Alignment)propertyValue("Text Horizontal Alignment").toUInt();
+	return (Qt::Alignment)propertyValue(TextHorizontalAlignmentProperty).toUInt();
 }
 
 Qt::Alignment DrawingTextItem::alignmentVertical() const
 {
-	return (Qt::Alignment)propertyValue("Text Vertical Alignment").toUInt();
+	return (Qt::Alignment)propertyValue(TextVerticalAlignmentProperty).toUInt();
 }
 
 Qt::Alignment DrawingTextItem::alignment() const
@@ -192,24 +192,24 @@ Qt::Alignment DrawingTextItem::alignment() const
 
 void DrawingTextItem::setColor(const QColor& color)
 {
-	setPropertyValue("Text Color", color);
+	setPropertyValue(TextColorProperty, color);
 }
 
 QColor DrawingTextItem::color() const
 {
-	return propertyValue("Text Color").value<QColor>();
+	return propertyValue(TextColorProperty).value<QColor>();
 }
 
 //==================================================================================================
 
 void DrawingTextItem::setCaption(const QString& caption)
 {
-	setPropertyValue("Caption", QVariant(caption));
+	setPropertyValue(CaptionProperty, QVariant(caption));
 }
 
 QString DrawingTextItem::caption() const
 {
-	return propertyValue("Caption").toString();
+	return propertyValue(CaptionProperty).toString();
 }
 
 //==================================================================================================
@@ -319,15 +319,7 @@ void DrawingTextItem::writeXmlAttributes(QXmlStreamWriter& xmlWriter, const QLis
 {
 	DrawingItem::writeXmlAttributes(xmlWriter, items);
 
-	xmlWriter.writeAttribute("fontFamily", fontFamily());
-	xmlWriter.writeAttribute("fontSize", QString::number(fontSize()));
-	xmlWriter.writeAttribute("fontBold", isFontBold() ? "true" : "false");
-	xmlWriter.writeAttribute("fontItalic", isFontItalic() ? "true" : "false");
-	xmlWriter.writeAttribute("fontUnderline", isFontUnderline() ? "true" : "false");
-	xmlWriter.writeAttribute("fontOverline", isFontOverline() ? "true" : "false");
-	xmlWriter.writeAttribute("fontStrikeOut", isFontStrikeOut() ? "true" : "false");
 	xmlWriter.writeAttribute("textAlignment", QString::number((quint32)alignment()));
-	xmlWriter.writeAttribute("textColor", Drawing::colorToString(color()));
 	xmlWriter.writeAttribute("caption", caption());
 }
 
@@ -337,27 +329,9 @@ void DrawingTextItem::readXmlAttributes(QXmlStreamReader& xmlReader, const QList
 
 	DrawingItem::readXmlAttributes(xmlReader, items);
 
-	if (attributes.hasAttribute("fontFamily"))
-		setFontFamily(attributes.value("fontFamily").toString());
-	if (attributes.hasAttribute("fontSize"))
-		setFontSize(attributes.value("fontSize").toString().toDouble());
-	if (attributes.hasAttribute("fontBold"))
-		setFontBold(attributes.value("fontBold").toString().toLower() == "true");
-	if (attributes.hasAttribute("fontItalic"))
-		setFontItalic(attributes.value("fontItalic").toString().toLower() == "true");
-	if (attributes.hasAttribute("fontUnderline"))
-		setFontUnderline(attributes.value("fontUnderline").toString().toLower() == "true");
-	if (attributes.hasAttribute("fontOverline"))
-		setFontOverline(attributes.value("fontOverline").toString().toLower() == "true");
-	if (attributes.hasAttribute("fontStrikeOut"))
-		setFontStrikeOut(attributes.value("fontStrikeOut").toString().toLower() == "true");
-
 	if (attributes.hasAttribute("textAlignment"))
 		setAlignment((Qt::Alignment)attributes.value("textAlignment").toString().toUInt());
 
-	if (attributes.hasAttribute("textColor"))
-		setColor(Drawing::colorFromString(attributes.value("textColor").toString()));
-
 	if (attributes.hasAttribute("caption"))
 		setCaption(attributes.value("caption").toString());
 }
@@ -381,10 +355,17 @@ void DrawingTextItem::updateLabel(const QFont& font, QPaintDevice* device)
 	else mTextRect.translate(0.0, -mTextRect.height() / 2);
 
 	// Update mBoundingRect
-	mBoundingRect = Drawing::rotateRect(QRectF(
+	QRectF labelRect = Drawing::rotateRect(QRectF(
 		QPointF(mTextRect.left() * scaleFactor, mTextRect.top() * scaleFactor),
 		QPointF(mTextRect.right() * scaleFactor, mTextRect.bottom() * scaleFactor)),
 		rotationAngle());
+
+	// Only report a geometry change if the label's size actually changed
+	if (labelRect != mBoundingRect)
+	{
+		mBoundingRect = labelRect;
+		invalidateGeometry();
+	}
 }
 
 qreal DrawingTextItem::orientedTextAngle() const
@@ -26,15 +26,15 @@ DrawingTwoPointItem::DrawingTwoPointItem() : DrawingItem()
 	QVariant variant;
 	variant.setValue(DrawingArrow());
 
-	addProperty("Pen Color", QColor(255, 0, 255));
-	addProperty("Pen Width", 12.0);
-	addProperty("Pen Style", (unsigned int)Qt::SolidLine);
-	addProperty("Pen Cap Style", (unsigned int)Qt::RoundCap);
-	addProperty("Pen Join Style", (unsigned int)Qt::RoundJoin);
-	addProperty("Start Arrow Style", DrawingArrow::None);
-	addProperty("Start Arrow Size", 100.0);
-	addProperty("End Arrow Style", DrawingArrow::None);
-	addProperty("End Arrow Size", 100.0);
+	addProperty(PenColorProperty, QColor(255, 0, 255));
+	addProperty(PenWidthProperty, 12.0);
+	addProperty(PenStyleProperty, (unsigned int)Qt::SolidLine);
+	addProperty(PenCapStyleProperty, (unsigned int)Qt::RoundCap);
+	addProperty(PenJoinStyleProperty, (unsigned int)Qt::RoundJoin);
+	addProperty(StartArrowStyleProperty, DrawingArrow::None);
+	addProperty(StartArrowSizeProperty, 100.0);
+	addProperty(EndArrowStyleProperty, DrawingArrow::None);
+	addProperty(EndArrowSizeProperty, 100.0);
 
 	setFlags(CanMove | CanRotate | CanFlip | CanResize | MatchUnitsWithParent);
 	setPlaceType(PlaceMouseDownAndUp);
@@ -104,27 +104,27 @@ void DrawingTwoPointItem::setPen(const QPen& pen)
 
 void DrawingTwoPointItem::setPenColor(const QColor& color)
 {
-	setPropertyValue("Pen Color", color);
+	setPropertyValue(PenColorProperty, color);
 }
 
 void DrawingTwoPointItem::setPenWidth(qreal width)
 {
-	setPropertyValue("Pen Width", width);
+	setPropertyValue(PenWidthProperty, width);
 }
 
 void DrawingTwoPointItem::setPenStyle(Qt::PenStyle style)
 {
-	setPropertyValue("Pen Style", (unsigned int)style);
+	setPropertyValue(PenStyleProperty, (unsigned int)style);
 }
 
 void DrawingTwoPointItem::setPenCapStyle(Qt::PenCapStyle style)
 {
-	setPropertyValue("Pen Cap Style", (unsigned int)style);
+	setPropertyValue(PenCapStyleProperty, (unsigned int)style);
 }
 
 void DrawingTwoPointItem::setPenJoinStyle(Qt::PenJoinStyle style)
 {
-	setPropertyValue("Pen Join Style", (unsigned int)style);
+	setPropertyValue(PenJoinStyleProperty, (unsigned int)style);
 }
 
 QPen DrawingTwoPointItem::pen() const
@@ -134,27 +134,27 @@ QPen DrawingTwoPointItem::pen() const
 
 QColor DrawingTwoPointItem::penColor() const
 {
-	return propertyValue("Pen Color").value<QColor>();
+	return propertyValue(PenColorProperty).value<QColor>();
 }
 
 qreal DrawingTwoPointItem::penWidth() const
 {
-	return propertyValue("Pen Width").toDouble();
+	return propertyValue(PenWidthProperty).toDouble();
 }
 
 Qt::PenStyle DrawingTwoPointItem::penStyle() const
 {
-	return (Qt::PenStyle)propertyValue("Pen Style").toUInt();
+	return (Qt::PenStyle)propertyValue(PenStyleProperty).toUInt();
 }
 
 Qt::PenCapStyle DrawingTwoPointItem::penCapStyle() const
 {
-	return (Qt::PenCapStyle)propertyValue("Pen Cap Style").toUInt();
+	return (Qt::PenCapStyle)propertyValue(PenCapStyleProperty).toUInt();
 }
 
 Qt::PenJoinStyle DrawingTwoPointItem::penJoinStyle() const
 {
-	return (Qt::PenJoinStyle)propertyValue("Pen Join Style").toUInt();
+	return (Qt::PenJoinStyle)propertyValue(PenJoinStyleProperty).toUInt();
 }
 
 //==================================================================================================
@@ -167,12 +167,12 @@ void DrawingTwoPointItem::setStartArrow(const DrawingArrow& arrow)
 
 void DrawingTwoPointItem::setStartArrowStyle(DrawingArrow::Style style)
 {
-	setPropertyValue("Start Arrow Style", (unsigned int)style);
+	setPropertyValue(StartArrowStyleProperty, (unsigned int)style);
 }
 
 void DrawingTwoPointItem::setStartArrowSize(qreal size)
 {
-	setPropertyValue("Start Arrow Size", size);
+	setPropertyValue(StartArrowSizeProperty, size);
 }
 
 DrawingArrow DrawingTwoPointItem::startArrow() const
@@ -182,12 +182,12 @@ DrawingArrow DrawingTwoPointItem::startArrow() const
 
 DrawingArrow::Style DrawingTwoPointItem::startArrowStyle() const
 {
-	return (DrawingArrow::Style)propertyValue("Start Arrow Style").toUInt();
+	return (DrawingArrow::Style)propertyValue(StartArrowStyleProperty).toUInt();
 }
 
 qreal DrawingTwoPointItem::startArrowSize() const
 {
-	return propertyValue("Start Arrow Size").toDouble();
+	return propertyValue(StartArrowSizeProperty).toDouble();
 }
 
 //==================================================================================================
@@ -200,12 +200,12 @@ void DrawingTwoPointItem::setEndArrow(const DrawingArrow& arrow)
 
 void DrawingTwoPointItem::setEndArrowStyle(DrawingArrow::Style style)
 {
-	setPropertyValue("End Arrow Style", (unsigned int)style);
+	setPropertyValue(EndArrowStyleProperty, (unsigned int)style);
 }
 
 void DrawingTwoPointItem::setEndArrowSize(qreal size)
 {
-	setPropertyValue("End Arrow Size", size);
+	setPropertyValue(EndArrowSizeProperty, size);
 }
 
 DrawingArrow DrawingTwoPointItem::endArrow() const
@@ -215,12 +215,12 @@ DrawingArrow DrawingTwoPointItem::endArrow() const
 
 DrawingArrow::Style DrawingTwoPointItem::endArrowStyle() const
 {
-	return (DrawingArrow::Style)propertyValue("End Arrow Style").toUInt();
+	return (DrawingArrow::Style)propertyValue(EndArrowStyleProperty).toUInt();
 }
 
 qreal DrawingTwoPointItem::endArrowSize() const
 {
-	return propertyValue("End Arrow Size").toDouble();
+	return propertyValue(EndArrowSizeProperty).toDouble();
 }
 
 //==================================================================================================
@@ -274,12 +274,6 @@ void DrawingTwoPointItem::writeXmlAttributes(QXmlStreamWriter& xmlWriter, const
 {
 	DrawingItem::writeXmlAttributes(xmlWriter, items);
 
-	xmlWriter.writeAttribute("penColor", Drawing::colorToString(penColor()));
-	xmlWriter.writeAttribute("penWidth", QString::number(penWidth()));
-	xmlWriter.writeAttribute("penStyle", QString::number((unsigned int)penStyle()));
-	xmlWriter.writeAttribute("penCapStyle", QString::number((unsigned int)penCapStyle()));
-	xmlWriter.writeAttribute("penJoinStyle", QString::number((unsigned int)penJoinStyle()));
-
 	xmlWriter.writeAttribute("startArrowStyle", QString::number((unsigned int)startArrowStyle()));
 	xmlWriter.writeAttribute("startArrowSize", QString::number(startArrowSize()));
 	xmlWriter.writeAttribute("endArrowStyle", QString::number((unsigned int)endArrowStyle()));
@@ -292,17 +286,6 @@ void DrawingTwoPointItem::readXmlAttributes(QXmlStreamReader& xmlReader, const Q
 
 	DrawingItem::readXmlAttributes(xmlReader, items);
 
-	if (attributes.hasAttribute("penColor"))
-		setPenColor(Drawing::colorFromString(attributes.value("penColor").toString()));
-	if (attributes.hasAttribute("penWidth"))
-		setPenWidth(attributes.value("penWidth").toString().toDouble());
-	if (attributes.hasAttribute("penStyle"))
-		setPenStyle((Qt::PenStyle)attributes.value("penStyle").toString().toUInt());
-	if (attributes.hasAttribute("penCapStyle"))
-		setPenCapStyle((Qt::PenCapStyle)attributes.value("penCapStyle").toString().toUInt());
-	if (attributes.hasAttribute("penJoinStyle"))
-		setPenJoinStyle((Qt::PenJoinStyle)attributes.value("penJoinStyle").toString().toUInt());
-
 	if (attributes.hasAttribute("startArrowStyle"))
 		setStartArrowStyle((DrawingArrow::Style)attributes.value("startArrowStyle").toString().toUInt());
 	if (attributes.hasAttribute("startArrowSize"))
@@ -357,6 +340,20 @@ QPainterPath DrawingLineItem::shape() const
 	return itemShapeFromPath(path, pen());
 }
 
+bool DrawingLineItem::shapeContains(const QPointF& itemPos) const
+{
+	return (Drawing::distanceFromPointToLineSegment(itemPos, QLineF(startPoint()->pos(), endPoint()->pos()))
+		<= itemOutlineWidth(pen()) / 2);
+}
+
+bool DrawingLineItem::shapeIntersects(const QRectF& itemRect) const
+{
+	qreal halfWidth = itemOutlineWidth(pen()) / 2;
+
+	return Drawing::lineSegmentIntersectsRect(QLineF(startPoint()->pos(), endPoint()->pos()),
+		itemRect.normalized().adjusted(-halfWidth, -halfWidth, halfWidth, halfWidth));
+}
+
 //==================================================================================================
 
 void DrawingLineItem::render(QPainter* painter, const DrawingStyleOptions& styleOptions)
@@ -444,6 +441,32 @@ QPainterPath DrawingArcItem::shape() const
 	return itemShapeFromPath(path, pen());
 }
 
+bool DrawingArcItem::shapeContains(const QPointF& itemPos) const
+{
+	QPolygonF polyline = arcPolyline();
+	qreal halfWidth = itemOutlineWidth(pen()) / 2;
+	bool contains = false;
+
+	for(int i = 1; !contains && i < polyline.size(); i++)
+		contains = (Drawing::distanceFromPointToLineSegment(itemPos, QLineF(polyline[i-1], polyline[i])) <= halfWidth);
+
+	return contains;
+}
+
+bool DrawingArcItem::shapeIntersects(const QRectF& itemRect) const
+{
+	QPolygonF polyline = arcPolyline();
+	qreal halfWidth = itemOutlineWidth(pen()) / 2;
+	bool intersects = false;
+
+	QRectF rect = itemRect.normalized().adjusted(-halfWidth, -halfWidth, halfWidth, halfWidth);
+
+	for(int i = 1; !intersects && i < polyline.size(); i++)
+		intersects = Drawing::lineSegmentIntersectsRect(QLineF(polyline[i-1], polyline[i]), rect);
+
+	return intersects;
+}
+
 //==================================================================================================
 
 void DrawingArcItem::render(QPainter* painter, const DrawingStyleOptions& styleOptions)
@@ -556,6 +579,32 @@ qreal DrawingArcItem::orientedSpanAngle() const
 	return angle;
 }
 
+QPolygonF DrawingArcItem::arcPolyline() const
+{
+	// A polyline approximation of the arc, used for hit testing; 18 segments keeps the error well
+	// below the outline width for any reasonably sized arc
+	const int segmentCount = 18;
+
+	qreal arcRadiusX = orientedRadiusX();
+	qreal arcRadiusY = orientedRadiusY();
+	qreal arcCenterX = orientedCenterX();
+	qreal arcCenterY = orientedCenterY();
+	qreal arcStartAngle = qDegreesToRadians(orientedStartAngle());
+	qreal arcSpanAngle = qDegreesToRadians(orientedSpanAngle());
+	qreal angle;
+
+	QPolygonF polyline;
+	polyline.reserve(segmentCount + 1);
+
+	for(int i = 0; i <= segmentCount; i++)
+	{
+		angle = arcStartAngle + arcSpanAngle * i / segmentCount;
+		polyline.append(QPointF(arcCenterX + arcRadiusX * qCos(angle), arcCenterY - arcRadiusY * qSin(angle)));
+	}
+
+	return polyline;
+}
+
 //==================================================================================================
 //==================================================================================================
 //==================================================================================================
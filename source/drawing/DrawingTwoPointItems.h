@@ -92,6 +92,8 @@ public:
 
 	virtual QRectF boundingRect() const;
 	virtual QPainterPath shape() const;
+	virtual bool shapeContains(const QPointF& itemPos) const;
+	virtual bool shapeIntersects(const QRectF& itemRect) const;
 
 	virtual void render(QPainter* painter, const DrawingStyleOptions& styleOptions);
 
@@ -112,6 +114,8 @@ public:
 
 	virtual QRectF boundingRect() const;
 	virtual QPainterPath shape() const;
+	virtual bool shapeContains(const QPointF& itemPos) const;
+	virtual bool shapeIntersects(const QRectF& itemRect) const;
 
 	virtual void render(QPainter* painter, const DrawingStyleOptions& styleOptions);
 
@@ -122,6 +126,9 @@ protected:
 	qreal orientedRadiusY() const;
 	qreal orientedStartAngle() const;
 	qreal orientedSpanAngle() const;
+
+private:
+	QPolygonF arcPolyline() const;
 };
 
 //==================================================================================================
@@ -22,6 +22,7 @@
 #include <DrawingScene.h>
 #include <DrawingItem.h>
 #include <DrawingItemPoint.h>
+#include <DrawingJournal.h>
 
 DrawingUndoCommand::DrawingUndoCommand(const QString& title, QUndoCommand* parent) :
 	QUndoCommand(title, parent) { }
@@ -55,6 +56,21 @@ DrawingUndoCommand::DrawingUndoCommand(const DrawingUndoCommand& command, QUndoC
 
 DrawingUndoCommand::~DrawingUndoCommand() { }
 
+qint64 DrawingUndoCommand::memorySize() const
+{
+	return sizeof(DrawingUndoCommand);
+}
+
+void DrawingUndoCommand::writeJournalData(QDataStream& stream, bool undone) const
+{
+	// Commands are written just after they have been applied in the direction given by undone,
+	// and are read back by DrawingScene::readUndoCommand to be applied the same way to the state
+	// before that.  Items and points are written by id, except for those that the command is
+	// bringing into the scene.
+	Q_UNUSED(stream);
+	Q_UNUSED(undone);
+}
+
 void DrawingUndoCommand::mergeChildren(const QUndoCommand* command)
 {
 	bool mergeSuccess;
@@ -91,6 +107,32 @@ void DrawingUndoCommand::mergeChildren(const QUndoCommand* command)
 	}
 }
 
+qint64 DrawingUndoCommand::itemsMemorySize(const QList<DrawingItem*>& items)
+{
+	// A rough estimate: a fixed cost for the item object itself plus its points, properties, and
+	// children
+	qint64 size = 0;
+
+	for(auto itemIter = items.begin(); itemIter != items.end(); itemIter++)
+	{
+		size += 256 + (*itemIter)->numberOfPoints() * (sizeof(DrawingItemPoint) + sizeof(DrawingItemPoint*));
+		size += (*itemIter)->numberOfProperties() * (sizeof(int) + sizeof(QVariant) + 16);
+		size += itemsMemorySize((*itemIter)->children());
+	}
+
+	return size;
+}
+
+qint64 DrawingUndoCommand::propertiesMemorySize(const QHash<QString,QVariant>& properties)
+{
+	qint64 size = 0;
+
+	for(auto propertyIter = properties.begin(); propertyIter != properties.end(); propertyIter++)
+		size += sizeof(QString) + sizeof(QVariant) + propertyIter.key().size() * sizeof(QChar) + 16;
+
+	return size;
+}
+
 //==================================================================================================
 
 DrawingAddItemsCommand::DrawingAddItemsCommand(DrawingScene* scene, DrawingItem* item,
@@ -122,6 +164,31 @@ int DrawingAddItemsCommand::id() const
 	return AddItemsType;
 }
 
+qint64 DrawingAddItemsCommand::memorySize() const
+{
+	// The items belong to the command only while it is undone
+	qint64 size = sizeof(DrawingAddItemsCommand) + mItems.size() * sizeof(DrawingItem*);
+	if (mUndone) size += itemsMemorySize(mItems);
+	return size;
+}
+
+void DrawingAddItemsCommand::writeJournalData(QDataStream& stream, bool undone) const
+{
+	if (undone) DrawingJournal::writeItemReferences(stream, mItems);
+	else DrawingJournal::writeItems(stream, mItems);
+}
+
+DrawingAddItemsCommand* DrawingAddItemsCommand::readJournalData(QDataStream& stream, bool undone,
+	DrawingJournal& journal, QUndoCommand* parent)
+{
+	QList<DrawingItem*> items = (undone) ? journal.readItemReferences(stream) : journal.readItems(stream);
+	DrawingAddItemsCommand* command = new DrawingAddItemsCommand(journal.scene(), items, parent);
+
+	// The command starts out in the state it is about to be applied from
+	command->mUndone = !undone;
+	return command;
+}
+
 void DrawingAddItemsCommand::redo()
 {
 	mUndone = false;
@@ -169,6 +236,48 @@ int DrawingRemoveItemsCommand::id() const
 	return RemoveItemsType;
 }
 
+qint64 DrawingRemoveItemsCommand::memorySize() const
+{
+	// The items belong to the command only while it is not undone
+	qint64 size = sizeof(DrawingRemoveItemsCommand) +
+		mItems.size() * sizeof(DrawingItem*) + mItemIndex.size() * (sizeof(DrawingItem*) + sizeof(int));
+	if (!mUndone) size += itemsMemorySize(mItems);
+	return size;
+}
+
+void DrawingRemoveItemsCommand::writeJournalData(QDataStream& stream, bool undone) const
+{
+	if (undone)
+	{
+		DrawingJournal::writeItems(stream, mItems);
+		for(auto itemIter = mItems.begin(); itemIter != mItems.end(); itemIter++)
+			stream << (qint32)mItemIndex.value(*itemIter);
+	}
+	else DrawingJournal::writeItemReferences(stream, mItems);
+}
+
+DrawingRemoveItemsCommand* DrawingRemoveItemsCommand::readJournalData(QDataStream& stream, bool undone,
+	DrawingJournal& journal, QUndoCommand* parent)
+{
+	QList<DrawingItem*> items = (undone) ? journal.readItems(stream) : journal.readItemReferences(stream);
+	DrawingRemoveItemsCommand* command = new DrawingRemoveItemsCommand(journal.scene(), items, parent);
+	qint32 index;
+
+	if (undone)
+	{
+		for(auto itemIter = items.begin(); itemIter != items.end(); itemIter++)
+		{
+			index = 0;
+			stream >> index;
+			command->mItemIndex.insert(*itemIter, index);
+		}
+	}
+
+	// The command starts out in the state it is about to be applied from
+	command->mUndone = !undone;
+	return command;
+}
+
 void DrawingRemoveItemsCommand::redo()
 {
 	mUndone = false;
@@ -217,6 +326,11 @@ int DrawingMoveItemsDeltaCommand::id() const
 	return MoveItemsDeltaType;
 }
 
+qint64 DrawingMoveItemsDeltaCommand::memorySize() const
+{
+	return sizeof(DrawingMoveItemsDeltaCommand) + mItems.size() * sizeof(DrawingItem*);
+}
+
 bool DrawingMoveItemsDeltaCommand::mergeWith(const QUndoCommand* command)
 {
 	bool mergeSuccess = false;
@@ -238,6 +352,28 @@ bool DrawingMoveItemsDeltaCommand::mergeWith(const QUndoCommand* command)
 	return mergeSuccess;
 }
 
+void DrawingMoveItemsDeltaCommand::writeJournalData(QDataStream& stream, bool undone) const
+{
+	Q_UNUSED(undone);
+
+	DrawingJournal::writeItemReferences(stream, mItems);
+	stream << mDeltaPosition << mFinalMove;
+}
+
+DrawingMoveItemsDeltaCommand* DrawingMoveItemsDeltaCommand::readJournalData(QDataStream& stream, bool undone,
+	DrawingJournal& journal, QUndoCommand* parent)
+{
+	QList<DrawingItem*> items = journal.readItemReferences(stream);
+	QPointF deltaPosition;
+	bool final = true;
+
+	Q_UNUSED(undone);
+
+	stream >> deltaPosition >> final;
+
+	return new DrawingMoveItemsDeltaCommand(items, deltaPosition, final, parent);
+}
+
 void DrawingMoveItemsDeltaCommand::redo()
 {
 	for(auto itemIter = mItems.begin(); itemIter != mItems.end(); itemIter++)
@@ -281,6 +417,11 @@ int DrawingResizeItemCommand::id() const
 	return ItemResizeType;
 }
 
+qint64 DrawingResizeItemCommand::memorySize() const
+{
+	return sizeof(DrawingResizeItemCommand);
+}
+
 bool DrawingResizeItemCommand::mergeWith(const QUndoCommand* command)
 {
 	bool mergeSuccess = false;
@@ -302,6 +443,35 @@ bool DrawingResizeItemCommand::mergeWith(const QUndoCommand* command)
 	return mergeSuccess;
 }
 
+void DrawingResizeItemCommand::writeJournalData(QDataStream& stream, bool undone) const
+{
+	Q_UNUSED(undone);
+
+	DrawingJournal::writePointReference(stream, mPoint);
+	stream << mScenePos << mOriginalScenePos << mFinalMove;
+}
+
+DrawingResizeItemCommand* DrawingResizeItemCommand::readJournalData(QDataStream& stream, bool undone,
+	DrawingJournal& journal, QUndoCommand* parent)
+{
+	DrawingResizeItemCommand* command = nullptr;
+	DrawingItemPoint* point = journal.readPointReference(stream);
+	QPointF scenePos, originalScenePos;
+	bool final = true;
+
+	Q_UNUSED(undone);
+
+	stream >> scenePos >> originalScenePos >> final;
+
+	if (point)
+	{
+		command = new DrawingResizeItemCommand(point, scenePos, final, parent);
+		command->mOriginalScenePos = originalScenePos;
+	}
+
+	return command;
+}
+
 void DrawingResizeItemCommand::redo()
 {
 	if (mPoint && mPoint->item())
@@ -351,6 +521,30 @@ int DrawingItemPointConnectCommand::id() const
 	return PointConnectType;
 }
 
+qint64 DrawingItemPointConnectCommand::memorySize() const
+{
+	return sizeof(DrawingItemPointConnectCommand);
+}
+
+void DrawingItemPointConnectCommand::writeJournalData(QDataStream& stream, bool undone) const
+{
+	Q_UNUSED(undone);
+
+	DrawingJournal::writePointReference(stream, mPoint1);
+	DrawingJournal::writePointReference(stream, mPoint2);
+}
+
+DrawingItemPointConnectCommand* DrawingItemPointConnectCommand::readJournalData(QDataStream& stream, bool undone,
+	DrawingJournal& journal, QUndoCommand* parent)
+{
+	DrawingItemPoint* point1 = journal.readPointReference(stream);
+	DrawingItemPoint* point2 = journal.readPointReference(stream);
+
+	Q_UNUSED(undone);
+
+	return (point1 && point2) ? new DrawingItemPointConnectCommand(point1, point2, parent) : nullptr;
+}
+
 void DrawingItemPointConnectCommand::redo()
 {
 	mPoint1->addTarget(mPoint2);
@@ -392,6 +586,30 @@ int DrawingItemPointDisconnectCommand::id() const
 	return PointDisconnectType;
 }
 
+qint64 DrawingItemPointDisconnectCommand::memorySize() const
+{
+	return sizeof(DrawingItemPointDisconnectCommand);
+}
+
+void DrawingItemPointDisconnectCommand::writeJournalData(QDataStream& stream, bool undone) const
+{
+	Q_UNUSED(undone);
+
+	DrawingJournal::writePointReference(stream, mPoint1);
+	DrawingJournal::writePointReference(stream, mPoint2);
+}
+
+DrawingItemPointDisconnectCommand* DrawingItemPointDisconnectCommand::readJournalData(QDataStream& stream, bool undone,
+	DrawingJournal& journal, QUndoCommand* parent)
+{
+	DrawingItemPoint* point1 = journal.readPointReference(stream);
+	DrawingItemPoint* point2 = journal.readPointReference(stream);
+
+	Q_UNUSED(undone);
+
+	return (point1 && point2) ? new DrawingItemPointDisconnectCommand(point1, point2, parent) : nullptr;
+}
+
 void DrawingItemPointDisconnectCommand::redo()
 {
 	mPoint1->removeTarget(mPoint2);
@@ -429,6 +647,32 @@ int DrawingRotateItemsCommand::id() const
 	return RotateItemsType;
 }
 
+qint64 DrawingRotateItemsCommand::memorySize() const
+{
+	return sizeof(DrawingRotateItemsCommand) + mItems.size() * sizeof(DrawingItem*);
+}
+
+void DrawingRotateItemsCommand::writeJournalData(QDataStream& stream, bool undone) const
+{
+	Q_UNUSED(undone);
+
+	DrawingJournal::writeItemReferences(stream, mItems);
+	stream << mScenePos;
+}
+
+DrawingRotateItemsCommand* DrawingRotateItemsCommand::readJournalData(QDataStream& stream, bool undone,
+	DrawingJournal& journal, QUndoCommand* parent)
+{
+	QList<DrawingItem*> items = journal.readItemReferences(stream);
+	QPointF scenePos;
+
+	Q_UNUSED(undone);
+
+	stream >> scenePos;
+
+	return new DrawingRotateItemsCommand(items, scenePos, parent);
+}
+
 void DrawingRotateItemsCommand::redo()
 {
 	for(auto itemIter = mItems.begin(); itemIter != mItems.end(); itemIter++)
@@ -466,6 +710,32 @@ int DrawingRotateBackItemsCommand::id() const
 	return RotateBackItemsType;
 }
 
+qint64 DrawingRotateBackItemsCommand::memorySize() const
+{
+	return sizeof(DrawingRotateBackItemsCommand) + mItems.size() * sizeof(DrawingItem*);
+}
+
+void DrawingRotateBackItemsCommand::writeJournalData(QDataStream& stream, bool undone) const
+{
+	Q_UNUSED(undone);
+
+	DrawingJournal::writeItemReferences(stream, mItems);
+	stream << mScenePos;
+}
+
+DrawingRotateBackItemsCommand* DrawingRotateBackItemsCommand::readJournalData(QDataStream& stream, bool undone,
+	DrawingJournal& journal, QUndoCommand* parent)
+{
+	QList<DrawingItem*> items = journal.readItemReferences(stream);
+	QPointF scenePos;
+
+	Q_UNUSED(undone);
+
+	stream >> scenePos;
+
+	return new DrawingRotateBackItemsCommand(items, scenePos, parent);
+}
+
 void DrawingRotateBackItemsCommand::redo()
 {
 	for(auto itemIter = mItems.begin(); itemIter != mItems.end(); itemIter++)
@@ -503,6 +773,32 @@ int DrawingFlipItemsCommand::id() const
 	return FlipItemsType;
 }
 
+qint64 DrawingFlipItemsCommand::memorySize() const
+{
+	return sizeof(DrawingFlipItemsCommand) + mItems.size() * sizeof(DrawingItem*);
+}
+
+void DrawingFlipItemsCommand::writeJournalData(QDataStream& stream, bool undone) const
+{
+	Q_UNUSED(undone);
+
+	DrawingJournal::writeItemReferences(stream, mItems);
+	stream << mScenePos;
+}
+
+DrawingFlipItemsCommand* DrawingFlipItemsCommand::readJournalData(QDataStream& stream, bool undone,
+	DrawingJournal& journal, QUndoCommand* parent)
+{
+	QList<DrawingItem*> items = journal.readItemReferences(stream);
+	QPointF scenePos;
+
+	Q_UNUSED(undone);
+
+	stream >> scenePos;
+
+	return new DrawingFlipItemsCommand(items, scenePos, parent);
+}
+
 void DrawingFlipItemsCommand::redo()
 {
 	for(auto itemIter = mItems.begin(); itemIter != mItems.end(); itemIter++)
@@ -519,12 +815,14 @@ void DrawingFlipItemsCommand::undo()
 
 //==================================================================================================
 
-DrawingReorderItemsCommand::DrawingReorderItemsCommand(DrawingScene* scene,
-	const QList<DrawingItem*>& newItemOrder, QUndoCommand* parent) : DrawingUndoCommand("Reorder Items", parent)
+DrawingReorderItemsCommand::DrawingReorderItemsCommand(DrawingScene* scene, const QList<DrawingItem*>& items,
+	const QList<int>& originalIndices, const QList<int>& newIndices, QUndoCommand* parent) :
+	DrawingUndoCommand("Reorder Items", parent)
 {
 	mScene = scene;
-	mNewItemOrder = newItemOrder;
-	mOriginalItemOrder = mScene->items();
+	mItems = items;
+	mOriginalIndices = originalIndices;
+	mNewIndices = newIndices;
 }
 
 DrawingReorderItemsCommand::~DrawingReorderItemsCommand() { }
@@ -534,16 +832,56 @@ int DrawingReorderItemsCommand::id() const
 	return ReorderItemsType;
 }
 
+qint64 DrawingReorderItemsCommand::memorySize() const
+{
+	return sizeof(DrawingReorderItemsCommand) + mItems.size() * (sizeof(DrawingItem*) + 2 * sizeof(int));
+}
+
+void DrawingReorderItemsCommand::writeJournalData(QDataStream& stream, bool undone) const
+{
+	Q_UNUSED(undone);
+
+	DrawingJournal::writeItemReferences(stream, mItems);
+	stream << mOriginalIndices << mNewIndices;
+}
+
+DrawingReorderItemsCommand* DrawingReorderItemsCommand::readJournalData(QDataStream& stream, bool undone,
+	DrawingJournal& journal, QUndoCommand* parent)
+{
+	QList<DrawingItem*> items = journal.readItemReferences(stream);
+	QList<int> originalIndices, newIndices;
+
+	Q_UNUSED(undone);
+
+	stream >> originalIndices >> newIndices;
+
+	// Each index must have an item to go with it
+	if (originalIndices.size() != items.size() || newIndices.size() != items.size())
+	{
+		stream.setStatus(QDataStream::ReadCorruptData);
+		originalIndices.clear();
+		newIndices.clear();
+		items.clear();
+	}
+
+	return new DrawingReorderItemsCommand(journal.scene(), items, originalIndices, newIndices, parent);
+}
+
 void DrawingReorderItemsCommand::redo()
 {
-	mScene->reorderItems(mNewItemOrder);
+	// Each move depends on the ones before it, so they are replayed in order and undone in reverse
+	for(int i = 0; i < mItems.size(); i++)
+		mScene->reorderItem(mItems[i], mNewIndices[i]);
+
 	DrawingUndoCommand::redo();
 }
 
 void DrawingReorderItemsCommand::undo()
 {
 	DrawingUndoCommand::undo();
-	mScene->reorderItems(mOriginalItemOrder);
+
+	for(int i = mItems.size() - 1; i >= 0; i--)
+		mScene->reorderItem(mItems[i], mOriginalIndices[i]);
 }
 
 //==================================================================================================
@@ -567,6 +905,54 @@ int DrawingItemInsertPointCommand::id() const
 	return InsertItemPointType;
 }
 
+qint64 DrawingItemInsertPointCommand::memorySize() const
+{
+	qint64 size = sizeof(DrawingItemInsertPointCommand);
+	if (mUndone) size += sizeof(DrawingItemPoint);
+	return size;
+}
+
+void DrawingItemInsertPointCommand::writeJournalData(QDataStream& stream, bool undone) const
+{
+	DrawingJournal::writeItemReference(stream, mItem);
+	stream << (qint32)mPointIndex;
+	if (!undone) DrawingJournal::writePoint(stream, mPoint);
+}
+
+DrawingItemInsertPointCommand* DrawingItemInsertPointCommand::readJournalData(QDataStream& stream, bool undone,
+	DrawingJournal& journal, QUndoCommand* parent)
+{
+	DrawingItemInsertPointCommand* command = nullptr;
+	DrawingItem* item = journal.readItemReference(stream);
+	DrawingItemPoint* point = nullptr;
+	qint32 pointIndex = -1;
+
+	stream >> pointIndex;
+
+	if (!undone)
+	{
+		// The point is about to be inserted, so it may also go at the end of the item's points
+		point = journal.readPoint(stream);
+		if (item && (pointIndex < 0 || pointIndex > item->numberOfPoints())) item = nullptr;
+	}
+	else if (item && pointIndex >= 0 && pointIndex < item->numberOfPoints()) point = item->point(pointIndex);
+
+	if (item && point)
+	{
+		command = new DrawingItemInsertPointCommand(item, point, pointIndex, parent);
+
+		// The command starts out in the state it is about to be applied from
+		command->mUndone = !undone;
+	}
+	else
+	{
+		if (!undone) delete point;
+		stream.setStatus(QDataStream::ReadCorruptData);
+	}
+
+	return command;
+}
+
 void DrawingItemInsertPointCommand::redo()
 {
 	mItem->insertItemPoint(mPointIndex, mPoint);
@@ -605,6 +991,55 @@ int DrawingItemRemovePointCommand::id() const
 	return RemoveItemPointType;
 }
 
+qint64 DrawingItemRemovePointCommand::memorySize() const
+{
+	qint64 size = sizeof(DrawingItemRemovePointCommand);
+	if (!mUndone) size += sizeof(DrawingItemPoint);
+	return size;
+}
+
+void DrawingItemRemovePointCommand::writeJournalData(QDataStream& stream, bool undone) const
+{
+	DrawingJournal::writeItemReference(stream, mItem);
+	stream << (qint32)mPointIndex;
+	if (undone) DrawingJournal::writePoint(stream, mPoint);
+}
+
+DrawingItemRemovePointCommand* DrawingItemRemovePointCommand::readJournalData(QDataStream& stream, bool undone,
+	DrawingJournal& journal, QUndoCommand* parent)
+{
+	DrawingItemRemovePointCommand* command = nullptr;
+	DrawingItem* item = journal.readItemReference(stream);
+	DrawingItemPoint* point = nullptr;
+	qint32 pointIndex = -1;
+
+	stream >> pointIndex;
+
+	if (undone)
+	{
+		// The point is about to be inserted back, so it may also go at the end of the item's points
+		point = journal.readPoint(stream);
+		if (item && (pointIndex < 0 || pointIndex > item->numberOfPoints())) item = nullptr;
+	}
+	else if (item && pointIndex >= 0 && pointIndex < item->numberOfPoints()) point = item->point(pointIndex);
+
+	if (item && point)
+	{
+		command = new DrawingItemRemovePointCommand(item, point, parent);
+		command->mPointIndex = pointIndex;
+
+		// The command starts out in the state it is about to be applied from
+		command->mUndone = !undone;
+	}
+	else
+	{
+		if (undone) delete point;
+		stream.setStatus(QDataStream::ReadCorruptData);
+	}
+
+	return command;
+}
+
 void DrawingItemRemovePointCommand::redo()
 {
 	mPointIndex = mItem->points().indexOf(mPoint);
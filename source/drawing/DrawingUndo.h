@@ -36,8 +36,14 @@ public:
 	DrawingUndoCommand(const DrawingUndoCommand& command, QUndoCommand* parent = nullptr);
 	virtual ~DrawingUndoCommand();
 
+	virtual qint64 memorySize() const;
+	virtual void writeJournalData(QDataStream& stream, bool undone) const;
+
 protected:
 	virtual void mergeChildren(const QUndoCommand* command);
+
+	static qint64 itemsMemorySize(const QList<DrawingItem*>& items);
+	static qint64 propertiesMemorySize(const QHash<QString,QVariant>& properties);
 };
 
 
@@ -56,6 +62,11 @@ public:
 	~DrawingAddItemsCommand();
 
 	int id() const;
+	qint64 memorySize() const;
+
+	void writeJournalData(QDataStream& stream, bool undone) const;
+	static DrawingAddItemsCommand* readJournalData(QDataStream& stream, bool undone,
+		DrawingJournal& journal, QUndoCommand* parent = nullptr);
 
 	void redo();
 	void undo();
@@ -77,6 +88,11 @@ public:
 	~DrawingRemoveItemsCommand();
 
 	int id() const;
+	qint64 memorySize() const;
+
+	void writeJournalData(QDataStream& stream, bool undone) const;
+	static DrawingRemoveItemsCommand* readJournalData(QDataStream& stream, bool undone,
+		DrawingJournal& journal, QUndoCommand* parent = nullptr);
 
 	void redo();
 	void undo();
@@ -97,8 +113,13 @@ public:
 	~DrawingMoveItemsDeltaCommand();
 
 	int id() const;
+	qint64 memorySize() const;
 	bool mergeWith(const QUndoCommand* command);
 
+	void writeJournalData(QDataStream& stream, bool undone) const;
+	static DrawingMoveItemsDeltaCommand* readJournalData(QDataStream& stream, bool undone,
+		DrawingJournal& journal, QUndoCommand* parent = nullptr);
+
 	void redo();
 	void undo();
 };
@@ -119,8 +140,13 @@ public:
 	~DrawingResizeItemCommand();
 
 	int id() const;
+	qint64 memorySize() const;
 	bool mergeWith(const QUndoCommand* command);
 
+	void writeJournalData(QDataStream& stream, bool undone) const;
+	static DrawingResizeItemCommand* readJournalData(QDataStream& stream, bool undone,
+		DrawingJournal& journal, QUndoCommand* parent = nullptr);
+
 	void redo();
 	void undo();
 };
@@ -141,6 +167,11 @@ public:
 	~DrawingItemPointConnectCommand();
 
 	int id() const;
+	qint64 memorySize() const;
+
+	void writeJournalData(QDataStream& stream, bool undone) const;
+	static DrawingItemPointConnectCommand* readJournalData(QDataStream& stream, bool undone,
+		DrawingJournal& journal, QUndoCommand* parent = nullptr);
 
 	void redo();
 	void undo();
@@ -162,6 +193,11 @@ public:
 	~DrawingItemPointDisconnectCommand();
 
 	int id() const;
+	qint64 memorySize() const;
+
+	void writeJournalData(QDataStream& stream, bool undone) const;
+	static DrawingItemPointDisconnectCommand* readJournalData(QDataStream& stream, bool undone,
+		DrawingJournal& journal, QUndoCommand* parent = nullptr);
 
 	void redo();
 	void undo();
@@ -183,6 +219,11 @@ public:
 	~DrawingRotateItemsCommand();
 
 	int id() const;
+	qint64 memorySize() const;
+
+	void writeJournalData(QDataStream& stream, bool undone) const;
+	static DrawingRotateItemsCommand* readJournalData(QDataStream& stream, bool undone,
+		DrawingJournal& journal, QUndoCommand* parent = nullptr);
 
 	void redo();
 	void undo();
@@ -204,6 +245,11 @@ public:
 	~DrawingRotateBackItemsCommand();
 
 	int id() const;
+	qint64 memorySize() const;
+
+	void writeJournalData(QDataStream& stream, bool undone) const;
+	static DrawingRotateBackItemsCommand* readJournalData(QDataStream& stream, bool undone,
+		DrawingJournal& journal, QUndoCommand* parent = nullptr);
 
 	void redo();
 	void undo();
@@ -225,6 +271,11 @@ public:
 	~DrawingFlipItemsCommand();
 
 	int id() const;
+	qint64 memorySize() const;
+
+	void writeJournalData(QDataStream& stream, bool undone) const;
+	static DrawingFlipItemsCommand* readJournalData(QDataStream& stream, bool undone,
+		DrawingJournal& journal, QUndoCommand* parent = nullptr);
 
 	void redo();
 	void undo();
@@ -236,14 +287,20 @@ class DrawingReorderItemsCommand : public DrawingUndoCommand
 {
 private:
 	DrawingScene* mScene;
-	QList<DrawingItem*> mNewItemOrder, mOriginalItemOrder;
+	QList<DrawingItem*> mItems;
+	QList<int> mOriginalIndices, mNewIndices;
 
 public:
-	DrawingReorderItemsCommand(DrawingScene* scene,
-		const QList<DrawingItem*>& newItemOrder, QUndoCommand* parent = nullptr);
+	DrawingReorderItemsCommand(DrawingScene* scene, const QList<DrawingItem*>& items,
+		const QList<int>& originalIndices, const QList<int>& newIndices, QUndoCommand* parent = nullptr);
 	~DrawingReorderItemsCommand();
 
 	int id() const;
+	qint64 memorySize() const;
+
+	void writeJournalData(QDataStream& stream, bool undone) const;
+	static DrawingReorderItemsCommand* readJournalData(QDataStream& stream, bool undone,
+		DrawingJournal& journal, QUndoCommand* parent = nullptr);
 
 	void redo();
 	void undo();
@@ -265,6 +322,11 @@ public:
 	~DrawingItemInsertPointCommand();
 
 	int id() const;
+	qint64 memorySize() const;
+
+	void writeJournalData(QDataStream& stream, bool undone) const;
+	static DrawingItemInsertPointCommand* readJournalData(QDataStream& stream, bool undone,
+		DrawingJournal& journal, QUndoCommand* parent = nullptr);
 
 	void redo();
 	void undo();
@@ -286,6 +348,11 @@ public:
 	~DrawingItemRemovePointCommand();
 
 	int id() const;
+	qint64 memorySize() const;
+
+	void writeJournalData(QDataStream& stream, bool undone) const;
+	static DrawingItemRemovePointCommand* readJournalData(QDataStream& stream, bool undone,
+		DrawingJournal& journal, QUndoCommand* parent = nullptr);
 
 	void redo();
 	void undo();
@@ -0,0 +1,327 @@
+/* DrawingUndoStack.cpp
+ *
+ * Copyright (C) 2013-2014 Jason Allen
+ *
+ * This file is part of the Jade Diagram Editor.
+ *
+ * Jade is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Jade is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Jade.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <DrawingUndoStack.h>
+#include <DrawingUndo.h>
+#include <DrawingJournal.h>
+
+DrawingUndoStack::DrawingUndoStack(QObject* parent) : QObject(parent)
+{
+	mIndex = 0;
+	mCleanIndex = 0;
+	mSaveIndex = -1;
+
+	mJournal = nullptr;
+
+	mUndoLimit = 0;
+	mMemoryLimit = 0;
+	mMemoryUsage = 0;
+}
+
+DrawingUndoStack::~DrawingUndoStack()
+{
+	while (!mCommands.isEmpty()) delete mCommands.takeLast();
+}
+
+//==================================================================================================
+
+void DrawingUndoStack::push(QUndoCommand* command)
+{
+	if (command)
+	{
+		bool wasClean = isClean(), couldUndo = canUndo(), couldRedo = canRedo();
+		QUndoCommand* currentCommand = (mIndex > 0) ? mCommands[mIndex - 1] : nullptr;
+
+		command->redo();
+
+		// The command is journaled as it was pushed, whether or not it is merged below
+		if (mJournal) mJournal->writeCommand(command, false);
+
+		// Pushing a command discards everything that could have been redone
+		while (mIndex < mCommands.size())
+		{
+			delete mCommands.takeLast();
+			mMemoryUsage -= mCommandSizes.takeLast();
+		}
+		if (mCleanIndex > mIndex) mCleanIndex = -1;
+		if (mSaveIndex > mIndex) mSaveIndex = -1;
+
+		// A command that has been (or is being) saved must not change by merging
+		if (currentCommand && currentCommand->id() != -1 && currentCommand->id() == command->id() &&
+			mIndex != mCleanIndex && mIndex != mSaveIndex && currentCommand->mergeWith(command))
+		{
+			delete command;
+			updateCommandSize(mIndex - 1);
+		}
+		else
+		{
+			mCommands.append(command);
+			mCommandSizes.append(0);
+			mIndex++;
+			updateCommandSize(mIndex - 1);
+		}
+
+		trimCommands();
+		emitChanges(wasClean, couldUndo, couldRedo);
+	}
+}
+
+void DrawingUndoStack::clear()
+{
+	bool wasClean = isClean(), couldUndo = canUndo(), couldRedo = canRedo();
+
+	while (!mCommands.isEmpty()) delete mCommands.takeLast();
+	mCommandSizes.clear();
+	mMemoryUsage = 0;
+
+	mIndex = 0;
+	mCleanIndex = 0;
+	mSaveIndex = -1;
+
+	emitChanges(wasClean, couldUndo, couldRedo);
+}
+
+//==================================================================================================
+
+void DrawingUndoStack::setUndoLimit(int limit)
+{
+	bool wasClean = isClean(), couldUndo = canUndo(), couldRedo = canRedo();
+
+	mUndoLimit = qMax(limit, 0);
+	trimCommands();
+
+	emitChanges(wasClean, couldUndo, couldRedo);
+}
+
+int DrawingUndoStack::undoLimit() const
+{
+	return mUndoLimit;
+}
+
+void DrawingUndoStack::setMemoryLimit(qint64 bytes)
+{
+	bool wasClean = isClean(), couldUndo = canUndo(), couldRedo = canRedo();
+
+	mMemoryLimit = qMax(bytes, (qint64)0);
+	trimCommands();
+
+	emitChanges(wasClean, couldUndo, couldRedo);
+}
+
+qint64 DrawingUndoStack::memoryLimit() const
+{
+	return mMemoryLimit;
+}
+
+qint64 DrawingUndoStack::memoryUsage() const
+{
+	return mMemoryUsage;
+}
+
+//==================================================================================================
+
+void DrawingUndoStack::setJournal(DrawingJournal* journal)
+{
+	mJournal = journal;
+}
+
+DrawingJournal* DrawingUndoStack::journal() const
+{
+	return mJournal;
+}
+
+//==================================================================================================
+
+void DrawingUndoStack::setClean()
+{
+	bool wasClean = isClean(), couldUndo = canUndo(), couldRedo = canRedo();
+
+	mCleanIndex = mIndex;
+
+	emitChanges(wasClean, couldUndo, couldRedo);
+}
+
+void DrawingUndoStack::resetClean()
+{
+	bool wasClean = isClean(), couldUndo = canUndo(), couldRedo = canRedo();
+
+	// No state that can be reached by undo or redo is clean any longer
+	mCleanIndex = -1;
+
+	emitChanges(wasClean, couldUndo, couldRedo);
+}
+
+bool DrawingUndoStack::isClean() const
+{
+	return (mCleanIndex == mIndex);
+}
+
+//==================================================================================================
+
+void DrawingUndoStack::setSavePoint()
+{
+	mSaveIndex = mIndex;
+}
+
+void DrawingUndoStack::commitSavePoint()
+{
+	if (mSaveIndex >= 0)
+	{
+		bool wasClean = isClean(), couldUndo = canUndo(), couldRedo = canRedo();
+
+		mCleanIndex = mSaveIndex;
+		mSaveIndex = -1;
+
+		emitChanges(wasClean, couldUndo, couldRedo);
+	}
+}
+
+void DrawingUndoStack::discardSavePoint()
+{
+	mSaveIndex = -1;
+}
+
+bool DrawingUndoStack::canUndo() const
+{
+	return (mIndex > 0);
+}
+
+bool DrawingUndoStack::canRedo() const
+{
+	return (mIndex < mCommands.size());
+}
+
+int DrawingUndoStack::count() const
+{
+	return mCommands.size();
+}
+
+int DrawingUndoStack::index() const
+{
+	return mIndex;
+}
+
+//==================================================================================================
+
+qint64 DrawingUndoStack::commandMemorySize(const QUndoCommand* command)
+{
+	qint64 size = 0;
+
+	if (command)
+	{
+		const DrawingUndoCommand* drawingCommand = dynamic_cast<const DrawingUndoCommand*>(command);
+
+		if (drawingCommand) size = drawingCommand->memorySize();
+		else size = sizeof(QUndoCommand);
+
+		size += command->text().size() * sizeof(QChar);
+
+		for(int i = 0; i < command->childCount(); i++)
+			size += commandMemorySize(command->child(i));
+	}
+
+	return size;
+}
+
+//==================================================================================================
+
+void DrawingUndoStack::undo()
+{
+	if (canUndo())
+	{
+		bool wasClean = isClean(), couldUndo = canUndo(), couldRedo = canRedo();
+
+		mIndex--;
+		mCommands[mIndex]->undo();
+		updateCommandSize(mIndex);
+		if (mJournal) mJournal->writeCommand(mCommands[mIndex], true);
+
+		trimCommands();
+		emitChanges(wasClean, couldUndo, couldRedo);
+	}
+}
+
+void DrawingUndoStack::redo()
+{
+	if (canRedo())
+	{
+		bool wasClean = isClean(), couldUndo = canUndo(), couldRedo = canRedo();
+
+		mCommands[mIndex]->redo();
+		updateCommandSize(mIndex);
+		if (mJournal) mJournal->writeCommand(mCommands[mIndex], false);
+		mIndex++;
+
+		trimCommands();
+		emitChanges(wasClean, couldUndo, couldRedo);
+	}
+}
+
+//==================================================================================================
+
+void DrawingUndoStack::updateCommandSize(int index)
+{
+	// A command's footprint changes when it is undone or redone, since that decides whether it
+	// or the scene owns the items it refers to
+	qint64 size = commandMemorySize(mCommands[index]);
+
+	mMemoryUsage += size - mCommandSizes[index];
+	mCommandSizes[index] = size;
+}
+
+void DrawingUndoStack::trimCommands()
+{
+	// Discard the oldest commands that can still be undone, but never the most recent one
+	int discardCount = 0;
+
+	while (discardCount < mIndex && mCommands.size() - discardCount > 1 &&
+		((mUndoLimit > 0 && mCommands.size() - discardCount > mUndoLimit) ||
+		(mMemoryLimit > 0 && mMemoryUsage > mMemoryLimit)))
+	{
+		delete mCommands[discardCount];
+		mMemoryUsage -= mCommandSizes[discardCount];
+		discardCount++;
+	}
+
+	if (discardCount > 0)
+	{
+		mCommands.erase(mCommands.begin(), mCommands.begin() + discardCount);
+		mCommandSizes.erase(mCommandSizes.begin(), mCommandSizes.begin() + discardCount);
+
+		mIndex -= discardCount;
+		if (mCleanIndex >= 0)
+		{
+			if (mCleanIndex < discardCount) mCleanIndex = -1;
+			else mCleanIndex -= discardCount;
+		}
+		if (mSaveIndex >= 0)
+		{
+			if (mSaveIndex < discardCount) mSaveIndex = -1;
+			else mSaveIndex -= discardCount;
+		}
+	}
+}
+
+void DrawingUndoStack::emitChanges(bool wasClean, bool couldUndo, bool couldRedo)
+{
+	if (wasClean != isClean()) emit cleanChanged(isClean());
+	if (couldUndo != canUndo()) emit canUndoChanged(canUndo());
+	if (couldRedo != canRedo()) emit canRedoChanged(canRedo());
+}
@@ -0,0 +1,105 @@
+/* DrawingUndoStack.h
+ *
+ * Copyright (C) 2013-2014 Jason Allen
+ *
+ * This file is part of the Jade Diagram Editor.
+ *
+ * Jade is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Jade is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Jade.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef DRAWINGUNDOSTACK_H
+#define DRAWINGUNDOSTACK_H
+
+#include <DrawingGlobals.h>
+
+/* The DrawingUndoStack class is a stack of QUndoCommands with the same push, merge, and clean
+ * state behavior as QUndoStack.
+ *
+ * In addition to a limit on the number of commands, the stack can be given a memory limit.  Each
+ * command's footprint is estimated when it is pushed, undone, or redone (see
+ * DrawingUndoCommand::memorySize), and the oldest commands are discarded whenever the total
+ * exceeds the limit.  The most recent command is always kept, even if it alone exceeds the limit.
+ *
+ * A save that runs in the background should only mark the stack clean once it has finished, and
+ * then at the state that was saved rather than the current one.  setSavePoint() remembers the
+ * current state when the save starts; commitSavePoint() later makes that state the clean state, as
+ * long as it can still be reached by undo or redo.
+ *
+ * If a journal is set (see DrawingJournal), each command is also written to it as it is pushed,
+ * undone, or redone.
+ */
+class DrawingUndoStack : public QObject
+{
+	Q_OBJECT
+
+private:
+	QList<QUndoCommand*> mCommands;
+	QList<qint64> mCommandSizes;
+	int mIndex;
+	int mCleanIndex;
+	int mSaveIndex;
+
+	DrawingJournal* mJournal;
+
+	int mUndoLimit;
+	qint64 mMemoryLimit;
+	qint64 mMemoryUsage;
+
+public:
+	DrawingUndoStack(QObject* parent = nullptr);
+	~DrawingUndoStack();
+
+	void push(QUndoCommand* command);
+	void clear();
+
+	void setUndoLimit(int limit);
+	int undoLimit() const;
+
+	void setMemoryLimit(qint64 bytes);
+	qint64 memoryLimit() const;
+	qint64 memoryUsage() const;
+
+	void setJournal(DrawingJournal* journal);
+	DrawingJournal* journal() const;
+
+	void setClean();
+	void resetClean();
+	bool isClean() const;
+	bool canUndo() const;
+	bool canRedo() const;
+	int count() const;
+	int index() const;
+
+	void setSavePoint();
+	void commitSavePoint();
+	void discardSavePoint();
+
+	static qint64 commandMemorySize(const QUndoCommand* command);
+
+public slots:
+	void undo();
+	void redo();
+
+signals:
+	void cleanChanged(bool clean);
+	void canUndoChanged(bool canUndo);
+	void canRedoChanged(bool canRedo);
+
+private:
+	void updateCommandSize(int index);
+	void trimCommands();
+	void emitChanges(bool wasClean, bool couldUndo, bool couldRedo);
+};
+
+#endif
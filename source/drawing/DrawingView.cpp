@@ -39,6 +39,9 @@ DrawingView::DrawingView() : QAbstractScrollArea()
 
 	mZoomLevel = 1.0;
 	mMode = DefaultMode;
+
+	mTileSize = 256;
+	mTileScale = 0;
 }
 
 DrawingView::~DrawingView()
@@ -58,6 +61,8 @@ void DrawingView::setScene(DrawingScene* scene)
 	}
 
 	mScene = scene;
+	mTiles.clear();
+
 	if (mScene)
 	{
 		mScene->mView = this;
@@ -77,6 +82,7 @@ DrawingScene* DrawingView::scene() const
 void DrawingView::setStyleOptions(const DrawingStyleOptions& styleOptions)
 {
 	mStyleOptions = styleOptions;
+	mTiles.clear();
 }
 
 void DrawingView::setAlignment(Qt::Alignment alignment)
@@ -509,7 +515,21 @@ void DrawingView::setNewMode(const QString& key)
 
 void DrawingView::update()
 {
-	if (viewport()) viewport()->update();
+	if (viewport())
+	{
+		if (mScene && !mTiles.isEmpty() && scale() == mTileScale &&
+			mScene->sceneRect() == mTileSceneRect && viewOrigin() == mPaintOrigin)
+		{
+			// Only repaint the areas that changed since the last paint: the overlay as it was
+			// painted, the overlay as it is now, and the scene rects reported as changed
+			QRegion dirtyRegion = mOverlayRegion;
+			dirtyRegion += overlayRegion();
+			dirtyRegion += viewportRegion(mScene->changedRects(), 2);
+
+			if (!dirtyRegion.isEmpty()) viewport()->update(dirtyRegion);
+		}
+		else viewport()->update();
+	}
 }
 
 void DrawingView::updateScrollBars()
@@ -648,9 +668,15 @@ void DrawingView::mouseMoveEvent(QMouseEvent* event)
 		}
 
 		updateMousePosition(true);
-	}
 
-	update();
+		// Only repaint if something visible changed; hovering over the scene should not cost anything
+		if (mScene && (mScene->hasChangedRects() || mScene->newItem() ||
+			mScene->mMouseState != DrawingScene::MouseReady))
+		{
+			update();
+		}
+		else if (mMode == ZoomMode && mMouseEvent.isDragged()) update();
+	}
 }
 
 void DrawingView::mouseReleaseEvent(QMouseEvent* event)
@@ -722,35 +748,48 @@ void DrawingView::paintEvent(QPaintEvent* event)
 {
 	if (mScene)
 	{
-		QImage image(viewport()->width(), viewport()->height(), QImage::Format_RGB32);
-		image.fill(palette().brush(QPalette::Window).color());
-
-		QPainter painter(&image);
+		QPainter painter(viewport());
 		qreal scale = DrawingView::scale();
 		QRectF sceneRect = mScene->sceneRect();
+		QPoint origin = viewOrigin();
+		QRect exposedRect = event->rect().translated(origin);
+		QRect viewportRect = viewport()->rect().translated(origin);
+		QHash<quint64, QImage>::iterator tileIter;
+		quint64 key;
 
-		painter.translate(-horizontalScrollBar()->value(), -verticalScrollBar()->value());
-		painter.scale(scale, scale);
-		painter.translate(-sceneRect.topLeft());
+		updateTiles();
 
-		// Adjust for alignment
-		if (horizontalScrollBar()->maximum() == 0)
+		// Compose the exposed area from cached tiles, rendering only the tiles that are missing
+		for(qint32 row = tileCoordinate(exposedRect.top()); row <= tileCoordinate(exposedRect.bottom()); row++)
 		{
-			if (mAlignment & Qt::AlignHCenter)
-				painter.translate(-(sceneRect.width() - maximumViewportSize().width() / scale) / 2, 0);
-			else if (mAlignment & Qt::AlignRight)
-				painter.translate(-(sceneRect.width() - maximumViewportSize().width() / scale), 0);
+			for(qint32 column = tileCoordinate(exposedRect.left()); column <= tileCoordinate(exposedRect.right()); column++)
+			{
+				key = tileKey(column, row);
+				tileIter = mTiles.find(key);
+				if (tileIter == mTiles.end()) tileIter = mTiles.insert(key, renderTile(column, row));
+
+				painter.drawImage(column * mTileSize - origin.x(), row * mTileSize - origin.y(), tileIter.value());
+			}
 		}
-		if (verticalScrollBar()->maximum() == 0)
+
+		pruneTiles(QRect(QPoint(tileCoordinate(viewportRect.left()), tileCoordinate(viewportRect.top())),
+			QPoint(tileCoordinate(viewportRect.right()), tileCoordinate(viewportRect.bottom()))));
+
+		// Draw the interactive overlay on top of the cached tiles: selected items, item points,
+		// hotpoints, rubber bands and the new item preview
+		painter.translate(-origin);
+		painter.scale(scale, scale);
+		painter.translate(-sceneRect.topLeft());
+
+		mScene->drawSelectedItems(&painter, mStyleOptions, visibleRect());
+		mScene->drawForeground(&painter, mStyleOptions, visibleRect());
+
+		if (mMode == ZoomMode && mMouseEvent.isDragged())
 		{
-			if (mAlignment & Qt::AlignVCenter)
-				painter.translate(0, -(sceneRect.height() - maximumViewportSize().height() / scale) / 2);
-			else if (mAlignment & Qt::AlignBottom)
-				painter.translate(0, -(sceneRect.height() - maximumViewportSize().height() / scale));
+			mScene->drawRubberBand(&painter, mStyleOptions,
+				Drawing::rectFromPoints(mMouseEvent.scenePos(), mMouseEvent.buttonDownScenePos()));
 		}
 
-		render(&painter, mStyleOptions, visibleRect());
-
 		// Draw page outline
 		QPen scenePen(Qt::black, 1);
 		scenePen.setCosmetic(true);
@@ -758,13 +797,13 @@ void DrawingView::paintEvent(QPaintEvent* event)
 		painter.setPen(scenePen);
 		painter.drawRect(mScene->sceneRect());
 
-		painter.end();
+		mPaintOrigin = origin;
+		mOverlayRegion = overlayRegion();
 
-		QPainter widgetPainter(viewport());
-		widgetPainter.drawImage(0, 0, image);
+		// Items such as text only know their size once they have been rendered, so any tiles that
+		// were just drawn may need to be drawn again
+		if (mScene->hasChangedRects()) update();
 	}
-
-	Q_UNUSED(event);
 }
 
 void DrawingView::resizeEvent(QResizeEvent* event)
@@ -779,22 +818,7 @@ void DrawingView::writeXmlAttributes(QXmlStreamWriter& xmlWriter)
 {
 	if (mScene) mScene->writeXmlAttributes(xmlWriter);
 
-	xmlWriter.writeAttribute("alignment", QString::number((quint32)alignment()));
-	xmlWriter.writeAttribute("viewportAnchor", QString::number((quint32)viewportAnchor()));
-
-	xmlWriter.writeAttribute("gridStyle", QString::number((quint16)mStyleOptions.gridStyle()));
-	xmlWriter.writeAttribute("majorGridSpacing", QString::number(mStyleOptions.majorGridSpacing()));
-	xmlWriter.writeAttribute("minorGridSpacing", QString::number(mStyleOptions.minorGridSpacing()));
-
-	xmlWriter.writeAttribute("backgroundColor", Drawing::brushToString(mStyleOptions.brush(DrawingStyleOptions::Background)));
-	xmlWriter.writeAttribute("borderColor", Drawing::brushToString(mStyleOptions.brush(DrawingStyleOptions::Border)));
-	xmlWriter.writeAttribute("gridColor", Drawing::brushToString(mStyleOptions.brush(DrawingStyleOptions::Grid)));
-	xmlWriter.writeAttribute("rubberBandColor", Drawing::brushToString(mStyleOptions.brush(DrawingStyleOptions::RubberBand)));
-	xmlWriter.writeAttribute("resizePointColor", Drawing::brushToString(mStyleOptions.brush(DrawingStyleOptions::ResizePoint)));
-	xmlWriter.writeAttribute("hotpointColor", Drawing::brushToString(mStyleOptions.brush(DrawingStyleOptions::Hotpoint)));
-	xmlWriter.writeAttribute("itemColor", Drawing::brushToString(mStyleOptions.brush(DrawingStyleOptions::Item)));
-	xmlWriter.writeAttribute("alternateItemColor", Drawing::brushToString(mStyleOptions.brush(DrawingStyleOptions::AlternateItem)));
-	xmlWriter.writeAttribute("userColor", Drawing::brushToString(mStyleOptions.brush(DrawingStyleOptions::UserDefined)));
+	writeViewXmlAttributes(xmlWriter, alignment(), viewportAnchor(), mStyleOptions);
 }
 
 void DrawingView::writeXmlChildElements(QXmlStreamWriter& xmlWriter)
@@ -838,6 +862,8 @@ void DrawingView::readXmlAttributes(QXmlStreamReader& xmlReader)
 		mStyleOptions.setBrush(DrawingStyleOptions::AlternateItem, Drawing::brushFromString(attributes.value("alternateItemColor").toString()));
 	if (attributes.hasAttribute("userColor"))
 		mStyleOptions.setBrush(DrawingStyleOptions::UserDefined, Drawing::brushFromString(attributes.value("userColor").toString()));
+
+	mTiles.clear();
 }
 
 void DrawingView::readXmlChildElement(QXmlStreamReader& xmlReader)
@@ -847,6 +873,97 @@ void DrawingView::readXmlChildElement(QXmlStreamReader& xmlReader)
 
 //==================================================================================================
 
+void DrawingView::writeBinary(QDataStream& stream)
+{
+	writeViewBinary(stream, alignment(), viewportAnchor(), mStyleOptions);
+
+	// The scene follows the view settings so that a file without a scene can still be read
+	stream << (bool)(mScene != nullptr);
+	if (mScene) mScene->writeBinary(stream);
+}
+
+void DrawingView::readBinary(QDataStream& stream)
+{
+	quint32 alignment = 0, viewportAnchor = 0;
+	quint16 gridStyle = 0;
+	qint32 majorGridSpacing = 0, minorGridSpacing = 0;
+	QBrush backgroundBrush, borderBrush, gridBrush, rubberBandBrush, resizePointBrush;
+	QBrush hotpointBrush, itemBrush, alternateItemBrush, userDefinedBrush;
+	bool hasScene = false;
+
+	stream >> alignment >> viewportAnchor;
+	stream >> gridStyle >> majorGridSpacing >> minorGridSpacing;
+	stream >> backgroundBrush >> borderBrush >> gridBrush >> rubberBandBrush >> resizePointBrush;
+	stream >> hotpointBrush >> itemBrush >> alternateItemBrush >> userDefinedBrush;
+	stream >> hasScene;
+
+	if (stream.status() == QDataStream::Ok)
+	{
+		setAlignment((Qt::Alignment)alignment);
+		setViewportAnchor((ViewportAnchor)viewportAnchor);
+
+		mStyleOptions.setGridStyle((DrawingStyleOptions::GridStyle)gridStyle);
+		mStyleOptions.setMajorGridSpacing(majorGridSpacing);
+		mStyleOptions.setMinorGridSpacing(minorGridSpacing);
+
+		mStyleOptions.setBrush(DrawingStyleOptions::Background, backgroundBrush);
+		mStyleOptions.setBrush(DrawingStyleOptions::Border, borderBrush);
+		mStyleOptions.setBrush(DrawingStyleOptions::Grid, gridBrush);
+		mStyleOptions.setBrush(DrawingStyleOptions::RubberBand, rubberBandBrush);
+		mStyleOptions.setBrush(DrawingStyleOptions::ResizePoint, resizePointBrush);
+		mStyleOptions.setBrush(DrawingStyleOptions::Hotpoint, hotpointBrush);
+		mStyleOptions.setBrush(DrawingStyleOptions::Item, itemBrush);
+		mStyleOptions.setBrush(DrawingStyleOptions::AlternateItem, alternateItemBrush);
+		mStyleOptions.setBrush(DrawingStyleOptions::UserDefined, userDefinedBrush);
+
+		if (hasScene && mScene) mScene->readBinary(stream);
+	}
+
+	mTiles.clear();
+}
+
+void DrawingView::writeViewXmlAttributes(QXmlStreamWriter& xmlWriter, Qt::Alignment alignment,
+	ViewportAnchor viewportAnchor, const DrawingStyleOptions& styleOptions)
+{
+	xmlWriter.writeAttribute("alignment", QString::number((quint32)alignment));
+	xmlWriter.writeAttribute("viewportAnchor", QString::number((quint32)viewportAnchor));
+
+	xmlWriter.writeAttribute("gridStyle", QString::number((quint16)styleOptions.gridStyle()));
+	xmlWriter.writeAttribute("majorGridSpacing", QString::number(styleOptions.majorGridSpacing()));
+	xmlWriter.writeAttribute("minorGridSpacing", QString::number(styleOptions.minorGridSpacing()));
+
+	xmlWriter.writeAttribute("backgroundColor", Drawing::brushToString(styleOptions.brush(DrawingStyleOptions::Background)));
+	xmlWriter.writeAttribute("borderColor", Drawing::brushToString(styleOptions.brush(DrawingStyleOptions::Border)));
+	xmlWriter.writeAttribute("gridColor", Drawing::brushToString(styleOptions.brush(DrawingStyleOptions::Grid)));
+	xmlWriter.writeAttribute("rubberBandColor", Drawing::brushToString(styleOptions.brush(DrawingStyleOptions::RubberBand)));
+	xmlWriter.writeAttribute("resizePointColor", Drawing::brushToString(styleOptions.brush(DrawingStyleOptions::ResizePoint)));
+	xmlWriter.writeAttribute("hotpointColor", Drawing::brushToString(styleOptions.brush(DrawingStyleOptions::Hotpoint)));
+	xmlWriter.writeAttribute("itemColor", Drawing::brushToString(styleOptions.brush(DrawingStyleOptions::Item)));
+	xmlWriter.writeAttribute("alternateItemColor", Drawing::brushToString(styleOptions.brush(DrawingStyleOptions::AlternateItem)));
+	xmlWriter.writeAttribute("userColor", Drawing::brushToString(styleOptions.brush(DrawingStyleOptions::UserDefined)));
+}
+
+void DrawingView::writeViewBinary(QDataStream& stream, Qt::Alignment alignment,
+	ViewportAnchor viewportAnchor, const DrawingStyleOptions& styleOptions)
+{
+	stream << (quint32)alignment << (quint32)viewportAnchor;
+
+	stream << (quint16)styleOptions.gridStyle();
+	stream << (qint32)styleOptions.majorGridSpacing() << (qint32)styleOptions.minorGridSpacing();
+
+	stream << styleOptions.brush(DrawingStyleOptions::Background);
+	stream << styleOptions.brush(DrawingStyleOptions::Border);
+	stream << styleOptions.brush(DrawingStyleOptions::Grid);
+	stream << styleOptions.brush(DrawingStyleOptions::RubberBand);
+	stream << styleOptions.brush(DrawingStyleOptions::ResizePoint);
+	stream << styleOptions.brush(DrawingStyleOptions::Hotpoint);
+	stream << styleOptions.brush(DrawingStyleOptions::Item);
+	stream << styleOptions.brush(DrawingStyleOptions::AlternateItem);
+	stream << styleOptions.brush(DrawingStyleOptions::UserDefined);
+}
+
+//==================================================================================================
+
 void DrawingView::setScale(qreal scl)
 {
 	if (mScene)
@@ -991,3 +1108,188 @@ void DrawingView::updateMousePosition(bool showScroll)
 	}
 	else emit mousePositionChanged(Drawing::pointToString(scenePos, units));
 }
+
+//==================================================================================================
+
+QPoint DrawingView::viewOrigin() const
+{
+	// Returns the offset of the viewport's top-left corner from the top-left corner of the scene
+	// rect, in pixels at the current zoom level
+	QPointF origin(horizontalScrollBar()->value(), verticalScrollBar()->value());
+
+	if (mScene)
+	{
+		qreal lScale = scale();
+		QRectF lSceneRect = mScene->sceneRect();
+
+		if (horizontalScrollBar()->maximum() == 0)
+		{
+			if (mAlignment & Qt::AlignHCenter)
+				origin.rx() += (lSceneRect.width() * lScale - maximumViewportSize().width()) / 2;
+			else if (mAlignment & Qt::AlignRight)
+				origin.rx() += (lSceneRect.width() * lScale - maximumViewportSize().width());
+		}
+		if (verticalScrollBar()->maximum() == 0)
+		{
+			if (mAlignment & Qt::AlignVCenter)
+				origin.ry() += (lSceneRect.height() * lScale - maximumViewportSize().height()) / 2;
+			else if (mAlignment & Qt::AlignBottom)
+				origin.ry() += (lSceneRect.height() * lScale - maximumViewportSize().height());
+		}
+	}
+
+	return QPoint(qFloor(origin.x()), qFloor(origin.y()));
+}
+
+void DrawingView::updateTiles()
+{
+	qreal lScale = scale();
+	QRectF lSceneRect = mScene->sceneRect();
+	QList<QRectF> changedRects = mScene->takeChangedRects();
+
+	if (lScale != mTileScale || lSceneRect != mTileSceneRect)
+	{
+		// Tiles are only valid for the zoom level and scene rect they were rendered with
+		mTiles.clear();
+		mTileScale = lScale;
+		mTileSceneRect = lSceneRect;
+	}
+	else
+	{
+		for(auto rectIter = changedRects.begin(); !mTiles.isEmpty() && rectIter != changedRects.end(); rectIter++)
+			invalidateTiles(*rectIter);
+	}
+}
+
+void DrawingView::invalidateTiles(const QRectF& sceneRect)
+{
+	// Pad the rect by a couple of pixels to cover antialiasing and cosmetic pens
+	QRectF pixelRect = QRectF((sceneRect.topLeft() - mTileSceneRect.topLeft()) * mTileScale,
+		sceneRect.size() * mTileScale).adjusted(-2, -2, 2, 2);
+
+	qint32 left = tileCoordinate(pixelRect.left());
+	qint32 top = tileCoordinate(pixelRect.top());
+	qint32 right = tileCoordinate(pixelRect.right());
+	qint32 bottom = tileCoordinate(pixelRect.bottom());
+
+	if ((qint64)(right - left + 1) * (bottom - top + 1) > mTiles.size())
+	{
+		// The rect covers more tiles than are cached, so check each cached tile instead
+		qint32 column, row;
+
+		for(auto tileIter = mTiles.begin(); tileIter != mTiles.end(); )
+		{
+			column = (qint32)(tileIter.key() >> 32);
+			row = (qint32)(tileIter.key() & 0xFFFFFFFF);
+
+			if (left <= column && column <= right && top <= row && row <= bottom)
+				tileIter = mTiles.erase(tileIter);
+			else
+				tileIter++;
+		}
+	}
+	else
+	{
+		for(qint32 row = top; row <= bottom; row++)
+		{
+			for(qint32 column = left; column <= right; column++)
+				mTiles.remove(tileKey(column, row));
+		}
+	}
+}
+
+void DrawingView::pruneTiles(const QRect& tileRange)
+{
+	// Keep the tiles around the visible area so that scrolling back is cheap, but discard tiles
+	// far away from it once the cache holds several screens' worth
+	QRect keepRange = tileRange.adjusted(-2, -2, 2, 2);
+	qint32 column, row;
+
+	if (mTiles.size() > 4 * keepRange.width() * keepRange.height())
+	{
+		for(auto tileIter = mTiles.begin(); tileIter != mTiles.end(); )
+		{
+			column = (qint32)(tileIter.key() >> 32);
+			row = (qint32)(tileIter.key() & 0xFFFFFFFF);
+
+			if (!keepRange.contains(column, row))
+				tileIter = mTiles.erase(tileIter);
+			else
+				tileIter++;
+		}
+	}
+}
+
+QImage DrawingView::renderTile(qint32 column, qint32 row)
+{
+	QImage tile(mTileSize, mTileSize, QImage::Format_RGB32);
+	tile.fill(palette().brush(QPalette::Window).color());
+
+	QPainter painter(&tile);
+	QRectF tileRect(mTileSceneRect.left() + column * mTileSize / mTileScale,
+		mTileSceneRect.top() + row * mTileSize / mTileScale, mTileSize / mTileScale, mTileSize / mTileScale);
+
+	painter.translate(-column * mTileSize, -row * mTileSize);
+	painter.scale(mTileScale, mTileScale);
+	painter.translate(-mTileSceneRect.topLeft());
+
+	mScene->drawBackground(&painter, mStyleOptions, tileRect);
+	mScene->drawStaticItems(&painter, mStyleOptions, tileRect);
+
+	painter.end();
+
+	return tile;
+}
+
+QRegion DrawingView::overlayRegion() const
+{
+	QRegion region;
+
+	if (mScene)
+	{
+		// Item points and hotpoints are drawn at a fixed size in pixels around the item's points
+		region = viewportRegion(mScene->foregroundRects(), 16);
+
+		if (mMode == ZoomMode && mMouseEvent.isDragged())
+		{
+			region += viewportRegion(QList<QRectF>() <<
+				Drawing::rectFromPoints(mMouseEvent.scenePos(), mMouseEvent.buttonDownScenePos()), 2);
+		}
+	}
+
+	return region;
+}
+
+QRegion DrawingView::viewportRegion(const QList<QRectF>& sceneRects, int padding) const
+{
+	QRegion region;
+	QRect viewportRect = viewport()->rect();
+	QRect rect, boundingRect;
+
+	for(auto rectIter = sceneRects.begin(); rectIter != sceneRects.end(); rectIter++)
+	{
+		rect = mapFromScene(*rectIter).normalized().adjusted(-padding, -padding, padding, padding);
+		rect = rect.intersected(viewportRect);
+
+		if (!rect.isEmpty())
+		{
+			// Building a region from many small rects costs more than repainting a bit extra
+			if (sceneRects.size() <= 64) region += rect;
+			else boundingRect = boundingRect.united(rect);
+		}
+	}
+
+	if (!boundingRect.isEmpty()) region = boundingRect;
+
+	return region;
+}
+
+qint32 DrawingView::tileCoordinate(qreal value) const
+{
+	return (qint32)qFloor(value / mTileSize);
+}
+
+quint64 DrawingView::tileKey(qint32 column, qint32 row)
+{
+	return ((quint64)(quint32)column << 32) | (quint64)(quint32)row;
+}
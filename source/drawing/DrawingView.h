@@ -27,6 +27,8 @@ class DrawingView : public QAbstractScrollArea
 {
 	Q_OBJECT
 
+	friend class DrawingSnapshot;
+
 public:
 	enum Mode { DefaultMode, ScrollMode, ZoomMode, NewMode };
 	enum ViewportAnchor { NoAnchor, AnchorViewCenter, AnchorUnderMouse };
@@ -49,6 +51,13 @@ private:
 	QPointF mMouseScenePos;
 	DrawingMouseEvent mMouseEvent;
 
+	int mTileSize;
+	qreal mTileScale;
+	QRectF mTileSceneRect;
+	QHash<quint64, QImage> mTiles;
+	QPoint mPaintOrigin;
+	QRegion mOverlayRegion;
+
 public:
 	DrawingView();
 	virtual ~DrawingView();
@@ -149,6 +158,14 @@ protected:
 	virtual void readXmlAttributes(QXmlStreamReader& xmlReader);
 	virtual void readXmlChildElement(QXmlStreamReader& xmlReader);
 
+	virtual void writeBinary(QDataStream& stream);
+	virtual void readBinary(QDataStream& stream);
+
+	static void writeViewXmlAttributes(QXmlStreamWriter& xmlWriter, Qt::Alignment alignment,
+		ViewportAnchor viewportAnchor, const DrawingStyleOptions& styleOptions);
+	static void writeViewBinary(QDataStream& stream, Qt::Alignment alignment,
+		ViewportAnchor viewportAnchor, const DrawingStyleOptions& styleOptions);
+
 private:
 	void setScale(qreal scale);
 	qreal scale() const;
@@ -156,6 +173,16 @@ private:
 	void beginScrollUpdate();
 	void endScrollUpdate(bool adjustAnchor);
 	void updateMousePosition(bool showScroll);
+
+	QPoint viewOrigin() const;
+	void updateTiles();
+	void invalidateTiles(const QRectF& sceneRect);
+	void pruneTiles(const QRect& tileRange);
+	QImage renderTile(qint32 column, qint32 row);
+	QRegion overlayRegion() const;
+	QRegion viewportRegion(const QList<QRectF>& sceneRects, int padding) const;
+	qint32 tileCoordinate(qreal value) const;
+	static quint64 tileKey(qint32 column, qint32 row);
 };
 
 #endif